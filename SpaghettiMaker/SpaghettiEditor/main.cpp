@@ -10,6 +10,15 @@
 #include "SpaghettiEngine/Transform.h"
 #include "SpaghettiEngine/Camera.h"
 #include "SpaghettiEngine/TextureManager.h"
+#include "SpaghettiEngine/MeshManager.h"
+#include "SpaghettiEngine/MaterialManager.h"
+#include "SpaghettiEngine/AssetDatabase.h"
+#include "SpaghettiEngine/JobSystem.h"
+#include "SpaghettiEngine/UploadQueue.h"
+#include "SpaghettiEngine/WorldStreamer.h"
+#include "SpaghettiEngine/Log.h"
+#include "SpaghettiEngine/Profiler.h"
+#include "SpaghettiEngine/Renderer.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -144,6 +153,7 @@ void init_devil() {
 }
 
 static void drawFloorGrid(int size, double step) {
+    uint64_t vertices = 0;
     glColor3ub(0, 0, 0);
     glBegin(GL_LINES);
     for (double i = -size; i <= size; i += step) {
@@ -151,8 +161,10 @@ static void drawFloorGrid(int size, double step) {
         glVertex3d(i, 0, size);
         glVertex3d(-size, 0, i);
         glVertex3d(size, 0, i);
+        vertices += 4;
     }
     glEnd();
+    RENDERER->CountDraw(vertices, 0);
 }
 
 
@@ -334,6 +346,18 @@ void cameramovement(const SDL_Event& event, Scene* scene) {
 }
 
 int main(int argc, char** argv) {
+    // Everything logged from here on also goes to the file, written by the logger's own thread
+    LOGGER->OpenFile("Logs/engine.log");
+    PROFILER->SetThreadName("Main");
+
+    // Headless import benchmark: SpaghettiEditor --bench-import <model>
+    if (argc > 2 && std::string(argv[1]) == "--bench-import") {
+        ModelLoader::BenchmarkImport(argv[2]);
+        JOB_SYSTEM->Shutdown();
+        JOB_SYSTEM->Destroy();
+        Logger::Destroy();
+        return 0;
+    }
 
     MyWindow window("NYUNITY", WINDOW_SIZE.x, WINDOW_SIZE.y);
     //MyGUI gui(window.windowPtr(), window.contextPtr());
@@ -359,6 +383,13 @@ int main(int argc, char** argv) {
     // Initialize the texture manager
     TEXTURE_MANAGER->Initialize();
 
+    // Start the workers used by background loads
+    JOB_SYSTEM->Initialize();
+
+    // Load the asset library and reimport anything that changed since the last run
+    ASSET_DATABASE->Initialize("Library");
+    ASSET_DATABASE->Refresh("Assets");
+
     // Set up assimp logging
     Assimp::Importer importer;
     // Stream log messages to Debug window
@@ -440,10 +471,13 @@ int main(int argc, char** argv) {
     while (window.isOpen()) {
         if (console._shouldQuit) break;
 
+        // Every scope of the previous iteration has closed by now
+        PROFILER->EndFrame();
+
         const auto t0 = hrclock::now();
 
         // Clear buffers
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        RENDERER->BeginFrame();
 
         // Set up camera matrices
         glMatrixMode(GL_PROJECTION);
@@ -452,25 +486,53 @@ int main(int argc, char** argv) {
         glMatrixMode(GL_MODELVIEW);
         glLoadMatrixd(glm::value_ptr(camera.view()));
 
+        // Stream texture mips for what the last frame drew, then run a bounded slice
+        // of the GPU uploads produced by background loads
+        TEXTURE_MANAGER->UpdateStreaming();
+        UPLOAD_QUEUE->Drain();
+
+        // Bring world cells near the camera in and drop far ones, a time slice per frame
+        WORLD_STREAMER->Update(camera.transform().pos());
+
         // Update and render scene
         if (scene) {
             scene->Update();
             // Draw floor grid
-            drawFloorGrid(26, 1.0);
-            scene->Render();
+            {
+                PROFILE_SCOPE("Main::FloorGrid");
+                RenderPassScope pass(RenderPass::Grid);
+                drawFloorGrid(26, 1.0);
+            }
+            {
+                RenderPassScope pass(RenderPass::Scene);
+                scene->Render();
+            }
         }
 
 
 
         // Render UI
-        console.render();
-        window.swapBuffers();
+        {
+            PROFILE_SCOPE("Main::UI");
+            console.render();
+        }
+
+        // Publishes this frame's render statistics and reads back finished GPU timers
+        RENDERER->EndFrame();
+        {
+            PROFILE_SCOPE("Main::SwapBuffers");
+            window.swapBuffers();
+        }
 
         const auto t1 = hrclock::now();
         const auto dt = t1 - t0;
-        if (dt < FRAME_DT) this_thread::sleep_for(FRAME_DT - dt);
+        if (dt < FRAME_DT) {
+            PROFILE_SCOPE("Main::Sleep");
+            this_thread::sleep_for(FRAME_DT - dt);
+        }
 
         //Camera Zoom
+        PROFILE_SCOPE("Main::Events");
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
             event_processor->processEvent(event);
@@ -504,10 +566,30 @@ int main(int argc, char** argv) {
     }
 
     // At the end of main(), before return
-    // Cleanup
+    // Stop background loads before anything they reference goes away
+    ModelLoader::CancelAllLoads();
+    UPLOAD_QUEUE->Shutdown();
+    JOB_SYSTEM->Shutdown();
+    JOB_SYSTEM->Destroy();
+    UPLOAD_QUEUE->Destroy();
+    WORLD_STREAMER->Destroy();
+
+    // Cleanup, while the GL context still exists
+    RENDERER->Cleanup();
     TEXTURE_MANAGER->Cleanup();
     TEXTURE_MANAGER->Destroy();
+    TEXTURE_UPLOAD_RING->Destroy();
+    MESH_MANAGER->Cleanup();
+    MESH_MANAGER->Destroy();
+    MATERIAL_MANAGER->Cleanup();
+    MATERIAL_MANAGER->Destroy();
+    ASSET_DATABASE->Cleanup();
+    ASSET_DATABASE->Destroy();
     aiDetachAllLogStreams();
     delete scene;
+
+    // Last, so everything above can still log; drains what is left
+    Profiler::Destroy();
+    Logger::Destroy();
     return 0;
 }
\ No newline at end of file
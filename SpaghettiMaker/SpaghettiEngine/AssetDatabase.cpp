@@ -0,0 +1,306 @@
+#include "AssetDatabase.h"
+#include "Log.h"
+#include "ModelLoader.h"
+#include "TextureImporter.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+AssetDatabase* AssetDatabase::s_instance = nullptr;
+
+namespace {
+    const char* ManifestFileName = "AssetManifest.txt";
+    const int ManifestVersion = 1;
+
+    const uint64_t FnvPrime = 1099511628211ull;
+
+    bool GetFileStamp(const std::string& path, uint64_t& size, int64_t& time) {
+        std::error_code error;
+        size = std::filesystem::file_size(path, error);
+        if (error) return false;
+        time = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+        return !error;
+    }
+}
+
+void AssetDatabase::Initialize(const std::string& libraryPath) {
+    _libraryPath = libraryPath;
+
+    std::error_code error;
+    std::filesystem::create_directories(_libraryPath, error);
+    if (error) {
+        LOG_ERROR(Assets, "Failed to create asset library {}: {}", _libraryPath, error.message());
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (LoadManifest()) {
+        LOG_INFO(Assets, "Asset database loaded: {} assets", _records.size());
+    }
+}
+
+void AssetDatabase::Cleanup() {
+    SaveManifest();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _records.clear();
+    _pendingHashes.clear();
+}
+
+std::string AssetDatabase::GetManifestPath() const {
+    return (std::filesystem::path(_libraryPath) / ManifestFileName).string();
+}
+
+bool AssetDatabase::LoadManifest() {
+    std::ifstream file(GetManifestPath());
+    if (!file) return false;
+
+    std::string line;
+    int version = 0;
+    if (!std::getline(file, line) || !(std::istringstream(line) >> version) || version != ManifestVersion) {
+        LOG_INFO(Assets, "Asset manifest is out of date, every asset will be reimported");
+        return false;
+    }
+
+    // One asset per line: type, content hash, settings hash, size, time, cooked path, source path (tab separated)
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        AssetRecord record;
+        int type = 0;
+        std::string cookedPath;
+        stream >> type >> std::hex >> record.contentHash >> record.settingsHash >> std::dec >> record.sourceSize >> record.sourceTime;
+        stream.ignore(1);
+        if (!stream || !std::getline(stream, cookedPath, '\t') || !std::getline(stream, record.sourcePath)) continue;
+
+        record.type = static_cast<AssetType>(type);
+        record.cookedPath = cookedPath;
+        _records[ResourceId::FromCanonical(record.sourcePath)] = record;
+    }
+
+    _dirty = false;
+    return true;
+}
+
+bool AssetDatabase::SaveManifest() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_dirty || _libraryPath.empty()) return true;
+
+    std::ofstream file(GetManifestPath(), std::ios::trunc);
+    if (!file) {
+        LOG_ERROR(Assets, "Failed to write asset manifest: {}", GetManifestPath());
+        return false;
+    }
+
+    file << ManifestVersion << "\n";
+    for (const auto& [path, record] : _records) {
+        file << static_cast<int>(record.type) << "\t"
+            << std::hex << record.contentHash << "\t" << record.settingsHash << "\t"
+            << std::dec << record.sourceSize << "\t" << record.sourceTime << "\t"
+            << record.cookedPath << "\t" << record.sourcePath << "\n";
+    }
+
+    _dirty = false;
+    return true;
+}
+
+void AssetDatabase::Refresh(const std::string& directory) {
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error)) return;
+
+    size_t checked = 0;
+    size_t failed = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error)) {
+        if (!entry.is_regular_file() || GetAssetType(entry.path().string()) == AssetType::Unknown) continue;
+
+        ++checked;
+        if (!Import(entry.path().string())) {
+            ++failed;
+        }
+    }
+
+    LOG_INFO(Assets, "Asset refresh: {} assets checked, {} failed", checked, failed);
+    SaveManifest();
+}
+
+bool AssetDatabase::Import(const std::string& sourcePath) {
+    switch (GetAssetType(sourcePath)) {
+    case AssetType::Model:
+        return !ModelLoader::ImportModel(sourcePath).empty();
+
+    case AssetType::Texture:
+        return !TextureImporter::ImportTexture(sourcePath).empty();
+
+    case AssetType::Atlas:
+        // Only its members know how to rebuild it; they recook it when next loaded
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+std::string AssetDatabase::ImportOnce(const std::string& sourcePath, uint64_t settingsHash, const std::function<std::string()>& import) {
+    const ResourceId id = ResourceId::FromPath(sourcePath);
+    std::shared_ptr<InFlightImport> entry;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        auto it = _importing.find(id);
+        if (it != _importing.end()) {
+            // Cooking it twice would also race on renaming the output into place
+            std::shared_ptr<InFlightImport> running = it->second;
+            _importFinished.wait(lock, [&running]() { return running->done; });
+            return running->result;
+        }
+        entry = std::make_shared<InFlightImport>();
+        _importing[id] = entry;
+    }
+
+    auto publish = [&](const std::string& result) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            entry->result = result;
+            entry->done = true;
+            _importing.erase(id);
+        }
+        _importFinished.notify_all();
+    };
+
+    std::string result;
+    try {
+        result = NeedsImport(sourcePath, settingsHash) ? import() : Resolve(sourcePath);
+    }
+    catch (...) {
+        // Waiters see a failed import rather than blocking forever
+        publish(std::string());
+        throw;
+    }
+    publish(result);
+    return result;
+}
+
+bool AssetDatabase::NeedsImport(const std::string& sourcePath, uint64_t settingsHash) {
+    const ResourceId id = ResourceId::FromPath(sourcePath);
+    const std::string& key = id.GetPath();
+
+    // Work on a copy so the file system checks and hashing happen outside the lock
+    AssetRecord record;
+    if (!GetRecord(id, record)) return true;
+    if (record.settingsHash != settingsHash) return true;
+
+    std::error_code error;
+    if (!record.cookedPath.empty() && !std::filesystem::exists(record.cookedPath, error)) return true;
+
+    // A cooked output shipped without its source is always usable
+    uint64_t size = 0;
+    int64_t time = 0;
+    if (!GetFileStamp(key, size, time)) return record.cookedPath.empty();
+
+    if (size == record.sourceSize && time == record.sourceTime) return false;
+
+    // The stamp changed, only the contents decide
+    uint64_t hash = 0;
+    if (!HashFile(key, hash)) return true;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (hash != record.contentHash) {
+        _pendingHashes[id] = hash;
+        return true;
+    }
+
+    // Touched but identical: remember the new stamp so it is not hashed again
+    auto it = _records.find(id);
+    if (it != _records.end()) {
+        it->second.sourceSize = size;
+        it->second.sourceTime = time;
+        _dirty = true;
+    }
+    return false;
+}
+
+void AssetDatabase::MarkImported(const std::string& sourcePath, const std::string& cookedPath, uint64_t settingsHash) {
+    const ResourceId id = ResourceId::FromPath(sourcePath);
+    const std::string& key = id.GetPath();
+
+    AssetRecord record;
+    record.type = GetAssetType(key);
+    record.sourcePath = key;
+    record.cookedPath = cookedPath;
+    record.settingsHash = settingsHash;
+    GetFileStamp(key, record.sourceSize, record.sourceTime);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto pending = _pendingHashes.find(id);
+    if (pending != _pendingHashes.end()) {
+        record.contentHash = pending->second;
+        _pendingHashes.erase(pending);
+    }
+    else {
+        lock.unlock();
+        HashFile(key, record.contentHash);
+        lock.lock();
+    }
+
+    _records[id] = record;
+    _dirty = true;
+}
+
+std::string AssetDatabase::GetCookedPath(const std::string& sourcePath, const std::string& extension) const {
+    // Name outputs after the source, with a path hash so equal file names in different folders don't collide
+    const std::string& key = ResourceId::FromPath(sourcePath).GetPath();
+    std::ostringstream name;
+    name << std::filesystem::path(key).stem().string() << "_" << std::hex << HashBytes(key.data(), key.size()) << extension;
+    return (std::filesystem::path(_libraryPath) / name.str()).string();
+}
+
+std::string AssetDatabase::Resolve(const std::string& sourcePath) const {
+    AssetRecord record;
+    return (GetRecord(sourcePath, record) && !record.cookedPath.empty()) ? record.cookedPath : sourcePath;
+}
+
+bool AssetDatabase::GetRecord(const std::string& sourcePath, AssetRecord& record) const {
+    return GetRecord(ResourceId::FromPath(sourcePath), record);
+}
+
+bool AssetDatabase::GetRecord(ResourceId source, AssetRecord& record) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _records.find(source);
+    if (it == _records.end()) return false;
+
+    record = it->second;
+    return true;
+}
+
+AssetType AssetDatabase::GetAssetType(const std::string& path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+    if (extension == ".fbx") return AssetType::Model;
+    if (extension == ".png" || extension == ".tga" || extension == ".dds") return AssetType::Texture;
+    if (extension == ".satlas") return AssetType::Atlas;
+    return AssetType::Unknown;
+}
+
+std::string AssetDatabase::NormalizePath(const std::string& path) {
+    // Interned, so each spelling only hits the file system once
+    return ResourceId::FromPath(path).GetPath();
+}
+
+uint64_t AssetDatabase::HashBytes(const void* data, size_t size, uint64_t seed) {
+    // FNV-1a, 64 bit
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= FnvPrime;
+    }
+    return hash;
+}
+
+bool AssetDatabase::HashFile(const std::string& path, uint64_t& hash) {
+    MappedFile file;
+    if (!file.Open(path)) return false;
+
+    hash = HashBytes(file.GetData(), file.GetSize());
+    return true;
+}
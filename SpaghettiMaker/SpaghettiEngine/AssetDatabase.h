@@ -0,0 +1,98 @@
+#pragma once
+#include "ResourceId.h"
+#include "FlatHashMap.h"
+#include <string>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+enum class AssetType {
+    Unknown,
+    Model,  // .fbx, cooked to a .smesh in the library
+    Texture, // .png, .tga, .dds
+    Atlas    // .satlas in the library, cooked from a set of textures
+};
+
+struct AssetRecord {
+    AssetType type = AssetType::Unknown;
+    std::string sourcePath;    // Normalized source path, also the lookup key
+    std::string cookedPath;    // Import output in the library (empty when the source is used directly)
+    uint64_t contentHash = 0;  // Hash of the source file contents
+    uint64_t settingsHash = 0; // Hash of the import settings the output was produced with
+    uint64_t sourceSize = 0;   // Size and write time let unchanged files skip hashing
+    int64_t sourceTime = 0;
+};
+
+// Tracks source assets and their cooked outputs, so work is only redone when the
+// source contents or the import settings actually changed. The manifest is kept
+// in the library directory between runs. All methods are safe to call from worker threads.
+class AssetDatabase {
+private:
+    // One import running for a source; later callers wait for it and take its result
+    struct InFlightImport {
+        bool done = false;
+        std::string result;
+    };
+
+    static AssetDatabase* s_instance;
+    std::string _libraryPath = "Library";
+    FlatHashMap<ResourceId, AssetRecord, ResourceIdHash> _records;
+    FlatHashMap<ResourceId, uint64_t, ResourceIdHash> _pendingHashes; // Hashed by NeedsImport, consumed by MarkImported
+    FlatHashMap<ResourceId, std::shared_ptr<InFlightImport>, ResourceIdHash> _importing;
+    std::condition_variable _importFinished;
+    bool _dirty = false;
+    mutable std::mutex _mutex;
+
+    // Private constructor for singleton
+    AssetDatabase() = default;
+
+    bool LoadManifest();
+    std::string GetManifestPath() const;
+
+public:
+    static AssetDatabase* GetInstance() {
+        if (!s_instance) {
+            s_instance = new AssetDatabase();
+        }
+        return s_instance;
+    }
+
+    static void Destroy() {
+        delete s_instance;
+        s_instance = nullptr;
+    }
+
+    // Loads the manifest from the library directory, creating it if needed
+    void Initialize(const std::string& libraryPath = "Library");
+    void Cleanup(); // Saves the manifest
+    bool SaveManifest();
+
+    // Imports every changed asset under a directory
+    void Refresh(const std::string& directory);
+
+    // Brings a single asset up to date. Returns false if the import failed.
+    bool Import(const std::string& sourcePath);
+
+    // Used by importers. Runs import (which returns the cooked path, or "" on failure) unless the
+    // output is up to date. Only one import of a source runs at a time; a concurrent caller
+    // waits for it and returns its result instead of cooking the same file again.
+    std::string ImportOnce(const std::string& sourcePath, uint64_t settingsHash, const std::function<std::string()>& import);
+    bool NeedsImport(const std::string& sourcePath, uint64_t settingsHash);
+    void MarkImported(const std::string& sourcePath, const std::string& cookedPath, uint64_t settingsHash);
+    std::string GetCookedPath(const std::string& sourcePath, const std::string& extension) const;
+
+    // Returns the cooked output for a source, or the source itself if it has none
+    std::string Resolve(const std::string& sourcePath) const;
+    bool GetRecord(const std::string& sourcePath, AssetRecord& record) const;
+    bool GetRecord(ResourceId source, AssetRecord& record) const;
+    const std::string& GetLibraryPath() const { return _libraryPath; }
+
+    static AssetType GetAssetType(const std::string& path);
+    static std::string NormalizePath(const std::string& path); // Canonical path of a ResourceId
+    static uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
+    static bool HashFile(const std::string& path, uint64_t& hash);
+};
+
+#define ASSET_DATABASE AssetDatabase::GetInstance()
@@ -15,6 +15,16 @@
 #include <psapi.h> 
 #endif
 #include "GameObject.h"
+#include "ModelLoader.h"
+#include "UploadQueue.h"
+#include "SceneSerializer.h"
+#include "PrefabInstanceComponent.h"
+#include "TransformComponent.h"
+#include "WorldStreamer.h"
+#include "Log.h"
+#include "Profiler.h"
+#include "Renderer.h"
+#include <filesystem>
 
 // Constructor
 ConsoleWindow::ConsoleWindow(SDL_Window* window, void* context) {
@@ -63,10 +73,92 @@ void ConsoleWindow::render() {
     ImGui_ImplSDL2_NewFrame();
     ImGui::NewFrame();
 
+    // Messages the logger's sink formatted since the last frame
+    LOGGER->DrainConsole([this](const std::string& line) { addLog(line); });
+
+    // Sampled every frame, not only while the config window is open
+    auto now = std::chrono::high_resolution_clock::now();
+    float deltaTime = std::chrono::duration<float, std::chrono::seconds::period>(now - lastFrameTime).count();
+    lastFrameTime = now;
+    float fps = deltaTime > 0.0f ? 1.0f / deltaTime : 0.0f;
+    if (fpsHistory.size() >= maxFPSHistorySize) {
+        fpsHistory.erase(fpsHistory.begin());
+    }
+    fpsHistory.push_back(fps);
+
     // Main Menu Bar
     if (ImGui::BeginMainMenuBar()) {
+        if (_activeScene && ImGui::BeginMenu("Scene")) {
+            // One file per scene name; other scene files can be opened by dropping them on the window
+            const std::string scenePath = "Assets/Scenes/" + _activeScene->GetName() + SceneSerializer::GetExtension();
+            if (ImGui::MenuItem("Save")) {
+                SceneSerializer::Save(_activeScene, scenePath);
+            }
+            if (ImGui::MenuItem("Reload", nullptr, false, std::filesystem::exists(scenePath))) {
+                WORLD_STREAMER->Close();
+                SceneSerializer::Load(_activeScene, scenePath);
+            }
+
+            // Streamed world: the scene split into cells that load around the camera
+            ImGui::Separator();
+            const std::string worldPath = "Assets/World";
+            if (ImGui::MenuItem("Export World Cells", nullptr, false, !WORLD_STREAMER->IsOpen())) {
+                WorldStreamer::BuildCells(_activeScene, worldPath);
+            }
+            bool streaming = WORLD_STREAMER->IsOpen();
+            if (ImGui::MenuItem("Stream World", nullptr, &streaming)) {
+                if (streaming) {
+                    WORLD_STREAMER->Open(_activeScene, worldPath);
+                }
+                else {
+                    WORLD_STREAMER->Close();
+                }
+            }
+            if (WORLD_STREAMER->IsOpen()) {
+                ImGui::Text("Cells: %zu loaded, %zu busy, %zu total", WORLD_STREAMER->GetLoadedCellCount(),
+                    WORLD_STREAMER->GetBusyCellCount(), WORLD_STREAMER->GetCellCount());
+            }
+            ImGui::EndMenu();
+        }
+
         if (ImGui::BeginMenu("GameObjects")) {
             PrimitiveMenu::ShowPrimitiveMenu(_activeScene);
+
+            // Prefabs: the selection's children become one shared template drawn by a single object
+            GameObject* selected = _activeScene ? _activeScene->GetSelectedGameObject() : nullptr;
+            auto instance = selected ? selected->GetComponent<PrefabInstanceComponent>() : nullptr;
+            const bool isInstance = instance && instance->GetPrefab();
+            ImGui::Separator();
+            bool dropAsPrefabs = _activeScene && _activeScene->GetDropModelsAsPrefabs();
+            if (ImGui::MenuItem("Drop Models As Prefabs", nullptr, &dropAsPrefabs, _activeScene != nullptr)) {
+                _activeScene->SetDropModelsAsPrefabs(dropAsPrefabs);
+            }
+            if (ImGui::MenuItem("Pack Into Prefab", nullptr, false, selected && !isInstance && !selected->GetChildren().empty())) {
+                PrefabPtr prefab = Prefab::FromGameObject(selected);
+                std::vector<GameObject*> children;
+                for (const auto& child : selected->GetChildren()) {
+                    children.push_back(child.get());
+                }
+                _activeScene->DestroyGameObjects(children);
+                _activeScene->SetSelectedGameObject(selected);
+                if (instance) {
+                    instance->SetPrefab(prefab);
+                }
+                else {
+                    selected->AddComponent<PrefabInstanceComponent>(prefab);
+                }
+            }
+            if (ImGui::MenuItem("Duplicate Prefab Instance", nullptr, false, isInstance)) {
+                GameObject* copy = Prefab::Instantiate(_activeScene, instance->GetPrefab(), selected->GetParent());
+                if (auto source = selected->GetComponent<TransformComponent>()) {
+                    copy->GetComponent<TransformComponent>()->SetLocalTransform(source->GetLocalPosition(),
+                        source->GetLocalRotation(), source->GetLocalScale());
+                }
+                _activeScene->SetSelectedGameObject(copy);
+            }
+            if (ImGui::MenuItem("Unpack Prefab", nullptr, false, isInstance)) {
+                instance->Unpack(_activeScene);
+            }
             ImGui::EndMenu();
         }
 
@@ -104,23 +196,15 @@ void ConsoleWindow::render() {
 
 
             // Display the FPS graph in the popup
-
-            // FPS calculation
-            auto now = std::chrono::high_resolution_clock::now();
-            float deltaTime = std::chrono::duration<float, std::chrono::seconds::period>(now - lastFrameTime).count();
-            lastFrameTime = now;
-
-            // Calculate FPS and store in buffer
-            float fps = 1.0f / deltaTime;
-            if (fpsHistory.size() >= maxFPSHistorySize) {
-                fpsHistory.erase(fpsHistory.begin());
-            }
-            fpsHistory.push_back(fps);
-
             // Display current FPS
             ImGui::Text("FPS: %.1f", fps);  // Display current FPS
             ImGui::PlotLines("FPS History", fpsHistory.data(), fpsHistory.size(), 0, NULL, 0.0f, 120.0f, ImVec2(0, 100));
 
+            // Draw submission and GPU time of the last frame, to tell CPU and GPU bound frames apart
+            ImGui::SeparatorText("Rendering");
+            RENDERER->OnStatsGUI();
+            ImGui::Separator();
+
             // Display hardware and software information
             ImGui::Text("Hardware and Software Information:");
 
@@ -152,6 +236,10 @@ void ConsoleWindow::render() {
             ImGui::EndPopup();
         }
 
+        if (ImGui::Button(_showProfiler ? "Hide Profiler" : "Profiler")) {
+            _showProfiler = !_showProfiler;
+        }
+
         if (ImGui::Button("Console")) {
             ImGui::OpenPopup("ConsolePopup");  
         }
@@ -282,9 +370,78 @@ void ConsoleWindow::render() {
 
         ImGui::End();  // End the ImGui window
     }
+
+    renderLoads();
+
+    if (_showProfiler) {
+        ImGui::SetNextWindowPos(ImVec2(160, 360), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowSize(ImVec2(800, 340), ImGuiCond_FirstUseEver);
+        if (ImGui::Begin("Profiler", &_showProfiler)) {
+            PROFILER->OnInspectorGUI();
+        }
+        ImGui::End();
+    }
+
     // Render the ImGui frame
     ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    {
+        RenderPassScope pass(RenderPass::UI);
+        RENDERER->CountDrawData(ImGui::GetDrawData());
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    }
+}
+
+// Background model loads: progress, cancellation and a log line when each one ends
+void ConsoleWindow::renderLoads() {
+    for (const auto& load : ModelLoader::GetActiveLoads()) {
+        switch (load->status.load()) {
+        case ModelLoadStatus::Done:
+            addLog("Loaded model: " + load->path);
+            break;
+        case ModelLoadStatus::Failed:
+            addLog("Failed to load model: " + load->path + " (" + load->error + ")");
+            break;
+        case ModelLoadStatus::Cancelled:
+            addLog("Cancelled loading model: " + load->path);
+            break;
+        default:
+            break;
+        }
+    }
+    ModelLoader::ClearFinishedLoads();
+
+    const auto& loads = ModelLoader::GetActiveLoads();
+    if (loads.empty()) return;
+
+    ImGui::SetNextWindowPos(ImVec2(160, 640), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(400, 0), ImGuiCond_FirstUseEver);
+    ImGui::Begin("Loading");
+
+    for (const auto& load : loads) {
+        ImGui::PushID(load.get());
+
+        const char* stage = "Queued";
+        switch (load->status.load()) {
+        case ModelLoadStatus::Importing: stage = "Importing"; break;
+        case ModelLoadStatus::Uploading: stage = "Uploading"; break;
+        default: break;
+        }
+
+        ImGui::Text("%s (%s)", std::filesystem::path(load->path).filename().string().c_str(), stage);
+        ImGui::ProgressBar(load->progress.load(), ImVec2(-70, 0));
+        ImGui::SameLine();
+        if (load->cancelRequested) {
+            ImGui::TextDisabled("Cancelling");
+        }
+        else if (ImGui::Button("Cancel")) {
+            load->Cancel();
+        }
+
+        ImGui::PopID();
+    }
+
+    ImGui::Text("Pending uploads: %zu", UPLOAD_QUEUE->GetPendingCount());
+    ImGui::End();
 }
 
 // Event processing
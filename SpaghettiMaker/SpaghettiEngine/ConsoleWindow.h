@@ -24,8 +24,10 @@ public:
 	void SetActiveScene(Scene* scene) { _activeScene = scene; }
 	Scene* GetActiveScene() const { return _activeScene; }
 private:
+	void renderLoads();
 	Scene* _activeScene = nullptr;  // Add this member
 	bool _showEditorWindows = true;
+	bool _showProfiler = false;
 	std::vector<std::string> logBuffer; // Log buffer for storing console messages
 	float sliderValue = 0.5f;  // Initial value for the slider
 	bool checkboxValue = false;  // Initial value for the checkbox
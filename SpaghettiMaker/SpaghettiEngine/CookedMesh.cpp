@@ -0,0 +1,306 @@
+#include "CookedMesh.h"
+#include "Log.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+namespace {
+    uint64_t AlignOffset(uint64_t offset) {
+        return (offset + CookedMeshAlignment - 1) & ~uint64_t(CookedMeshAlignment - 1);
+    }
+
+    void PadTo(std::ofstream& out, uint64_t offset) {
+        static const char zeros[CookedMeshAlignment] = {};
+        uint64_t position = static_cast<uint64_t>(out.tellp());
+        if (offset > position) {
+            out.write(zeros, static_cast<std::streamsize>(offset - position));
+        }
+    }
+
+    void CopyString(char* dest, size_t destSize, const std::string& source) {
+        size_t length = std::min(source.size(), destSize - 1);
+        std::memcpy(dest, source.data(), length);
+        std::memset(dest + length, 0, destSize - length);
+    }
+
+    void StoreVec3(float dest[3], const vec3& v) {
+        dest[0] = static_cast<float>(v.x);
+        dest[1] = static_cast<float>(v.y);
+        dest[2] = static_cast<float>(v.z);
+    }
+}
+
+bool CookedMesh::Open(const std::string& path) {
+    Close();
+
+    if (!_file.Open(path)) return false;
+
+    if (!Validate(path)) {
+        _file.Close();
+        return false;
+    }
+
+    const unsigned char* data = _file.GetData();
+    _header = reinterpret_cast<const CookedMeshHeader*>(data);
+    _submeshes = reinterpret_cast<const CookedSubmesh*>(data + _header->submeshTableOffset);
+    _materials = reinterpret_cast<const CookedMaterial*>(data + _header->materialTableOffset);
+    _nodes = reinterpret_cast<const CookedNode*>(data + _header->nodeTableOffset);
+    _nodeMeshes = reinterpret_cast<const uint32_t*>(data + _header->nodeMeshTableOffset);
+    _vertices = reinterpret_cast<const StandardVertex*>(data + _header->vertexDataOffset);
+    _indices = reinterpret_cast<const unsigned int*>(data + _header->indexDataOffset);
+    return true;
+}
+
+void CookedMesh::Close() {
+    _file.Close();
+    _header = nullptr;
+    _submeshes = nullptr;
+    _materials = nullptr;
+    _nodes = nullptr;
+    _nodeMeshes = nullptr;
+    _vertices = nullptr;
+    _indices = nullptr;
+}
+
+bool CookedMesh::Validate(const std::string& path) const {
+    const size_t size = _file.GetSize();
+    if (size < sizeof(CookedMeshHeader)) return false;
+
+    const CookedMeshHeader* header = reinterpret_cast<const CookedMeshHeader*>(_file.GetData());
+    if (header->magic != CookedMeshMagic) {
+        LOG_ERROR(Mesh, "Not a cooked mesh: {}", path);
+        return false;
+    }
+    if (header->version != CookedMeshVersion || header->vertexFormat != static_cast<uint32_t>(VertexFormat::Standard)) {
+        LOG_INFO(Mesh, "Cooked mesh is out of date (version {}): {}", header->version, path);
+        return false;
+    }
+
+    // Every table and blob must lie inside the file
+    auto inFile = [size](uint64_t offset, uint64_t length) {
+        return offset <= size && length <= size - offset;
+    };
+    if (!inFile(header->submeshTableOffset, uint64_t(header->submeshCount) * sizeof(CookedSubmesh)) ||
+        !inFile(header->materialTableOffset, uint64_t(header->materialCount) * sizeof(CookedMaterial)) ||
+        !inFile(header->nodeTableOffset, uint64_t(header->nodeCount) * sizeof(CookedNode)) ||
+        !inFile(header->nodeMeshTableOffset, uint64_t(header->nodeMeshCount) * sizeof(uint32_t)) ||
+        !inFile(header->vertexDataOffset, header->vertexDataSize) ||
+        !inFile(header->indexDataOffset, header->indexDataSize)) {
+        LOG_ERROR(Mesh, "Cooked mesh is truncated: {}", path);
+        return false;
+    }
+
+    const uint64_t vertexCount = header->vertexDataSize / sizeof(StandardVertex);
+    const uint64_t indexCount = header->indexDataSize / sizeof(unsigned int);
+    const CookedSubmesh* submeshes = reinterpret_cast<const CookedSubmesh*>(_file.GetData() + header->submeshTableOffset);
+    for (uint32_t i = 0; i < header->submeshCount; ++i) {
+        const CookedSubmesh& submesh = submeshes[i];
+        if (uint64_t(submesh.firstVertex) + submesh.vertexCount > vertexCount ||
+            uint64_t(submesh.firstIndex) + submesh.indexCount > indexCount ||
+            (header->materialCount > 0 && submesh.materialIndex >= header->materialCount)) {
+            LOG_ERROR(Mesh, "Cooked mesh has an invalid submesh table: {}", path);
+            return false;
+        }
+    }
+
+    // Parents must come first so the hierarchy can be built in one pass
+    const CookedNode* nodes = reinterpret_cast<const CookedNode*>(_file.GetData() + header->nodeTableOffset);
+    const uint32_t* nodeMeshes = reinterpret_cast<const uint32_t*>(_file.GetData() + header->nodeMeshTableOffset);
+    for (uint32_t i = 0; i < header->nodeCount; ++i) {
+        const CookedNode& node = nodes[i];
+        bool valid = node.parent < static_cast<int32_t>(i) && node.parent >= -1 &&
+            uint64_t(node.firstMesh) + node.meshCount <= header->nodeMeshCount;
+        for (uint32_t m = 0; valid && m < node.meshCount; ++m) {
+            valid = nodeMeshes[node.firstMesh + m] < header->submeshCount;
+        }
+        if (!valid) {
+            LOG_ERROR(Mesh, "Cooked mesh has an invalid node table: {}", path);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::span<const StandardVertex> CookedMesh::GetVertices(uint32_t submesh) const {
+    const CookedSubmesh& entry = _submeshes[submesh];
+    return std::span<const StandardVertex>(_vertices + entry.firstVertex, entry.vertexCount);
+}
+
+std::span<const unsigned int> CookedMesh::GetIndices(uint32_t submesh) const {
+    const CookedSubmesh& entry = _submeshes[submesh];
+    return std::span<const unsigned int>(_indices + entry.firstIndex, entry.indexCount);
+}
+
+MaterialData CookedMesh::GetMaterial(uint32_t index) const {
+    const CookedMaterial& cooked = _materials[index];
+    MaterialData material;
+    material.flags = cooked.flags;
+    material.ambient = vec3(cooked.ambient[0], cooked.ambient[1], cooked.ambient[2]);
+    material.diffuse = vec3(cooked.diffuse[0], cooked.diffuse[1], cooked.diffuse[2]);
+    material.specular = vec3(cooked.specular[0], cooked.specular[1], cooked.specular[2]);
+    material.shininess = cooked.shininess;
+    material.diffuseTexture = std::string(cooked.diffuseTexture, strnlen(cooked.diffuseTexture, sizeof(cooked.diffuseTexture)));
+    return material;
+}
+
+NodeData CookedMesh::GetNode(uint32_t index) const {
+    const CookedNode& cooked = _nodes[index];
+    NodeData node;
+    node.name = std::string(cooked.name, strnlen(cooked.name, sizeof(cooked.name)));
+    node.parent = cooked.parent;
+    node.meshes.assign(_nodeMeshes + cooked.firstMesh, _nodeMeshes + cooked.firstMesh + cooked.meshCount);
+    node.position = vec3(cooked.position[0], cooked.position[1], cooked.position[2]);
+    node.rotation = quat(cooked.rotation[3], cooked.rotation[0], cooked.rotation[1], cooked.rotation[2]);
+    node.scale = vec3(cooked.scale[0], cooked.scale[1], cooked.scale[2]);
+    return node;
+}
+
+bool CookedMesh::Write(const std::string& path, const std::vector<MeshData>& meshes, const std::vector<MaterialData>& materials, const std::vector<NodeData>& nodes) {
+    CookedMeshHeader header = {};
+    header.magic = CookedMeshMagic;
+    header.version = CookedMeshVersion;
+    header.vertexFormat = static_cast<uint32_t>(VertexFormat::Standard);
+    header.submeshCount = static_cast<uint32_t>(meshes.size());
+    header.materialCount = static_cast<uint32_t>(materials.size());
+
+    // Build the submesh table and overall bounds
+    std::vector<CookedSubmesh> submeshes(meshes.size());
+    fvec3 modelMin(std::numeric_limits<float>::max());
+    fvec3 modelMax(-std::numeric_limits<float>::max());
+    uint64_t vertexCount = 0;
+    uint64_t indexCount = 0;
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const MeshData& mesh = meshes[i];
+        CookedSubmesh& submesh = submeshes[i];
+        CopyString(submesh.name, sizeof(submesh.name), mesh.name);
+        submesh.firstVertex = static_cast<uint32_t>(vertexCount);
+        submesh.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+        submesh.firstIndex = static_cast<uint32_t>(indexCount);
+        submesh.indexCount = static_cast<uint32_t>(mesh.indices.size());
+        submesh.materialIndex = mesh.materialIndex;
+
+        fvec3 boundsMin(std::numeric_limits<float>::max());
+        fvec3 boundsMax(-std::numeric_limits<float>::max());
+        for (const auto& vertex : mesh.vertices) {
+            boundsMin = glm::min(boundsMin, GetVertexPosition(vertex));
+            boundsMax = glm::max(boundsMax, GetVertexPosition(vertex));
+        }
+        if (mesh.vertices.empty()) {
+            boundsMin = boundsMax = fvec3(0.0f);
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            submesh.boundsMin[axis] = boundsMin[axis];
+            submesh.boundsMax[axis] = boundsMax[axis];
+        }
+        modelMin = glm::min(modelMin, boundsMin);
+        modelMax = glm::max(modelMax, boundsMax);
+
+        vertexCount += mesh.vertices.size();
+        indexCount += mesh.indices.size();
+    }
+    if (meshes.empty()) {
+        modelMin = modelMax = fvec3(0.0f);
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+        header.boundsMin[axis] = modelMin[axis];
+        header.boundsMax[axis] = modelMax[axis];
+    }
+
+    std::vector<CookedMaterial> cookedMaterials(materials.size());
+    for (size_t i = 0; i < materials.size(); ++i) {
+        const MaterialData& material = materials[i];
+        CookedMaterial& cooked = cookedMaterials[i];
+        cooked.flags = material.flags;
+        StoreVec3(cooked.ambient, material.ambient);
+        StoreVec3(cooked.diffuse, material.diffuse);
+        StoreVec3(cooked.specular, material.specular);
+        cooked.shininess = static_cast<float>(material.shininess);
+        CopyString(cooked.diffuseTexture, sizeof(cooked.diffuseTexture), material.diffuseTexture);
+    }
+
+    std::vector<CookedNode> cookedNodes(nodes.size());
+    std::vector<uint32_t> nodeMeshes;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const NodeData& node = nodes[i];
+        CookedNode& cooked = cookedNodes[i];
+        CopyString(cooked.name, sizeof(cooked.name), node.name);
+        cooked.parent = node.parent;
+        cooked.firstMesh = static_cast<uint32_t>(nodeMeshes.size());
+        cooked.meshCount = static_cast<uint32_t>(node.meshes.size());
+        nodeMeshes.insert(nodeMeshes.end(), node.meshes.begin(), node.meshes.end());
+        StoreVec3(cooked.position, node.position);
+        cooked.rotation[0] = static_cast<float>(node.rotation.x);
+        cooked.rotation[1] = static_cast<float>(node.rotation.y);
+        cooked.rotation[2] = static_cast<float>(node.rotation.z);
+        cooked.rotation[3] = static_cast<float>(node.rotation.w);
+        StoreVec3(cooked.scale, node.scale);
+    }
+    header.nodeCount = static_cast<uint32_t>(cookedNodes.size());
+    header.nodeMeshCount = static_cast<uint32_t>(nodeMeshes.size());
+
+    // Lay out the file, every section aligned
+    header.submeshTableOffset = AlignOffset(sizeof(CookedMeshHeader));
+    header.materialTableOffset = AlignOffset(header.submeshTableOffset + submeshes.size() * sizeof(CookedSubmesh));
+    header.nodeTableOffset = AlignOffset(header.materialTableOffset + cookedMaterials.size() * sizeof(CookedMaterial));
+    header.nodeMeshTableOffset = AlignOffset(header.nodeTableOffset + cookedNodes.size() * sizeof(CookedNode));
+    header.vertexDataOffset = AlignOffset(header.nodeMeshTableOffset + nodeMeshes.size() * sizeof(uint32_t));
+    header.vertexDataSize = vertexCount * sizeof(StandardVertex);
+    header.indexDataOffset = AlignOffset(header.vertexDataOffset + header.vertexDataSize);
+    header.indexDataSize = indexCount * sizeof(unsigned int);
+
+    std::error_code error;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    // Write to a temporary file first so a failed cook never leaves a half-written file behind,
+    // named per thread so concurrent imports of the same model don't write into each other
+    std::string tempPath = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOG_ERROR(Mesh, "Failed to open cooked mesh for writing: {}", tempPath);
+            return false;
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        PadTo(out, header.submeshTableOffset);
+        out.write(reinterpret_cast<const char*>(submeshes.data()), submeshes.size() * sizeof(CookedSubmesh));
+        PadTo(out, header.materialTableOffset);
+        out.write(reinterpret_cast<const char*>(cookedMaterials.data()), cookedMaterials.size() * sizeof(CookedMaterial));
+        PadTo(out, header.nodeTableOffset);
+        out.write(reinterpret_cast<const char*>(cookedNodes.data()), cookedNodes.size() * sizeof(CookedNode));
+        PadTo(out, header.nodeMeshTableOffset);
+        out.write(reinterpret_cast<const char*>(nodeMeshes.data()), nodeMeshes.size() * sizeof(uint32_t));
+        PadTo(out, header.vertexDataOffset);
+        for (const auto& mesh : meshes) {
+            out.write(reinterpret_cast<const char*>(mesh.vertices.data()), mesh.vertices.size() * sizeof(StandardVertex));
+        }
+        PadTo(out, header.indexDataOffset);
+        for (const auto& mesh : meshes) {
+            out.write(reinterpret_cast<const char*>(mesh.indices.data()), mesh.indices.size() * sizeof(unsigned int));
+        }
+
+        if (!out) {
+            LOG_ERROR(Mesh, "Failed to write cooked mesh: {}", tempPath);
+            out.close();
+            std::filesystem::remove(tempPath);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        LOG_ERROR(Mesh, "Failed to replace cooked mesh {}: {}", path, error.message());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    LOG_INFO(Mesh, "Cooked {} meshes, {} nodes ({} vertices, {} indices) to {}", meshes.size(), nodes.size(), vertexCount, indexCount, path);
+    return true;
+}
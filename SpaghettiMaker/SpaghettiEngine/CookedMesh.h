@@ -0,0 +1,151 @@
+#pragma once
+#include "types.h"
+#include "VertexFormat.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+// On-disk layout of a cooked model (.smesh). All blobs are little-endian and already in
+// the final GPU layout, so loading is a memory map followed by glBufferData straight from
+// the mapping. Bump CookedMeshVersion whenever any of these structs or the import changes.
+//
+//   CookedMeshHeader
+//   CookedSubmesh[submeshCount]
+//   CookedMaterial[materialCount]
+//   CookedNode[nodeCount] (depth first, parents before children)
+//   node mesh list (uint32 submesh indices, nodeMeshCount)
+//   vertex blob (StandardVertex, every submesh back to back)
+//   index blob (uint32, relative to the submesh's first vertex)
+
+const uint32_t CookedMeshMagic = 0x48534D53; // "SMSH"
+const uint32_t CookedMeshVersion = 3;
+const size_t CookedMeshAlignment = 64;
+
+struct CookedMeshHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertexFormat;
+    uint32_t submeshCount;
+    uint32_t materialCount;
+    uint32_t nodeCount;
+    uint32_t nodeMeshCount;
+    uint32_t reserved;
+    uint64_t submeshTableOffset;
+    uint64_t materialTableOffset;
+    uint64_t nodeTableOffset;
+    uint64_t nodeMeshTableOffset;
+    uint64_t vertexDataOffset;
+    uint64_t vertexDataSize;
+    uint64_t indexDataOffset;
+    uint64_t indexDataSize;
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+struct CookedSubmesh {
+    char name[64];
+    uint32_t firstVertex;
+    uint32_t vertexCount;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    uint32_t materialIndex;
+    uint32_t reserved;
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+// Which CookedMaterial fields were present in the source material
+enum CookedMaterialFlags : uint32_t {
+    CookedMaterial_Ambient = 1 << 0,
+    CookedMaterial_Diffuse = 1 << 1,
+    CookedMaterial_Specular = 1 << 2,
+    CookedMaterial_Shininess = 1 << 3,
+    CookedMaterial_DiffuseTexture = 1 << 4,
+    CookedMaterial_UnitTexCoords = 1 << 5 // Every mesh using it keeps its UVs inside 0-1, so its texture can be atlased
+};
+
+struct CookedMaterial {
+    float ambient[3];
+    float diffuse[3];
+    float specular[3];
+    float shininess;
+    uint32_t flags;
+    char diffuseTexture[260];
+};
+
+// Scene hierarchy node. Meshes are stored once in the submesh table and referenced by
+// any number of nodes; transforms are local and already in engine space.
+struct CookedNode {
+    char name[64];
+    int32_t parent;     // Index of the parent node, -1 for the root
+    uint32_t firstMesh; // Into the node mesh list
+    uint32_t meshCount;
+    uint32_t reserved;
+    float position[3];
+    float rotation[4];  // x, y, z, w
+    float scale[3];
+};
+
+static_assert(sizeof(CookedMeshHeader) == 120, "CookedMeshHeader layout changed, bump CookedMeshVersion");
+static_assert(sizeof(CookedSubmesh) == 112, "CookedSubmesh layout changed, bump CookedMeshVersion");
+static_assert(sizeof(CookedMaterial) == 304, "CookedMaterial layout changed, bump CookedMeshVersion");
+static_assert(sizeof(CookedNode) == 120, "CookedNode layout changed, bump CookedMeshVersion");
+
+// Import results in memory, before cooking
+struct MeshData {
+    std::string name;
+    std::vector<StandardVertex> vertices;
+    std::vector<unsigned int> indices;
+    unsigned int materialIndex = 0;
+};
+
+struct MaterialData {
+    uint32_t flags = 0;
+    vec3 ambient = vec3(0.0);
+    vec3 diffuse = vec3(0.0);
+    vec3 specular = vec3(0.0);
+    double shininess = 0.0;
+    std::string diffuseTexture;
+};
+
+struct NodeData {
+    std::string name;
+    int parent = -1;
+    std::vector<unsigned int> meshes;
+    vec3 position = vec3(0.0);
+    quat rotation = quat(1.0, 0.0, 0.0, 0.0);
+    vec3 scale = vec3(1.0);
+};
+
+// Read-only view of a cooked model. Spans point into the mapping and stay valid until Close().
+class CookedMesh {
+private:
+    MappedFile _file;
+    const CookedMeshHeader* _header = nullptr;
+    const CookedSubmesh* _submeshes = nullptr;
+    const CookedMaterial* _materials = nullptr;
+    const CookedNode* _nodes = nullptr;
+    const uint32_t* _nodeMeshes = nullptr;
+    const StandardVertex* _vertices = nullptr;
+    const unsigned int* _indices = nullptr;
+
+    bool Validate(const std::string& path) const;
+
+public:
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return _header != nullptr; }
+
+    static bool Write(const std::string& path, const std::vector<MeshData>& meshes, const std::vector<MaterialData>& materials, const std::vector<NodeData>& nodes);
+
+    uint32_t GetSubmeshCount() const { return _header ? _header->submeshCount : 0; }
+    uint32_t GetMaterialCount() const { return _header ? _header->materialCount : 0; }
+    const CookedSubmesh& GetSubmesh(uint32_t index) const { return _submeshes[index]; }
+    std::span<const StandardVertex> GetVertices(uint32_t submesh) const;
+    std::span<const unsigned int> GetIndices(uint32_t submesh) const;
+    MaterialData GetMaterial(uint32_t index) const;
+    uint32_t GetNodeCount() const { return _header ? _header->nodeCount : 0; }
+    NodeData GetNode(uint32_t index) const;
+};
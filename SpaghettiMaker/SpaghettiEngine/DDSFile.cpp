@@ -0,0 +1,325 @@
+#include "DDSFile.h"
+#include "Log.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace {
+    constexpr uint32_t MakeFourCC(char a, char b, char c, char d) {
+        return static_cast<uint32_t>(static_cast<unsigned char>(a)) |
+            (static_cast<uint32_t>(static_cast<unsigned char>(b)) << 8) |
+            (static_cast<uint32_t>(static_cast<unsigned char>(c)) << 16) |
+            (static_cast<uint32_t>(static_cast<unsigned char>(d)) << 24);
+    }
+
+    const uint32_t DDSMagic = MakeFourCC('D', 'D', 'S', ' ');
+
+    // DDSHeader::flags
+    const uint32_t DDSD_CAPS = 0x1;
+    const uint32_t DDSD_HEIGHT = 0x2;
+    const uint32_t DDSD_WIDTH = 0x4;
+    const uint32_t DDSD_PITCH = 0x8;
+    const uint32_t DDSD_PIXELFORMAT = 0x1000;
+    const uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+    const uint32_t DDSD_LINEARSIZE = 0x80000;
+    const uint32_t DDSD_DEPTH = 0x800000;
+
+    // DDSPixelFormat::flags
+    const uint32_t DDPF_ALPHAPIXELS = 0x1;
+    const uint32_t DDPF_FOURCC = 0x4;
+    const uint32_t DDPF_RGB = 0x40;
+
+    // DDSHeader::caps and caps2
+    const uint32_t DDSCAPS_COMPLEX = 0x8;
+    const uint32_t DDSCAPS_TEXTURE = 0x1000;
+    const uint32_t DDSCAPS_MIPMAP = 0x400000;
+    const uint32_t DDSCAPS2_CUBEMAP = 0x200;
+
+    // The DXGI formats we read and write
+    const uint32_t DXGI_FORMAT_R8G8B8A8_UNORM = 28;
+    const uint32_t DXGI_FORMAT_R8G8B8A8_UNORM_SRGB = 29;
+    const uint32_t DXGI_FORMAT_BC1_UNORM = 71;
+    const uint32_t DXGI_FORMAT_BC1_UNORM_SRGB = 72;
+    const uint32_t DXGI_FORMAT_BC3_UNORM = 77;
+    const uint32_t DXGI_FORMAT_BC3_UNORM_SRGB = 78;
+    const uint32_t DXGI_FORMAT_BC5_UNORM = 83;
+    const uint32_t DXGI_FORMAT_BC7_UNORM = 98;
+    const uint32_t DXGI_FORMAT_BC7_UNORM_SRGB = 99;
+    const uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+
+    bool GetDXGIFormat(uint32_t dxgiFormat, TextureFormat& format) {
+        switch (dxgiFormat) {
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB: format = TextureFormat::RGBA8; return true;
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB: format = TextureFormat::BC1; return true;
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB: format = TextureFormat::BC3; return true;
+        case DXGI_FORMAT_BC5_UNORM: format = TextureFormat::BC5; return true;
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB: format = TextureFormat::BC7; return true;
+        default: return false;
+        }
+    }
+
+    // Extracts the 8-bit channel selected by a DDS channel mask
+    unsigned char ReadChannel(uint32_t pixel, uint32_t mask, unsigned char fallback) {
+        if (mask == 0) return fallback;
+        int shift = 0;
+        while (((mask >> shift) & 1) == 0) {
+            ++shift;
+        }
+        uint32_t maximum = mask >> shift;
+        uint32_t value = (pixel & mask) >> shift;
+        return static_cast<unsigned char>(maximum == 255 ? value : (value * 255 + maximum / 2) / maximum);
+    }
+}
+
+bool DDSFile::IsDDS(const unsigned char* data, size_t size) {
+    uint32_t magic = 0;
+    if (!data || size < sizeof(magic)) return false;
+    std::memcpy(&magic, data, sizeof(magic));
+    return magic == DDSMagic;
+}
+
+bool DDSFile::ReadHeader(const unsigned char* data, size_t size, ImageData& image, size_t& dataOffset) {
+    if (!IsDDS(data, size) || size < 4 + sizeof(DDSHeader)) {
+        LOG_ERROR(Texture, "Not a DDS file");
+        return false;
+    }
+
+    DDSHeader header;
+    std::memcpy(&header, data + 4, sizeof(header));
+    size_t offset = 4 + sizeof(DDSHeader);
+
+    if (header.size != sizeof(DDSHeader) || header.pixelFormat.size != sizeof(DDSPixelFormat)) {
+        LOG_ERROR(Texture, "Invalid DDS header");
+        return false;
+    }
+    if ((header.caps2 & DDSCAPS2_CUBEMAP) || ((header.flags & DDSD_DEPTH) && header.depth > 1)) {
+        LOG_ERROR(Texture, "Only 2D DDS textures are supported");
+        return false;
+    }
+
+    const DDSPixelFormat& pixelFormat = header.pixelFormat;
+    TextureFormat format = TextureFormat::RGBA8;
+
+    if (pixelFormat.flags & DDPF_FOURCC) {
+        switch (pixelFormat.fourCC) {
+        case MakeFourCC('D', 'X', 'T', '1'): format = TextureFormat::BC1; break;
+        case MakeFourCC('D', 'X', 'T', '5'): format = TextureFormat::BC3; break;
+        case MakeFourCC('A', 'T', 'I', '2'):
+        case MakeFourCC('B', 'C', '5', 'U'): format = TextureFormat::BC5; break;
+        case MakeFourCC('D', 'X', '1', '0'): {
+            DDSHeaderDX10 extension;
+            if (size < offset + sizeof(extension)) {
+                LOG_ERROR(Texture, "Truncated DDS DX10 header");
+                return false;
+            }
+            std::memcpy(&extension, data + offset, sizeof(extension));
+            offset += sizeof(extension);
+
+            if (extension.resourceDimension != DDS_DIMENSION_TEXTURE2D || extension.arraySize > 1) {
+                LOG_ERROR(Texture, "Only 2D DDS textures are supported");
+                return false;
+            }
+            if (!GetDXGIFormat(extension.dxgiFormat, format)) {
+                LOG_ERROR(Texture, "Unsupported DDS DXGI format: {}", extension.dxgiFormat);
+                return false;
+            }
+            break;
+        }
+        default:
+            LOG_ERROR(Texture, "Unsupported DDS FourCC: {}", std::string(reinterpret_cast<const char*>(&pixelFormat.fourCC), 4));
+            return false;
+        }
+    }
+    else if ((pixelFormat.flags & DDPF_RGB) && pixelFormat.rgbBitCount == 32) {
+        image.channels = (pixelFormat.flags & DDPF_ALPHAPIXELS) && pixelFormat.alphaMask ? 4 : 3;
+    }
+    else {
+        LOG_ERROR(Texture, "Unsupported DDS pixel format");
+        return false;
+    }
+
+    image.width = static_cast<int>(header.width);
+    image.height = static_cast<int>(header.height);
+    image.format = format;
+    if (TextureCompressor::IsCompressed(format)) {
+        image.channels = (format == TextureFormat::BC1) ? 3 : (format == TextureFormat::BC5) ? 2 : 4;
+    }
+    if (image.width <= 0 || image.height <= 0) {
+        LOG_ERROR(Texture, "Invalid DDS size: {}x{}", header.width, header.height);
+        return false;
+    }
+
+    // Keep as many levels as the file actually holds
+    uint32_t levelCount = (header.flags & DDSD_MIPMAPCOUNT) ? std::max(header.mipMapCount, 1u) : 1u;
+    image.levels.clear();
+    image.pixels.clear();
+    image.firstLevel = 0;
+    size_t dataSize = 0;
+    int width = image.width;
+    int height = image.height;
+    for (uint32_t level = 0; level < levelCount; level++) {
+        size_t levelSize = TextureCompressor::GetImageSize(format, width, height);
+        if (offset + dataSize + levelSize > size) break;
+
+        image.levels.push_back({ width, height, dataSize, levelSize });
+        dataSize += levelSize;
+        if (width == 1 && height == 1) break;
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+
+    if (image.levels.empty()) {
+        LOG_ERROR(Texture, "Truncated DDS file");
+        return false;
+    }
+
+    dataOffset = offset;
+    return true;
+}
+
+bool DDSFile::Read(const unsigned char* data, size_t size, ImageData& image) {
+    size_t offset = 0;
+    if (!ReadHeader(data, size, image, offset)) {
+        return false;
+    }
+
+    const ImageLevel& last = image.levels.back();
+    image.pixels.assign(data + offset, data + offset + last.offset + last.size);
+
+    DDSPixelFormat pixelFormat;
+    std::memcpy(&pixelFormat, data + 4 + offsetof(DDSHeader, pixelFormat), sizeof(pixelFormat));
+    const bool hasMasks = !(pixelFormat.flags & DDPF_FOURCC);
+
+    // Uncompressed files may use any channel order
+    if (hasMasks) {
+        const bool isRGBA = pixelFormat.redMask == 0x000000FF && pixelFormat.greenMask == 0x0000FF00 &&
+            pixelFormat.blueMask == 0x00FF0000 && pixelFormat.alphaMask == 0xFF000000;
+        const uint32_t alphaMask = (pixelFormat.flags & DDPF_ALPHAPIXELS) ? pixelFormat.alphaMask : 0;
+        if (!isRGBA || alphaMask == 0) {
+            for (size_t i = 0; i + 4 <= image.pixels.size(); i += 4) {
+                uint32_t pixel;
+                std::memcpy(&pixel, image.pixels.data() + i, 4);
+                image.pixels[i + 0] = ReadChannel(pixel, pixelFormat.redMask, 0);
+                image.pixels[i + 1] = ReadChannel(pixel, pixelFormat.greenMask, 0);
+                image.pixels[i + 2] = ReadChannel(pixel, pixelFormat.blueMask, 0);
+                image.pixels[i + 3] = ReadChannel(pixel, alphaMask, 255);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool DDSFile::Write(const std::string& path, const ImageData& image) {
+    std::vector<ImageLevel> levels = image.levels;
+    if (levels.empty()) {
+        levels.push_back({ image.width, image.height, 0, image.pixels.size() });
+    }
+    for (const ImageLevel& level : levels) {
+        if (level.offset + level.size > image.pixels.size()) {
+            LOG_ERROR(Texture, "DDS level data out of range: {}", path);
+            return false;
+        }
+    }
+
+    DDSHeader header = {};
+    header.size = sizeof(DDSHeader);
+    header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT;
+    header.width = static_cast<uint32_t>(image.width);
+    header.height = static_cast<uint32_t>(image.height);
+    header.caps = DDSCAPS_TEXTURE;
+    if (levels.size() > 1) {
+        header.flags |= DDSD_MIPMAPCOUNT;
+        header.mipMapCount = static_cast<uint32_t>(levels.size());
+        header.caps |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+    }
+
+    DDSPixelFormat& pixelFormat = header.pixelFormat;
+    pixelFormat.size = sizeof(DDSPixelFormat);
+
+    DDSHeaderDX10 extension = {};
+    bool writeExtension = false;
+    switch (image.format) {
+    case TextureFormat::BC1:
+        pixelFormat.flags = DDPF_FOURCC;
+        pixelFormat.fourCC = MakeFourCC('D', 'X', 'T', '1');
+        break;
+    case TextureFormat::BC3:
+        pixelFormat.flags = DDPF_FOURCC;
+        pixelFormat.fourCC = MakeFourCC('D', 'X', 'T', '5');
+        break;
+    case TextureFormat::BC5:
+    case TextureFormat::BC7:
+        pixelFormat.flags = DDPF_FOURCC;
+        pixelFormat.fourCC = MakeFourCC('D', 'X', '1', '0');
+        extension.dxgiFormat = (image.format == TextureFormat::BC5) ? DXGI_FORMAT_BC5_UNORM : DXGI_FORMAT_BC7_UNORM;
+        extension.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+        extension.arraySize = 1;
+        writeExtension = true;
+        break;
+    default:
+        pixelFormat.flags = DDPF_RGB | DDPF_ALPHAPIXELS;
+        pixelFormat.rgbBitCount = 32;
+        pixelFormat.redMask = 0x000000FF;
+        pixelFormat.greenMask = 0x0000FF00;
+        pixelFormat.blueMask = 0x00FF0000;
+        pixelFormat.alphaMask = 0xFF000000;
+        break;
+    }
+
+    if (TextureCompressor::IsCompressed(image.format)) {
+        header.flags |= DDSD_LINEARSIZE;
+        header.pitchOrLinearSize = static_cast<uint32_t>(levels[0].size);
+    }
+    else {
+        header.flags |= DDSD_PITCH;
+        header.pitchOrLinearSize = static_cast<uint32_t>(image.width) * 4;
+    }
+
+    std::error_code error;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    // Same temporary file scheme as cooked meshes: never leave a half-written file behind
+    std::string tempPath = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOG_ERROR(Texture, "Failed to open DDS file for writing: {}", tempPath);
+            return false;
+        }
+
+        out.write(reinterpret_cast<const char*>(&DDSMagic), sizeof(DDSMagic));
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (writeExtension) {
+            out.write(reinterpret_cast<const char*>(&extension), sizeof(extension));
+        }
+        for (const ImageLevel& level : levels) {
+            out.write(reinterpret_cast<const char*>(image.pixels.data() + level.offset), level.size);
+        }
+
+        if (!out) {
+            LOG_ERROR(Texture, "Failed to write DDS file: {}", tempPath);
+            out.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        LOG_ERROR(Texture, "Failed to replace DDS file {}: {}", path, error.message());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "Texture.h"
+#include <cstdint>
+#include <string>
+
+// DirectDraw Surface container, the usual home of block-compressed textures.
+// BC1/BC3 use the legacy FourCC header, BC5/BC7 the DX10 extension header.
+//
+//   "DDS " magic
+//   DDSHeader
+//   DDSHeaderDX10 (only when the pixel format FourCC is "DX10")
+//   mip levels, largest first, tightly packed
+
+struct DDSPixelFormat {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t fourCC;
+    uint32_t rgbBitCount;
+    uint32_t redMask;
+    uint32_t greenMask;
+    uint32_t blueMask;
+    uint32_t alphaMask;
+};
+
+struct DDSHeader {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t height;
+    uint32_t width;
+    uint32_t pitchOrLinearSize;
+    uint32_t depth;
+    uint32_t mipMapCount;
+    uint32_t reserved1[11];
+    DDSPixelFormat pixelFormat;
+    uint32_t caps;
+    uint32_t caps2;
+    uint32_t caps3;
+    uint32_t caps4;
+    uint32_t reserved2;
+};
+
+struct DDSHeaderDX10 {
+    uint32_t dxgiFormat;
+    uint32_t resourceDimension;
+    uint32_t miscFlag;
+    uint32_t arraySize;
+    uint32_t miscFlags2;
+};
+
+class DDSFile {
+public:
+    static bool IsDDS(const unsigned char* data, size_t size);
+
+    // Reads 2D textures in the BC formats and 32-bit uncompressed RGB(A), with their mip chains
+    static bool Read(const unsigned char* data, size_t size, ImageData& image);
+    static bool Write(const std::string& path, const ImageData& image);
+
+    // Fills in everything but the pixels; level offsets are relative to dataOffset
+    static bool ReadHeader(const unsigned char* data, size_t size, ImageData& image, size_t& dataOffset);
+};
@@ -0,0 +1,175 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+// Open-addressing hash map with linear probing. Entries live in one array, so a lookup is a
+// masked hash and a short scan over neighbouring slots, with no allocation and no pointer
+// chasing. Meant for keys whose hash is already well mixed, like ResourceId. Erasing leaves
+// a tombstone, so iterators stay valid across erase() and the erase-while-iterating idiom works.
+// Inserting may rehash, which invalidates iterators and references.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlatHashMap {
+public:
+    using value_type = std::pair<Key, Value>;
+
+private:
+    enum class SlotState : uint8_t { Empty, Full, Deleted };
+
+    std::vector<value_type> _slots;
+    std::vector<SlotState> _states;
+    size_t _size = 0;
+    size_t _tombstones = 0;
+    Hash _hash;
+
+    static constexpr size_t MinCapacity = 16;
+
+    size_t Mask() const { return _slots.size() - 1; }
+
+    // Slot holding the key, or npos
+    size_t FindSlot(const Key& key) const {
+        if (_slots.empty()) return npos;
+        for (size_t i = _hash(key) & Mask();; i = (i + 1) & Mask()) {
+            if (_states[i] == SlotState::Empty) return npos;
+            if (_states[i] == SlotState::Full && _slots[i].first == key) return i;
+        }
+    }
+
+    void Rehash(size_t capacity) {
+        std::vector<value_type> slots(capacity);
+        std::vector<SlotState> states(capacity, SlotState::Empty);
+        for (size_t i = 0; i < _slots.size(); i++) {
+            if (_states[i] != SlotState::Full) continue;
+            size_t j = _hash(_slots[i].first) & (capacity - 1);
+            while (states[j] == SlotState::Full) {
+                j = (j + 1) & (capacity - 1);
+            }
+            slots[j] = std::move(_slots[i]);
+            states[j] = SlotState::Full;
+        }
+        _slots.swap(slots);
+        _states.swap(states);
+        _tombstones = 0;
+    }
+
+    // Slot for a new key; the map has room (load factor kept under 3/4, tombstones included)
+    size_t InsertSlot(const Key& key) {
+        if (_slots.empty()) {
+            Rehash(MinCapacity);
+        }
+        else if ((_size + _tombstones + 1) * 4 > _slots.size() * 3) {
+            Rehash((_size + 1) * 4 > _slots.size() * 2 ? _slots.size() * 2 : _slots.size());
+        }
+
+        size_t i = _hash(key) & Mask();
+        while (_states[i] == SlotState::Full) {
+            i = (i + 1) & Mask();
+        }
+        if (_states[i] == SlotState::Deleted) --_tombstones;
+        _states[i] = SlotState::Full;
+        _slots[i].first = key;
+        ++_size;
+        return i;
+    }
+
+    template <bool IsConst>
+    class Iterator {
+    private:
+        using Map = std::conditional_t<IsConst, const FlatHashMap, FlatHashMap>;
+        Map* _map = nullptr;
+        size_t _index = 0;
+
+        void SkipFree() {
+            while (_index < _map->_slots.size() && _map->_states[_index] != SlotState::Full) ++_index;
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = FlatHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+        using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+
+        Iterator() = default;
+        Iterator(Map* map, size_t index) : _map(map), _index(index) { SkipFree(); }
+        operator Iterator<true>() const { return Iterator<true>(_map, _index); }
+
+        reference operator*() const { return _map->_slots[_index]; }
+        pointer operator->() const { return &_map->_slots[_index]; }
+        Iterator& operator++() { ++_index; SkipFree(); return *this; }
+        Iterator operator++(int) { Iterator previous = *this; ++*this; return previous; }
+        bool operator==(const Iterator& other) const { return _index == other._index; }
+        bool operator!=(const Iterator& other) const { return _index != other._index; }
+        size_t GetIndex() const { return _index; }
+    };
+
+public:
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    static constexpr size_t npos = SIZE_MAX;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, _slots.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, _slots.size()); }
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    iterator find(const Key& key) {
+        size_t i = FindSlot(key);
+        return i == npos ? end() : iterator(this, i);
+    }
+    const_iterator find(const Key& key) const {
+        size_t i = FindSlot(key);
+        return i == npos ? end() : const_iterator(this, i);
+    }
+    size_t count(const Key& key) const { return FindSlot(key) == npos ? 0 : 1; }
+    bool contains(const Key& key) const { return FindSlot(key) != npos; }
+
+    Value& operator[](const Key& key) {
+        size_t i = FindSlot(key);
+        return _slots[i == npos ? InsertSlot(key) : i].second;
+    }
+
+    // Returns the entry and whether it was inserted
+    std::pair<iterator, bool> insert_or_assign(const Key& key, Value value) {
+        size_t i = FindSlot(key);
+        const bool inserted = i == npos;
+        if (inserted) i = InsertSlot(key);
+        _slots[i].second = std::move(value);
+        return { iterator(this, i), inserted };
+    }
+
+    // Returns the iterator after the erased entry
+    iterator erase(iterator it) {
+        const size_t i = it.GetIndex();
+        _states[i] = SlotState::Deleted;
+        _slots[i] = value_type(); // Let go of whatever the value owned
+        --_size;
+        ++_tombstones;
+        return iterator(this, i + 1);
+    }
+    size_t erase(const Key& key) {
+        size_t i = FindSlot(key);
+        if (i == npos) return 0;
+        erase(iterator(this, i));
+        return 1;
+    }
+
+    void clear() {
+        _slots.clear();
+        _states.clear();
+        _size = 0;
+        _tombstones = 0;
+    }
+
+    void reserve(size_t count) {
+        size_t capacity = MinCapacity;
+        while (capacity * 3 < count * 4) capacity *= 2;
+        if (capacity > _slots.size()) Rehash(capacity);
+    }
+};
@@ -8,7 +8,7 @@
 #include <algorithm>
 #include "Renderer.h"
 
-class GameObject {
+class GameObject : public std::enable_shared_from_this<GameObject> {
 private:
     bool _active = true;
     std::string _name;
@@ -63,10 +63,20 @@ public:
         }
         _parent = parent;
         if (_parent) {
-            _parent->_children.push_back(std::shared_ptr<GameObject>(this));
+            // Share ownership with whoever created the object, so the scene list and the hierarchy agree
+            std::shared_ptr<GameObject> self = weak_from_this().lock();
+            _parent->_children.push_back(self ? self : std::shared_ptr<GameObject>(this));
         }
     }
 
+    // Detaches every child at once; they survive only if something else still holds them
+    void ClearChildren() {
+        for (auto& child : _children) {
+            child->_parent = nullptr;
+        }
+        _children.clear();
+    }
+
     // Lifecycle
     virtual void Update() {
         if (!_active) return;
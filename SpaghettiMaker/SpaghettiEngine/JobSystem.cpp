@@ -0,0 +1,120 @@
+#include "JobSystem.h"
+#include "Log.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+JobSystem* JobSystem::s_instance = nullptr;
+
+void JobSystem::Initialize(unsigned int threadCount) {
+    if (!_workers.empty()) return;
+
+    if (threadCount == 0) {
+        unsigned int cores = std::thread::hardware_concurrency();
+        threadCount = std::max(1u, cores > 1 ? cores - 1 : 1u);
+    }
+
+    _stopping = false;
+    _workers.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        _workers.emplace_back(&JobSystem::WorkerLoop, this);
+    }
+
+    LOG_INFO(Jobs, "Job system started with {} workers", threadCount);
+}
+
+void JobSystem::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_workers.empty()) return;
+        _stopping = true;
+    }
+    _condition.notify_all();
+
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+    _workers.clear();
+}
+
+void JobSystem::Schedule(std::function<void()> job) {
+    // Start lazily so code paths that never initialized the system still work
+    if (_workers.empty()) {
+        Initialize();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.push_back(std::move(job));
+    }
+    _condition.notify_one();
+}
+
+void JobSystem::ParallelFor(size_t count, const std::function<void(size_t)>& body) {
+    if (count == 0) return;
+
+    // Shared with helper jobs, which may only start after this call has returned
+    struct ParallelForState {
+        std::atomic<size_t> next{ 0 };
+        std::atomic<size_t> done{ 0 };
+        size_t count = 0;
+        const std::function<void(size_t)>* body = nullptr;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+
+    auto state = std::make_shared<ParallelForState>();
+    state->count = count;
+    state->body = &body;
+
+    auto run = [](ParallelForState& state) {
+        size_t i;
+        while ((i = state.next++) < state.count) {
+            try {
+                (*state.body)(i);
+            }
+            catch (const std::exception& e) {
+                LOG_ERROR(Jobs, "Parallel job failed: {}", e.what());
+            }
+
+            if (++state.done == state.count) {
+                std::lock_guard<std::mutex> lock(state.mutex);
+                state.finished.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min(_workers.size(), count - 1);
+    for (size_t h = 0; h < helpers; ++h) {
+        Schedule([state, run]() { run(*state); });
+    }
+
+    run(*state);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state] { return state->done == state->count; });
+}
+
+void JobSystem::WorkerLoop() {
+    PROFILER->SetThreadName("Job Worker");
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this] { return _stopping || !_jobs.empty(); });
+            if (_jobs.empty()) return; // Stopping and drained
+
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+
+        try {
+            PROFILE_SCOPE("JobSystem::Job");
+            job();
+        }
+        catch (const std::exception& e) {
+            LOG_ERROR(Jobs, "Job failed: {}", e.what());
+        }
+    }
+}
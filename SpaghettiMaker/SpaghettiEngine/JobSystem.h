@@ -0,0 +1,54 @@
+#pragma once
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+// Fixed pool of worker threads for CPU work that must stay off the main thread
+// (parsing, mesh processing, image decoding). Jobs must not touch OpenGL or the
+// scene; hand results back through the UploadQueue instead.
+class JobSystem {
+private:
+    static JobSystem* s_instance;
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _jobs;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping = false;
+
+    // Private constructor for singleton
+    JobSystem() = default;
+    void WorkerLoop();
+
+public:
+    static JobSystem* GetInstance() {
+        if (!s_instance) {
+            s_instance = new JobSystem();
+        }
+        return s_instance;
+    }
+
+    static void Destroy() {
+        delete s_instance;
+        s_instance = nullptr;
+    }
+
+    ~JobSystem() { Shutdown(); }
+
+    // Starts the workers; 0 uses one thread per core, minus the main thread
+    void Initialize(unsigned int threadCount = 0);
+    void Shutdown(); // Finishes queued jobs and joins the workers
+
+    void Schedule(std::function<void()> job);
+
+    // Runs body(i) for every i in [0, count) across the workers and the calling thread,
+    // returning once all iterations finished. Safe to call from inside a job: the caller
+    // keeps taking iterations itself, so it never waits on busy workers for unstarted work.
+    void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    size_t GetWorkerCount() const { return _workers.size(); }
+};
+
+#define JOB_SYSTEM JobSystem::GetInstance()
@@ -0,0 +1,292 @@
+#include "Log.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+Logger* Logger::s_instance = nullptr;
+std::atomic<uint64_t> Logger::s_generation{ 0 };
+
+namespace {
+    // How long the sink sleeps when nothing urgent was logged
+    const std::chrono::milliseconds SinkInterval(10);
+
+    template <typename T>
+    T ReadValue(const unsigned char* data) {
+        T value;
+        std::memcpy(&value, data, sizeof(T));
+        return value;
+    }
+}
+
+Logger::Logger() {
+    _generation = ++s_generation;
+    _sink = std::thread(&Logger::SinkLoop, this);
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(_sinkMutex);
+        _stopping = true;
+    }
+    _wake.notify_one();
+    if (_sink.joinable()) {
+        _sink.join();
+    }
+}
+
+bool Logger::OpenFile(const std::string& path) {
+    std::error_code error;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    std::lock_guard<std::mutex> lock(_sinkMutex);
+    _file.close();
+    _file.open(path, std::ios::trunc);
+    if (!_file) {
+        std::cerr << "Failed to open log file: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Logger::Flush() {
+    std::lock_guard<std::mutex> lock(_sinkMutex);
+    Drain();
+}
+
+void Logger::SetCategoryEnabled(LogCategory category, bool enabled) {
+    const uint32_t bit = 1u << static_cast<uint32_t>(category);
+    if (enabled) {
+        _categories.fetch_or(bit);
+    }
+    else {
+        _categories.fetch_and(~bit);
+    }
+}
+
+Logger::Ring* Logger::GetThreadRing() {
+    // Registered once per thread; a ring outlives its thread and is freed with the logger
+    thread_local uint64_t cachedGeneration = 0;
+    thread_local Ring* cachedRing = nullptr;
+    if (cachedGeneration == _generation) {
+        return cachedRing;
+    }
+
+    std::lock_guard<std::mutex> lock(_ringMutex);
+    _rings.push_back(std::make_unique<Ring>());
+    cachedRing = _rings.back().get();
+    cachedRing->index = static_cast<uint32_t>(_rings.size() - 1);
+    cachedGeneration = _generation;
+    return cachedRing;
+}
+
+LogRecord* Logger::BeginRecord(LogLevel level, LogCategory category, const char* format) {
+    Ring* ring = GetThreadRing();
+    const uint32_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= Ring::Capacity) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        _urgent.store(true, std::memory_order_relaxed);
+        _wake.notify_one();
+        return nullptr;
+    }
+
+    LogRecord* record = &ring->records[head & (Ring::Capacity - 1)];
+    record->format = format;
+    record->time = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - _start).count());
+    record->thread = ring->index;
+    record->level = level;
+    record->category = category;
+    record->size = 0;
+    return record;
+}
+
+void Logger::CommitRecord(LogRecord* record) {
+    Ring* ring = GetThreadRing();
+    ring->head.store(ring->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+
+    // Problems should not sit in the ring until the next tick
+    if (record->level >= LogLevel::Warning) {
+        _urgent.store(true, std::memory_order_relaxed);
+        _wake.notify_one();
+    }
+}
+
+void Logger::SinkLoop() {
+    std::unique_lock<std::mutex> lock(_sinkMutex);
+    while (!_stopping) {
+        _wake.wait_for(lock, SinkInterval, [this]() { return _stopping || _urgent.load(std::memory_order_relaxed); });
+        _urgent.store(false, std::memory_order_relaxed);
+        Drain();
+    }
+    Drain();
+}
+
+void Logger::Drain() {
+    // Called with _sinkMutex held
+    std::vector<Ring*> rings;
+    {
+        std::lock_guard<std::mutex> lock(_ringMutex);
+        for (const auto& ring : _rings) {
+            rings.push_back(ring.get());
+        }
+    }
+
+    std::vector<Entry> entries;
+    for (Ring* ring : rings) {
+        const uint32_t head = ring->head.load(std::memory_order_acquire);
+        uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+        for (; tail != head; ++tail) {
+            const LogRecord& record = ring->records[tail & (Ring::Capacity - 1)];
+            entries.push_back({ record.time, record.level, FormatRecord(record) });
+        }
+        ring->tail.store(tail, std::memory_order_release);
+    }
+
+    const uint64_t dropped = _dropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        entries.push_back({ entries.empty() ? 0 : entries.back().time, LogLevel::Warning,
+            "[Warning] [General] " + std::to_string(dropped) + " log messages dropped, a thread's ring was full" });
+    }
+    if (entries.empty()) return;
+
+    // Each ring is in order already; this interleaves the threads
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+
+    const bool echo = _echoToStdout.load(std::memory_order_relaxed);
+    for (const Entry& entry : entries) {
+        if (_file.is_open()) {
+            char stamp[32];
+            std::snprintf(stamp, sizeof(stamp), "[%10.3f] ", entry.time / 1e9);
+            _file << stamp << entry.line << '\n';
+        }
+        if (echo) {
+            (entry.level >= LogLevel::Warning ? std::cerr : std::cout) << entry.line << '\n';
+        }
+    }
+
+    // One flush per batch instead of one per line
+    if (_file.is_open()) {
+        _file.flush();
+    }
+    if (echo) {
+        std::cout.flush();
+    }
+
+    std::lock_guard<std::mutex> lock(_consoleMutex);
+    for (Entry& entry : entries) {
+        _consoleLines.push_back(std::move(entry.line));
+    }
+    if (_consoleLines.size() > MaxConsoleLines) {
+        _consoleLines.erase(_consoleLines.begin(), _consoleLines.end() - MaxConsoleLines);
+    }
+}
+
+std::string Logger::FormatRecord(const LogRecord& record) {
+    std::string line;
+    line.reserve(64 + record.size);
+    line += '[';
+    line += GetLevelName(record.level);
+    line += "] [";
+    line += GetCategoryName(record.category);
+    line += "] ";
+
+    const unsigned char* argument = record.payload;
+    const unsigned char* end = record.payload + record.size;
+    char buffer[64];
+    for (const char* c = record.format; *c; ++c) {
+        if ((c[0] == '{' && c[1] == '{') || (c[0] == '}' && c[1] == '}')) {
+            line += *c++;
+            continue;
+        }
+        if (c[0] != '{' || c[1] != '}') {
+            line += *c;
+            continue;
+        }
+
+        ++c;
+        if (argument >= end) {
+            line += "{}"; // Fewer arguments than placeholders, or they did not fit
+            continue;
+        }
+
+        const LogDetail::ArgType type = static_cast<LogDetail::ArgType>(*argument++);
+        switch (type) {
+        case LogDetail::ArgType::Int:
+            line += std::to_string(ReadValue<int64_t>(argument));
+            argument += sizeof(int64_t);
+            break;
+        case LogDetail::ArgType::UInt:
+            line += std::to_string(ReadValue<uint64_t>(argument));
+            argument += sizeof(uint64_t);
+            break;
+        case LogDetail::ArgType::Float:
+            // Same as the streams' default precision
+            std::snprintf(buffer, sizeof(buffer), "%g", ReadValue<double>(argument));
+            line += buffer;
+            argument += sizeof(double);
+            break;
+        case LogDetail::ArgType::Bool:
+            line += ReadValue<bool>(argument) ? "true" : "false";
+            argument += sizeof(bool);
+            break;
+        case LogDetail::ArgType::Char:
+            line += ReadValue<char>(argument);
+            argument += sizeof(char);
+            break;
+        case LogDetail::ArgType::String: {
+            const uint16_t length = ReadValue<uint16_t>(argument);
+            argument += sizeof(uint16_t);
+            line.append(reinterpret_cast<const char*>(argument), length);
+            argument += length;
+            break;
+        }
+        case LogDetail::ArgType::Pointer:
+            std::snprintf(buffer, sizeof(buffer), "%p", ReadValue<const void*>(argument));
+            line += buffer;
+            argument += sizeof(const void*);
+            break;
+        }
+    }
+    return line;
+}
+
+void Logger::DrainConsole(const std::function<void(const std::string&)>& sink) {
+    std::vector<std::string> lines;
+    {
+        std::lock_guard<std::mutex> lock(_consoleMutex);
+        lines.swap(_consoleLines);
+    }
+    for (const std::string& line : lines) {
+        sink(line);
+    }
+}
+
+const char* Logger::GetLevelName(LogLevel level) {
+    switch (level) {
+    case LogLevel::Trace: return "Trace";
+    case LogLevel::Debug: return "Debug";
+    case LogLevel::Info: return "Info";
+    case LogLevel::Warning: return "Warning";
+    case LogLevel::Error: return "Error";
+    }
+    return "Unknown";
+}
+
+const char* Logger::GetCategoryName(LogCategory category) {
+    switch (category) {
+    case LogCategory::General: return "General";
+    case LogCategory::Assets: return "Assets";
+    case LogCategory::Mesh: return "Mesh";
+    case LogCategory::Texture: return "Texture";
+    case LogCategory::Material: return "Material";
+    case LogCategory::Scene: return "Scene";
+    case LogCategory::Render: return "Render";
+    case LogCategory::Jobs: return "Jobs";
+    case LogCategory::Count: break;
+    }
+    return "Unknown";
+}
@@ -0,0 +1,271 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+enum class LogLevel : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+enum class LogCategory : uint8_t {
+    General,
+    Assets,
+    Mesh,
+    Texture,
+    Material,
+    Scene,
+    Render,
+    Jobs,
+    Count
+};
+
+// Levels and categories compiled out entirely; their calls and arguments generate no code.
+// Override per configuration, e.g. SPAGHETTI_LOG_MIN_LEVEL=3 for warnings and errors only.
+#ifndef SPAGHETTI_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define SPAGHETTI_LOG_MIN_LEVEL 2 // Info
+#else
+#define SPAGHETTI_LOG_MIN_LEVEL 0 // Trace
+#endif
+#endif
+
+#ifndef SPAGHETTI_LOG_CATEGORIES
+#define SPAGHETTI_LOG_CATEGORIES 0xFFFFFFFFu // Bit per LogCategory
+#endif
+
+namespace LogDetail {
+    // A template, so with a minimum of 0 the comparison (always true, and a warning) is never instantiated
+    template <int MinLevel>
+    constexpr bool IsLevelCompiledIn(LogLevel level) {
+        if constexpr (MinLevel <= 0) {
+            return true;
+        }
+        else {
+            return static_cast<int>(level) >= MinLevel;
+        }
+    }
+
+    constexpr bool IsCompiledIn(LogLevel level, LogCategory category) {
+        return IsLevelCompiledIn<SPAGHETTI_LOG_MIN_LEVEL>(level) &&
+            ((SPAGHETTI_LOG_CATEGORIES >> static_cast<uint32_t>(category)) & 1u) != 0;
+    }
+
+    // Arguments are copied into the record as tagged values and only turned into text on the sink thread
+    enum class ArgType : uint8_t { Int, UInt, Float, Bool, Char, String, Pointer };
+
+    class Encoder {
+    private:
+        unsigned char* _data;
+        size_t _capacity;
+        size_t _size = 0;
+
+    public:
+        Encoder(unsigned char* data, size_t capacity) : _data(data), _capacity(capacity) {}
+
+        void Put(ArgType type, const void* value, size_t size) {
+            if (_size + 1 + size > _capacity) {
+                _size = _capacity; // Out of room: this and later arguments print as {}
+                return;
+            }
+            _data[_size] = static_cast<unsigned char>(type);
+            std::memcpy(_data + _size + 1, value, size);
+            _size += 1 + size;
+        }
+
+        void PutString(std::string_view value) {
+            // Long strings are cut to what fits
+            if (_size + 1 + sizeof(uint16_t) > _capacity) {
+                _size = _capacity;
+                return;
+            }
+            const size_t room = _capacity - _size - 1 - sizeof(uint16_t);
+            const uint16_t length = static_cast<uint16_t>(std::min({ value.size(), room, size_t(0xFFFF) }));
+            _data[_size] = static_cast<unsigned char>(ArgType::String);
+            std::memcpy(_data + _size + 1, &length, sizeof(length));
+            std::memcpy(_data + _size + 1 + sizeof(length), value.data(), length);
+            _size += 1 + sizeof(length) + length;
+        }
+
+        size_t GetSize() const { return _size; }
+    };
+
+    inline void Encode(Encoder& encoder, bool value) { encoder.Put(ArgType::Bool, &value, sizeof(value)); }
+    inline void Encode(Encoder& encoder, char value) { encoder.Put(ArgType::Char, &value, sizeof(value)); }
+    inline void Encode(Encoder& encoder, const char* value) { encoder.PutString(value ? value : "(null)"); }
+    inline void Encode(Encoder& encoder, std::string_view value) { encoder.PutString(value); }
+    inline void Encode(Encoder& encoder, const std::string& value) { encoder.PutString(value); }
+    inline void Encode(Encoder& encoder, const void* value) { encoder.Put(ArgType::Pointer, &value, sizeof(value)); }
+
+    template <typename T>
+    void Encode(Encoder& encoder, T value) requires std::is_arithmetic_v<T> || std::is_enum_v<T> {
+        if constexpr (std::is_enum_v<T>) {
+            Encode(encoder, static_cast<std::underlying_type_t<T>>(value));
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            const double widened = value;
+            encoder.Put(ArgType::Float, &widened, sizeof(widened));
+        }
+        else if constexpr (std::is_signed_v<T>) {
+            const int64_t widened = value;
+            encoder.Put(ArgType::Int, &widened, sizeof(widened));
+        }
+        else {
+            const uint64_t widened = value;
+            encoder.Put(ArgType::UInt, &widened, sizeof(widened));
+        }
+    }
+}
+
+// Fixed-size slot of a thread's ring. The format string is kept by pointer, so it must be a
+// literal; the logging macros only accept literals.
+struct LogRecord {
+    static constexpr size_t Size = 256;
+
+    const char* format;
+    uint64_t time;   // Nanoseconds since the logger started
+    uint32_t thread; // Ring index, stable for the thread's lifetime
+    LogLevel level;
+    LogCategory category;
+    uint16_t size;   // Bytes of payload in use
+    unsigned char payload[Size - 24];
+};
+
+static_assert(sizeof(LogRecord) == LogRecord::Size, "LogRecord must fill its slot exactly");
+
+// Asynchronous, levelled logger. Each thread writes records into a ring of its own without
+// locks or formatting; a background sink drains every ring, formats the messages ({} in the
+// format takes the next argument) and writes them to the log file and stdout. Lines for the
+// editor console are held until the main thread picks them up with DrainConsole.
+// A full ring drops the message and counts it rather than blocking the caller.
+class Logger {
+private:
+    // Single producer (the owning thread), single consumer (the sink)
+    struct Ring {
+        static constexpr uint32_t Capacity = 2048; // Power of two
+        alignas(64) std::atomic<uint32_t> head{ 0 }; // Next slot the thread writes
+        alignas(64) std::atomic<uint32_t> tail{ 0 }; // Next slot the sink reads
+        uint32_t index = 0;
+        LogRecord records[Capacity];
+    };
+
+    struct Entry {
+        uint64_t time;
+        LogLevel level;
+        std::string line;
+    };
+
+    static Logger* s_instance;
+    static std::atomic<uint64_t> s_generation; // Tells threads their cached ring belongs to a destroyed logger
+
+    // Runtime filters, on top of what is compiled in
+    std::atomic<int> _level{ static_cast<int>(LogLevel::Debug) };
+    std::atomic<uint32_t> _categories{ 0xFFFFFFFFu };
+    std::atomic<bool> _echoToStdout{ true };
+
+    std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+    uint64_t _generation = 0;
+
+    std::mutex _ringMutex; // Guards registration only
+    std::vector<std::unique_ptr<Ring>> _rings;
+    std::atomic<uint64_t> _dropped{ 0 };
+
+    // Sink
+    std::thread _sink;
+    std::mutex _sinkMutex;
+    std::condition_variable _wake;
+    bool _stopping = false;
+    std::atomic<bool> _urgent{ false };
+    std::ofstream _file;
+
+    std::mutex _consoleMutex;
+    std::vector<std::string> _consoleLines;
+    static constexpr size_t MaxConsoleLines = 1000; // Oldest lines go first if nobody drains
+
+    Logger();
+
+    Ring* GetThreadRing();
+    LogRecord* BeginRecord(LogLevel level, LogCategory category, const char* format);
+    void CommitRecord(LogRecord* record);
+    void SinkLoop();
+    void Drain();
+    static std::string FormatRecord(const LogRecord& record);
+
+public:
+    static Logger* GetInstance() {
+        if (!s_instance) {
+            s_instance = new Logger();
+        }
+        return s_instance;
+    }
+
+    static void Destroy() {
+        delete s_instance;
+        s_instance = nullptr;
+    }
+
+    ~Logger(); // Drains whatever is left
+
+    // Opens (and truncates) the log file; without one, messages go to stdout and the console only
+    bool OpenFile(const std::string& path);
+    void Flush(); // Drains every ring now and waits for it, e.g. before a crash report
+
+    void SetLevel(LogLevel level) { _level = static_cast<int>(level); }
+    LogLevel GetLevel() const { return static_cast<LogLevel>(_level.load()); }
+    void SetCategoryEnabled(LogCategory category, bool enabled);
+    bool IsCategoryEnabled(LogCategory category) const { return (_categories.load() >> static_cast<uint32_t>(category)) & 1u; }
+    void SetEchoToStdout(bool echo) { _echoToStdout = echo; }
+    bool IsEnabled(LogLevel level, LogCategory category) const {
+        return static_cast<int>(level) >= _level.load(std::memory_order_relaxed) &&
+            ((_categories.load(std::memory_order_relaxed) >> static_cast<uint32_t>(category)) & 1u) != 0;
+    }
+
+    template <size_t N, typename... Args>
+    void Write(LogLevel level, LogCategory category, const char (&format)[N], const Args&... args) {
+        LogRecord* record = BeginRecord(level, category, format);
+        if (!record) return;
+
+        LogDetail::Encoder encoder(record->payload, sizeof(record->payload));
+        (LogDetail::Encode(encoder, args), ...);
+        record->size = static_cast<uint16_t>(encoder.GetSize());
+        CommitRecord(record);
+    }
+
+    // Main thread: hands the lines formatted since the last call to sink, oldest first
+    void DrainConsole(const std::function<void(const std::string&)>& sink);
+
+    uint64_t GetDroppedCount() const { return _dropped.load(); }
+    static const char* GetLevelName(LogLevel level);
+    static const char* GetCategoryName(LogCategory category);
+};
+
+#define LOGGER Logger::GetInstance()
+
+// The format must be a string literal; "{}" takes the next argument
+#define SPAGHETTI_LOG(level, category, ...) \
+    do { \
+        if constexpr (LogDetail::IsCompiledIn(level, category)) { \
+            if (LOGGER->IsEnabled(level, category)) LOGGER->Write(level, category, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_TRACE(category, ...) SPAGHETTI_LOG(LogLevel::Trace, LogCategory::category, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) SPAGHETTI_LOG(LogLevel::Debug, LogCategory::category, __VA_ARGS__)
+#define LOG_INFO(category, ...) SPAGHETTI_LOG(LogLevel::Info, LogCategory::category, __VA_ARGS__)
+#define LOG_WARNING(category, ...) SPAGHETTI_LOG(LogLevel::Warning, LogCategory::category, __VA_ARGS__)
+#define LOG_ERROR(category, ...) SPAGHETTI_LOG(LogLevel::Error, LogCategory::category, __VA_ARGS__)
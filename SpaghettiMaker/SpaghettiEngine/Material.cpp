@@ -0,0 +1,80 @@
+#include "Material.h"
+#include "TextureManager.h"
+#include "AssetDatabase.h"
+#include "Renderer.h"
+#include <GL/glew.h>
+
+Material::Material() {
+    _diffuseMap = TEXTURE_MANAGER->GetDefaultTexture();
+}
+
+void Material::Apply() const {
+    // Material properties
+    float ambient[4] = { static_cast<float>(_ambient.x), static_cast<float>(_ambient.y),
+                        static_cast<float>(_ambient.z), 1.0f };
+    float diffuse[4] = { static_cast<float>(_diffuse.x), static_cast<float>(_diffuse.y),
+                         static_cast<float>(_diffuse.z), 1.0f };
+    float specular[4] = { static_cast<float>(_specular.x), static_cast<float>(_specular.y),
+                          static_cast<float>(_specular.z), 1.0f };
+    float shininess = static_cast<float>(_shininess * 128.0);
+
+    // Set material properties
+    glMaterialfv(GL_FRONT, GL_AMBIENT, ambient);
+    glMaterialfv(GL_FRONT, GL_DIFFUSE, diffuse);
+    glMaterialfv(GL_FRONT, GL_SPECULAR, specular);
+    glMaterialf(GL_FRONT, GL_SHININESS, shininess);
+    RENDERER->CountStateChange();
+
+    // Enable texturing
+    glEnable(GL_TEXTURE_2D);
+    glEnable(GL_COLOR_MATERIAL);
+
+    if (_diffuseMap) {
+        // Setup texture environment
+        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+
+        // Activate texture unit and bind texture
+        glActiveTexture(GL_TEXTURE0);
+        _diffuseMap->Bind(0);
+    }
+}
+
+uint64_t Material::ComputeHash() const {
+    const double values[] = {
+        _ambient.x, _ambient.y, _ambient.z,
+        _diffuse.x, _diffuse.y, _diffuse.z,
+        _specular.x, _specular.y, _specular.z,
+        _shininess, _useCheckerTexture ? 1.0 : 0.0
+    };
+    uint64_t hash = AssetDatabase::HashBytes(values, sizeof(values));
+
+    // The texture object itself, so two paths that resolved to the same texture still match
+    const uintptr_t texture = reinterpret_cast<uintptr_t>(_diffuseMap.get());
+    return AssetDatabase::HashBytes(&texture, sizeof(texture), hash);
+}
+
+bool Material::HasSameParameters(const Material& other) const {
+    return _ambient == other._ambient && _diffuse == other._diffuse && _specular == other._specular &&
+        _shininess == other._shininess && _diffuseMap == other._diffuseMap &&
+        _useCheckerTexture == other._useCheckerTexture;
+}
+
+void Material::SetDiffuseTexture(const TexturePtr& texture, const std::string& path) {
+    _diffuseMap = texture ? texture : TEXTURE_MANAGER->GetDefaultTexture();
+    _texturePath = path;
+    _useCheckerTexture = false;
+}
+
+void Material::SetUseCheckerTexture(bool use) {
+    _useCheckerTexture = use;
+    if (use) {
+        // When enabling checker texture, use the default texture from TextureManager
+        _diffuseMap = TEXTURE_MANAGER->GetDefaultTexture();
+        _texturePath.clear(); // Clear the custom texture path
+    }
+    else if (_texturePath.empty()) {
+        // If disabling checker texture and no custom texture is set,
+        // ensure we still have a valid default texture
+        _diffuseMap = TEXTURE_MANAGER->GetDefaultTexture();
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "Texture.h"
+#include "types.h"
+#include <memory>
+#include <string>
+
+// Surface parameters shared by every MaterialComponent that references them. Treated as
+// immutable once handed out by the MaterialManager: edits go to a copy, which is then
+// interned again, so identical parameters always end up as the same object.
+class Material {
+private:
+    std::string _name;
+
+    // Material properties
+    vec3 _ambient = vec3(0.2);
+    vec3 _diffuse = vec3(0.8);
+    vec3 _specular = vec3(0.0);
+    double _shininess = 0.0;
+
+    // Textures
+    TexturePtr _diffuseMap;
+    std::string _texturePath;
+    bool _useCheckerTexture = false;
+
+public:
+    Material();
+
+    // Binds the fixed-function material state and the diffuse texture
+    void Apply() const;
+
+    // Hash of everything Apply() uses, for deduplication
+    uint64_t ComputeHash() const;
+    bool HasSameParameters(const Material& other) const;
+
+    // Material property setters
+    void SetName(const std::string& name) { _name = name; }
+    void SetAmbient(const vec3& color) { _ambient = color; }
+    void SetDiffuse(const vec3& color) { _diffuse = color; }
+    void SetSpecular(const vec3& color) { _specular = color; }
+    void SetShininess(double value) { _shininess = value; }
+    void SetDiffuseTexture(const TexturePtr& texture, const std::string& path);
+    void SetUseCheckerTexture(bool use);
+
+    // Property getters
+    const std::string& GetName() const { return _name; }
+    const vec3& GetAmbient() const { return _ambient; }
+    const vec3& GetDiffuse() const { return _diffuse; }
+    const vec3& GetSpecular() const { return _specular; }
+    double GetShininess() const { return _shininess; }
+    const TexturePtr& GetDiffuseTexture() const { return _diffuseMap; }
+    const std::string& GetTexturePath() const { return _texturePath; }
+    bool IsUsingCheckerTexture() const { return _useCheckerTexture; }
+};
+
+using MaterialPtr = std::shared_ptr<Material>;
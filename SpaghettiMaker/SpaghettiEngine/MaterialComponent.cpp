@@ -2,173 +2,160 @@
 #include "Component.h"
 #include "Texture.h"
 #include "TextureManager.h"
+#include "MaterialManager.h"
 #include "types.h"
 #include "imgui.h"
 #include <glm/gtc/type_ptr.hpp>
 #include "MaterialComponent.h"
-#include <iostream>
+#include "Log.h"
 
 
 
 
+MaterialComponent::MaterialComponent() : Component("Material") {
+    _material = MATERIAL_MANAGER->GetDefaultMaterial();
+}
+
 void MaterialComponent::OnStart() {
-    // Create shared checker texture if it doesn't exist
-    if (!_diffuseMap) {
-        _diffuseMap = TEXTURE_MANAGER->GetDefaultTexture();
+    if (!_material) {
+        _material = MATERIAL_MANAGER->GetDefaultMaterial();
     }
 }
 
 void MaterialComponent::OnUpdate() {
-    // Material properties
-    float ambient[4] = { static_cast<float>(_ambient.x), static_cast<float>(_ambient.y),
-                        static_cast<float>(_ambient.z), 1.0f };
-    float diffuse[4] = { static_cast<float>(_diffuse.x), static_cast<float>(_diffuse.y),
-                         static_cast<float>(_diffuse.z), 1.0f };
-    float specular[4] = { static_cast<float>(_specular.x), static_cast<float>(_specular.y),
-                          static_cast<float>(_specular.z), 1.0f };
-    float shininess = static_cast<float>(_shininess * 128.0);
-
-    // Set material properties
-    glMaterialfv(GL_FRONT, GL_AMBIENT, ambient);
-    glMaterialfv(GL_FRONT, GL_DIFFUSE, diffuse);
-    glMaterialfv(GL_FRONT, GL_SPECULAR, specular);
-    glMaterialf(GL_FRONT, GL_SHININESS, shininess);
-
-    // Enable texturing
-    glEnable(GL_TEXTURE_2D);
-    glEnable(GL_COLOR_MATERIAL);
-
-    if (_diffuseMap) {
-        // Save current texture binding
-        GLint previousTexture;
-        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
-
-        // Setup texture environment
-        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-
-        // Activate texture unit and bind texture
-        glActiveTexture(GL_TEXTURE0);
-        _diffuseMap->Bind(0);
-
-        static bool firstTime = true;
-        if (firstTime) {
-            std::cout << "Material Debug Info:" << std::endl;
-            std::cout << "- Texture ID: " << _diffuseMap->GetID() << std::endl;
-            std::cout << "- Size: " << _diffuseMap->GetWidth() << "x" << _diffuseMap->GetHeight() << std::endl;
-            std::cout << "- Path: " << _texturePath << std::endl;
-
-            // Verify texture parameters
-            GLint param;
-            glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, &param);
-            std::cout << "- Min Filter: " << param << std::endl;
-            glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, &param);
-            std::cout << "- Mag Filter: " << param << std::endl;
-            glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, &param);
-            std::cout << "- Wrap S: " << param << std::endl;
-            glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, &param);
-            std::cout << "- Wrap T: " << param << std::endl;
-
-            firstTime = false;
-        }
-    }
+    _material->Apply();
+}
+
+void MaterialComponent::SetMaterial(const MaterialPtr& material) {
+    _material = material ? material : MATERIAL_MANAGER->GetDefaultMaterial();
+}
+
+void MaterialComponent::EditMaterial(const std::function<void(Material&)>& edit) {
+    // Edit a copy, then share whatever material already has those parameters
+    Material edited = *_material;
+    edited.SetName("");
+    edit(edited);
+    _material = MATERIAL_MANAGER->AddMaterial(edited);
+}
+
+void MaterialComponent::SetAmbient(const vec3& color) {
+    EditMaterial([&](Material& material) { material.SetAmbient(color); });
+}
+
+void MaterialComponent::SetDiffuse(const vec3& color) {
+    EditMaterial([&](Material& material) { material.SetDiffuse(color); });
+}
+
+void MaterialComponent::SetSpecular(const vec3& color) {
+    EditMaterial([&](Material& material) { material.SetSpecular(color); });
+}
+
+void MaterialComponent::SetShininess(double value) {
+    EditMaterial([&](Material& material) { material.SetShininess(value); });
 }
 
 // Add the missing SetDiffuseTexture implementation
 bool MaterialComponent::SetDiffuseTexture(const std::string& path) {
-    std::cout << "Attempting to set diffuse texture: " << path << std::endl;
+    LOG_DEBUG(Material, "Attempting to set diffuse texture: {}", path);
 
     // Try to load the texture through the TextureManager
     auto newTexture = TEXTURE_MANAGER->LoadTexture(path);
     if (newTexture) {
-        _diffuseMap = newTexture;
-        _texturePath = path;
-        _useCheckerTexture = false; // Disable checker texture when setting a new texture
+        SetDiffuseTexture(newTexture, path);
 
         // Log success
-        std::cout << "Successfully set diffuse texture:" << std::endl;
-        std::cout << " - Path: " << path << std::endl;
-        std::cout << " - Size: " << newTexture->GetWidth() << "x" << newTexture->GetHeight() << std::endl;
-        std::cout << " - Texture ID: " << newTexture->GetID() << std::endl;
+        LOG_INFO(Material, "Set diffuse texture {} ({}x{}, ID {})", path, newTexture->GetWidth(), newTexture->GetHeight(), newTexture->GetID());
 
         return true;
     }
 
     // Log failure
-    std::cerr << "Failed to load texture in MaterialComponent.cpp: " << path << std::endl;
+    LOG_ERROR(Material, "Failed to load texture: {}", path);
     return false;
 }
 
+void MaterialComponent::SetDiffuseTexture(const TexturePtr& texture, const std::string& path) {
+    EditMaterial([&](Material& material) { material.SetDiffuseTexture(texture, path); });
+}
+
 // Add the missing SetUseCheckerTexture implementation
 void MaterialComponent::SetUseCheckerTexture(bool use) {
-    _useCheckerTexture = use;
+    EditMaterial([&](Material& material) { material.SetUseCheckerTexture(use); });
     if (use) {
-        // When enabling checker texture, use the default texture from TextureManager
-        _diffuseMap = TEXTURE_MANAGER->GetDefaultTexture();
-        _texturePath.clear(); // Clear the custom texture path
-
-        std::cout << "Switched to checker texture" << std::endl;
-    }
-    else if (_texturePath.empty()) {
-        // If disabling checker texture and no custom texture is set,
-        // ensure we still have a valid default texture
-        _diffuseMap = TEXTURE_MANAGER->GetDefaultTexture();
+        LOG_DEBUG(Material, "Switched to checker texture");
     }
 }
 
 void MaterialComponent::OnInspectorGUI() {
     if (ImGui::CollapsingHeader("Material Properties")) {
+        // Sharing info: edits below give this object its own material
+        const std::string& name = _material->GetName();
+        ImGui::Text("Material: %s", name.empty() ? "(unnamed)" : name.c_str());
+        ImGui::Text("Shared by %ld objects", MATERIAL_MANAGER->GetUserCount(_material));
+
         // Color properties
-        float ambient[3] = { static_cast<float>(_ambient.x), static_cast<float>(_ambient.y),
-                           static_cast<float>(_ambient.z) };
+        const vec3& currentAmbient = _material->GetAmbient();
+        float ambient[3] = { static_cast<float>(currentAmbient.x), static_cast<float>(currentAmbient.y),
+                           static_cast<float>(currentAmbient.z) };
         if (ImGui::ColorEdit3("Ambient", ambient)) {
-            _ambient = vec3(ambient[0], ambient[1], ambient[2]);
+            SetAmbient(vec3(ambient[0], ambient[1], ambient[2]));
         }
 
-        float diffuse[3] = { static_cast<float>(_diffuse.x), static_cast<float>(_diffuse.y),
-                            static_cast<float>(_diffuse.z) };
+        const vec3& currentDiffuse = _material->GetDiffuse();
+        float diffuse[3] = { static_cast<float>(currentDiffuse.x), static_cast<float>(currentDiffuse.y),
+                            static_cast<float>(currentDiffuse.z) };
         if (ImGui::ColorEdit3("Diffuse", diffuse)) {
-            _diffuse = vec3(diffuse[0], diffuse[1], diffuse[2]);
+            SetDiffuse(vec3(diffuse[0], diffuse[1], diffuse[2]));
         }
 
-        float specular[3] = { static_cast<float>(_specular.x), static_cast<float>(_specular.y),
-                             static_cast<float>(_specular.z) };
+        const vec3& currentSpecular = _material->GetSpecular();
+        float specular[3] = { static_cast<float>(currentSpecular.x), static_cast<float>(currentSpecular.y),
+                             static_cast<float>(currentSpecular.z) };
         if (ImGui::ColorEdit3("Specular", specular)) {
-            _specular = vec3(specular[0], specular[1], specular[2]);
+            SetSpecular(vec3(specular[0], specular[1], specular[2]));
         }
 
-        float shininess = static_cast<float>(_shininess);
+        float shininess = static_cast<float>(_material->GetShininess());
         if (ImGui::SliderFloat("Shininess", &shininess, 0.0f, 1.0f)) {
-            _shininess = static_cast<double>(shininess);
+            SetShininess(static_cast<double>(shininess));
         }
 
         // Texture settings
         ImGui::Separator();
         ImGui::Text("Texture Settings");
 
-        if (_diffuseMap) {
-            ImGui::Text("Current Texture: %s", _texturePath.empty() ? "Default Checker" : _texturePath.c_str());
-            ImGui::Text("Size: %dx%d", _diffuseMap->GetWidth(), _diffuseMap->GetHeight());
+        TexturePtr diffuseMap = _material->GetDiffuseTexture();
+        const std::string& texturePath = _material->GetTexturePath();
+        if (diffuseMap) {
+            ImGui::Text("Current Texture: %s", texturePath.empty() ? "Default Checker" : texturePath.c_str());
+            ImGui::Text("Size: %dx%d", diffuseMap->GetWidth(), diffuseMap->GetHeight());
+            ImGui::Text("Format: %s (%zu KB)", TextureCompressor::GetFormatName(diffuseMap->GetFormat()), diffuseMap->GetGPUBytes() / 1024);
+            if (diffuseMap->IsInAtlas()) {
+                ImGui::Text("Packed in a %dx%d atlas page", diffuseMap->GetAtlasPage()->GetWidth(), diffuseMap->GetAtlasPage()->GetHeight());
+            }
 
             // Texture preview
             ImGui::Separator();
-            ImTextureID texId = reinterpret_cast<ImTextureID>(static_cast<uintptr_t>(_diffuseMap->GetID()));
-            ImGui::Image(texId, ImVec2(100, 100));
+            ImTextureID texId = reinterpret_cast<ImTextureID>(static_cast<uintptr_t>(diffuseMap->GetID()));
+            const fvec2 uv0 = diffuseMap->GetUVOffset();
+            const fvec2 uv1 = uv0 + diffuseMap->GetUVScale();
+            ImGui::Image(texId, ImVec2(100, 100), ImVec2(uv0.x, uv0.y), ImVec2(uv1.x, uv1.y));
         }
         else {
             ImGui::Text("No texture loaded");
         }
 
         // Checker texture toggle
-        bool useChecker = _useCheckerTexture;
+        bool useChecker = _material->IsUsingCheckerTexture();
         if (ImGui::Checkbox("Use Checker Texture", &useChecker)) {
             SetUseCheckerTexture(useChecker);
         }
 
-        ImGui::TextWrapped("Drag and drop PNG/DDS files here to apply texture");
+        ImGui::TextWrapped("Drag and drop PNG/TGA/DDS files here to apply texture");
 
         // Texture removal option
-        if (!_useCheckerTexture && _diffuseMap && !_texturePath.empty() && ImGui::Button("Remove Texture")) {
+        if (!_material->IsUsingCheckerTexture() && diffuseMap && !texturePath.empty() && ImGui::Button("Remove Texture")) {
             SetUseCheckerTexture(true); // Reset to checker texture
         }
     }
-}
\ No newline at end of file
+}
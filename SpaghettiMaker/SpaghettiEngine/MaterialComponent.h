@@ -2,48 +2,48 @@
 #include "Component.h"
 #include "Texture.h"
 #include "TextureManager.h"
+#include "Material.h"
 #include "types.h"
+#include <functional>
 
+// References a shared Material. Setters never modify the shared object: they build the
+// edited parameters and swap in the matching interned material.
 class MaterialComponent : public Component {
 private:
-    // Material properties
-    vec3 _ambient = vec3(0.2);
-    vec3 _diffuse = vec3(0.8);
-    vec3 _specular = vec3(0.0);
-    double _shininess = 0.0;
+    MaterialPtr _material;
 
-    // Textures
-    TexturePtr _diffuseMap;
-    bool _useCheckerTexture = false;
-    std::string _texturePath;
+    void EditMaterial(const std::function<void(Material&)>& edit);
 
 public:
-    MaterialComponent() : Component("Material") {
-        _diffuseMap = TEXTURE_MANAGER->GetDefaultTexture();
-    }
+    MaterialComponent();
 
     // Component interface
     void OnStart() override;
     void OnUpdate() override;
     void OnInspectorGUI() override;
 
+    // Shared material asset
+    void SetMaterial(const MaterialPtr& material);
+    const MaterialPtr& GetMaterial() const { return _material; }
+
     // Material property setters
-    void SetAmbient(const vec3& color) { _ambient = color; }
-    void SetDiffuse(const vec3& color) { _diffuse = color; }
-    void SetSpecular(const vec3& color) { _specular = color; }
-    void SetShininess(double value) { _shininess = value; }
+    void SetAmbient(const vec3& color);
+    void SetDiffuse(const vec3& color);
+    void SetSpecular(const vec3& color);
+    void SetShininess(double value);
 
     // Texture management
     bool SetDiffuseTexture(const std::string& path);
+    void SetDiffuseTexture(const TexturePtr& texture, const std::string& path); // Already loaded elsewhere
     void SetUseCheckerTexture(bool use);
-    bool HasDiffuseTexture() const { return _diffuseMap != nullptr; }
+    bool HasDiffuseTexture() const { return _material->GetDiffuseTexture() != nullptr; }
 
     // Property getters
-    const vec3& GetAmbient() const { return _ambient; }
-    const vec3& GetDiffuse() const { return _diffuse; }
-    const vec3& GetSpecular() const { return _specular; }
-    double GetShininess() const { return _shininess; }
-    TexturePtr GetDiffuseTexture() const { return _diffuseMap; }
-    bool IsUsingCheckerTexture() const { return _useCheckerTexture; }
-    const std::string& GetTexturePath() const { return _texturePath; }
-};
\ No newline at end of file
+    const vec3& GetAmbient() const { return _material->GetAmbient(); }
+    const vec3& GetDiffuse() const { return _material->GetDiffuse(); }
+    const vec3& GetSpecular() const { return _material->GetSpecular(); }
+    double GetShininess() const { return _material->GetShininess(); }
+    TexturePtr GetDiffuseTexture() const { return _material->GetDiffuseTexture(); }
+    bool IsUsingCheckerTexture() const { return _material->IsUsingCheckerTexture(); }
+    const std::string& GetTexturePath() const { return _material->GetTexturePath(); }
+};
@@ -0,0 +1,121 @@
+#include "MaterialManager.h"
+#include "AssetDatabase.h"
+#include <filesystem>
+#include <cstdio>
+
+MaterialManager* MaterialManager::s_instance = nullptr;
+
+void MaterialManager::Cleanup() {
+    _materialCache.clear();
+    _contentIndex.clear();
+    _defaultMaterial = nullptr;
+}
+
+std::string MaterialManager::MakeKey(const std::string& path, unsigned int materialIndex, const std::string& texturePath) {
+    // Like mesh keys, the imported contents of the model and of a custom texture are part of
+    // the key, so a re-import never gets the material built from the previous version
+    AssetRecord record;
+    uint64_t version = ASSET_DATABASE->GetRecord(path, record) ? record.contentHash : 0;
+    std::string key = std::filesystem::path(path).lexically_normal().generic_string();
+    if (!texturePath.empty()) {
+        const uint64_t textureVersion = ASSET_DATABASE->GetRecord(texturePath, record) ? record.contentHash : 0;
+        version = AssetDatabase::HashBytes(&textureVersion, sizeof(textureVersion), version);
+        key += "|" + std::filesystem::path(texturePath).lexically_normal().generic_string();
+    }
+
+    char suffix[48];
+    std::snprintf(suffix, sizeof(suffix), "#material%u@%016llx", materialIndex, static_cast<unsigned long long>(version));
+    return key + suffix;
+}
+
+MaterialPtr MaterialManager::FindByContent(const Material& parameters, uint64_t hash) const {
+    auto it = _contentIndex.find(hash);
+    if (it == _contentIndex.end()) return nullptr;
+
+    MaterialPtr material = it->second.lock();
+    return (material && material->HasSameParameters(parameters)) ? material : nullptr;
+}
+
+MaterialPtr MaterialManager::GetMaterial(const std::string& path, unsigned int materialIndex, const std::string& texturePath) const {
+    auto it = _materialCache.find(MakeKey(path, materialIndex, texturePath));
+    return (it != _materialCache.end()) ? it->second.lock() : nullptr;
+}
+
+MaterialPtr MaterialManager::AddMaterial(const std::string& path, unsigned int materialIndex, const Material& parameters, const std::string& texturePath) {
+    const std::string key = MakeKey(path, materialIndex, texturePath);
+
+    // Every mesh using this material index gets the same object
+    auto it = _materialCache.find(key);
+    if (it != _materialCache.end()) {
+        if (MaterialPtr cached = it->second.lock()) {
+            return cached;
+        }
+    }
+
+    MaterialPtr material = AddMaterial(parameters);
+    if (material->GetName().empty()) {
+        material->SetName(key);
+    }
+    _materialCache[key] = material;
+    return material;
+}
+
+MaterialPtr MaterialManager::AddMaterial(const Material& parameters) {
+    const uint64_t hash = parameters.ComputeHash();
+    if (MaterialPtr existing = FindByContent(parameters, hash)) {
+        return existing;
+    }
+
+    auto material = std::make_shared<Material>(parameters);
+    _contentIndex[hash] = material;
+    return material;
+}
+
+MaterialPtr MaterialManager::GetDefaultMaterial() {
+    if (!_defaultMaterial) {
+        Material parameters;
+        parameters.SetName("Default");
+        _defaultMaterial = AddMaterial(parameters);
+    }
+    return _defaultMaterial;
+}
+
+long MaterialManager::GetUserCount(const MaterialPtr& material) const {
+    if (!material) return 0;
+
+    long references = material.use_count();
+    if (_defaultMaterial == material) {
+        --references;
+    }
+    return references;
+}
+
+void MaterialManager::UnloadUnusedMaterials() {
+    for (auto it = _materialCache.begin(); it != _materialCache.end();) {
+        if (it->second.expired()) {
+            it = _materialCache.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    for (auto it = _contentIndex.begin(); it != _contentIndex.end();) {
+        if (it->second.expired()) {
+            it = _contentIndex.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+size_t MaterialManager::GetLoadedMaterialCount() const {
+    size_t count = 0;
+    for (const auto& [hash, material] : _contentIndex) {
+        if (!material.expired()) {
+            ++count;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "Material.h"
+#include <unordered_map>
+#include <memory>
+#include <string>
+
+// Hands out shared materials. Model materials are keyed by source path, material index and the
+// imported contents, and every material is indexed by a hash of its parameters, so objects that
+// look the same reference the same Material and the render queue can batch them by pointer.
+// The manager holds no strong references but the default material: a material goes with its
+// last user.
+class MaterialManager {
+private:
+    static MaterialManager* s_instance;
+    std::unordered_map<std::string, std::weak_ptr<Material>> _materialCache;
+    std::unordered_map<uint64_t, std::weak_ptr<Material>> _contentIndex;
+    MaterialPtr _defaultMaterial;
+
+    // Private constructor for singleton
+    MaterialManager() = default;
+
+    MaterialPtr FindByContent(const Material& parameters, uint64_t hash) const;
+
+public:
+    static MaterialManager* GetInstance() {
+        if (!s_instance) {
+            s_instance = new MaterialManager();
+        }
+        return s_instance;
+    }
+
+    static void Destroy() {
+        delete s_instance;
+        s_instance = nullptr;
+    }
+
+    void Cleanup();
+
+    // Resource management
+    // texturePath is the texture a model was loaded with in place of its own, empty for none
+    MaterialPtr GetMaterial(const std::string& path, unsigned int materialIndex, const std::string& texturePath = "") const; // nullptr if not loaded
+    MaterialPtr AddMaterial(const std::string& path, unsigned int materialIndex, const Material& parameters, const std::string& texturePath = "");
+    MaterialPtr AddMaterial(const Material& parameters); // Unnamed, lives as long as something references it
+    void UnloadUnusedMaterials(); // Drops the entries of materials nothing uses anymore
+
+    // Shared by every object without a material of its own
+    MaterialPtr GetDefaultMaterial();
+
+    // Number of references to a material from outside the manager
+    long GetUserCount(const MaterialPtr& material) const;
+
+    static std::string MakeKey(const std::string& path, unsigned int materialIndex, const std::string& texturePath = "");
+
+    // Debug/Editor functions
+    size_t GetLoadedMaterialCount() const;
+};
+
+#define MATERIAL_MANAGER MaterialManager::GetInstance()
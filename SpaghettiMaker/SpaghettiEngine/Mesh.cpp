@@ -0,0 +1,280 @@
+#include "Mesh.h"
+#include "ModelLoader.h"
+#include "Log.h"
+#include "Renderer.h"
+#include <GL/glew.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <limits>
+
+VertexFormat Mesh::s_defaultVertexFormat = VertexFormat::Standard;
+MeshResidency Mesh::s_defaultResidency = MeshResidency::Keep;
+
+Mesh::~Mesh() {
+    CleanupMesh();
+}
+
+void Mesh::PackCompactVertices(std::span<const StandardVertex> vertices, std::vector<CompactVertex>& packed) {
+    // Quantize against the mesh bounds
+    _quantization = VertexPacking::ComputeQuantization(_boundsMin, _boundsMax);
+
+    packed.resize(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        const StandardVertex& v = vertices[i];
+        VertexPacking::PackCompact(GetVertexPosition(v), fvec3(v.normal[0], v.normal[1], v.normal[2]),
+            fvec2(v.texCoords[0], v.texCoords[1]), _quantization, packed[i]);
+    }
+}
+
+void Mesh::SetupMesh() {
+    if (_vertices.empty() || _indices.empty()) return;
+
+    UploadBuffers(_vertices, _indices);
+    ApplyResidency();
+}
+
+void Mesh::UploadBuffers(std::span<const StandardVertex> vertices, std::span<const unsigned int> indices) {
+    if (vertices.empty() || indices.empty()) return;
+
+    _vertexCount = vertices.size();
+    _indexCount = indices.size();
+
+    _boundsMin = fvec3(std::numeric_limits<float>::max());
+    _boundsMax = fvec3(-std::numeric_limits<float>::max());
+    for (const auto& vertex : vertices) {
+        _boundsMin = glm::min(_boundsMin, GetVertexPosition(vertex));
+        _boundsMax = glm::max(_boundsMax, GetVertexPosition(vertex));
+    }
+
+    // Create and bind VAO first
+    glGenVertexArrays(1, &_vao);
+    glBindVertexArray(_vao);
+
+    // Create vertex buffer
+    glGenBuffers(1, &_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+
+    // The standard format is uploaded straight from the source memory; only compact needs packing
+    if (_vertexFormat == VertexFormat::Compact) {
+        std::vector<CompactVertex> packed;
+        PackCompactVertices(vertices, packed);
+        _gpuVertexBytes = packed.size() * sizeof(CompactVertex);
+        glBufferData(GL_ARRAY_BUFFER, _gpuVertexBytes, packed.data(), GL_STATIC_DRAW);
+    }
+    else {
+        _quantization = QuantizationInfo();
+        _gpuVertexBytes = vertices.size_bytes();
+        glBufferData(GL_ARRAY_BUFFER, _gpuVertexBytes, vertices.data(), GL_STATIC_DRAW);
+    }
+    RENDERER->CountBufferUpload(_gpuVertexBytes);
+
+    // Create and set up index buffer, using 16-bit indices whenever they can address every vertex
+    glGenBuffers(1, &_ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
+    if (vertices.size() <= 0xFFFF) {
+        std::vector<unsigned short> shortIndices(indices.begin(), indices.end());
+        _indexType = GL_UNSIGNED_SHORT;
+        _gpuIndexBytes = shortIndices.size() * sizeof(unsigned short);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, _gpuIndexBytes, shortIndices.data(), GL_STATIC_DRAW);
+    }
+    else {
+        _indexType = GL_UNSIGNED_INT;
+        _gpuIndexBytes = indices.size_bytes();
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, _gpuIndexBytes, indices.data(), GL_STATIC_DRAW);
+    }
+    RENDERER->CountBufferUpload(_gpuIndexBytes);
+
+    // Set up vertex attributes
+    const VertexLayout layout = VertexLayout::Get(_vertexFormat);
+
+    // Position attribute
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, layout.position.size, layout.position.type, layout.position.normalized, layout.stride, (void*)layout.position.offset);
+
+    // Normal attribute
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, layout.normal.size, layout.normal.type, layout.normal.normalized, layout.stride, (void*)layout.normal.offset);
+
+    // UV attribute
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, layout.texCoords.size, layout.texCoords.type, layout.texCoords.normalized, layout.stride, (void*)layout.texCoords.offset);
+
+    // Unbind VAO to prevent accidental modifications
+    glBindVertexArray(0);
+
+    LOG_DEBUG(Mesh, "Mesh buffers set up: VAO {}, VBO {}, EBO {}, {} vertices, {} indices, {} format, {} GPU bytes",
+        _vao, _vbo, _ebo, vertices.size(), indices.size(), VertexPacking::GetFormatName(_vertexFormat), _gpuVertexBytes + _gpuIndexBytes);
+}
+
+bool Mesh::CanReload() const {
+    return !_sourcePath.empty() && _sourceMeshIndex >= 0;
+}
+
+void Mesh::ApplyResidency() {
+    if (_residency == MeshResidency::Keep) {
+        _compactPositions.clear();
+        _compactPositions.shrink_to_fit();
+        return;
+    }
+
+    if (_vertices.empty()) return;
+
+    std::vector<StandardVertex> vertices = std::move(_vertices);
+    std::vector<unsigned int> indices = std::move(_indices);
+    RetainCPUData(vertices, indices);
+}
+
+void Mesh::RetainCPUData(std::span<const StandardVertex> vertices, std::span<const unsigned int> indices) {
+    _vertices.clear();
+    _indices.clear();
+    _compactPositions.clear();
+
+    // Without a source asset the full copy could never be restored
+    if (_residency == MeshResidency::Keep || !CanReload()) {
+        if (_residency != MeshResidency::Keep) {
+            LOG_WARNING(Mesh, "Mesh has no source asset, keeping CPU data despite residency policy");
+        }
+        _vertices.assign(vertices.begin(), vertices.end());
+        _indices.assign(indices.begin(), indices.end());
+        return;
+    }
+
+    if (_residency == MeshResidency::KeepCompact) {
+        _compactPositions.reserve(vertices.size());
+        for (const auto& vertex : vertices) {
+            _compactPositions.push_back(GetVertexPosition(vertex));
+        }
+        _indices.assign(indices.begin(), indices.end());
+    }
+
+    _vertices.shrink_to_fit();
+    _indices.shrink_to_fit();
+    _compactPositions.shrink_to_fit();
+}
+
+bool Mesh::EnsureCPUData() {
+    if (!_vertices.empty()) return true;
+    if (!CanReload()) return false;
+
+    std::vector<StandardVertex> vertices;
+    std::vector<unsigned int> indices;
+    if (!ModelLoader::LoadMeshData(_sourcePath, static_cast<unsigned int>(_sourceMeshIndex), vertices, indices)) {
+        LOG_ERROR(Mesh, "Failed to reload mesh {} from {}", _sourceMeshIndex, _sourcePath);
+        return false;
+    }
+
+    _vertices = std::move(vertices);
+    _indices = std::move(indices);
+    return true;
+}
+
+size_t Mesh::GetCPUBytes() const {
+    return _vertices.capacity() * sizeof(StandardVertex) +
+        _indices.capacity() * sizeof(unsigned int) +
+        _compactPositions.capacity() * sizeof(fvec3);
+}
+
+void Mesh::SetResidency(MeshResidency residency) {
+    _residency = residency;
+    if (_residency == MeshResidency::Keep) {
+        EnsureCPUData();
+    }
+    if (_vao) {
+        ApplyResidency();
+    }
+}
+
+void Mesh::CleanupMesh() {
+    if (_vao) glDeleteVertexArrays(1, &_vao);
+    if (_vbo) glDeleteBuffers(1, &_vbo);
+    if (_ebo) glDeleteBuffers(1, &_ebo);
+    _vao = _vbo = _ebo = 0;
+    _gpuVertexBytes = _gpuIndexBytes = 0;
+    _vertexCount = _indexCount = 0;
+}
+
+void Mesh::SetVertexFormat(VertexFormat format) {
+    if (_vertexFormat == format) return;
+    _vertexFormat = format;
+
+    // Re-upload if buffers already exist
+    if (_vao) {
+        if (!EnsureCPUData()) {
+            LOG_ERROR(Mesh, "Cannot change vertex format: mesh data is not resident");
+            return;
+        }
+        CleanupMesh();
+        SetupMesh();
+    }
+}
+
+void Mesh::SetData(std::vector<StandardVertex>&& vertices, std::vector<unsigned int>&& indices) {
+    CleanupMesh();
+    _vertices = std::move(vertices);
+    _indices = std::move(indices);
+    SetupMesh();
+}
+
+void Mesh::SetData(std::span<const StandardVertex> vertices, std::span<const unsigned int> indices) {
+    CleanupMesh();
+    UploadBuffers(vertices, indices);
+    RetainCPUData(vertices, indices);
+}
+
+void Mesh::Draw() const {
+    if (!IsUploaded()) return;
+
+    // Use vertex arrays for better performance
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+    // Bind vertex data
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+
+    // Set vertex pointers with the stride and offsets of the uploaded format
+    const VertexLayout layout = VertexLayout::Get(_vertexFormat);
+    glVertexPointer(layout.position.size, layout.position.type, layout.stride, (void*)layout.position.offset);
+    glNormalPointer(layout.normal.type, layout.stride, (void*)layout.normal.offset);
+    glTexCoordPointer(layout.texCoords.size, layout.texCoords.type, layout.stride, (void*)layout.texCoords.offset);
+
+    // Quantized positions are expanded back to the mesh bounds by the modelview matrix
+    glPushMatrix();
+    if (_vertexFormat == VertexFormat::Compact) {
+        glTranslatef(_quantization.offset.x, _quantization.offset.y, _quantization.offset.z);
+        glScalef(_quantization.scale, _quantization.scale, _quantization.scale);
+        glEnable(GL_NORMALIZE);
+    }
+
+    // Draw
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(_indexCount), _indexType, 0);
+    RENDERER->CountDraw(_vertexCount, _indexCount / 3);
+    glPopMatrix();
+
+    // Cleanup state
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void Mesh::DrawNormals(float length) const {
+    // Needs the full CPU copy
+    if (_vertices.empty()) return;
+
+    glDisable(GL_TEXTURE_2D);
+    glDisable(GL_LIGHTING);
+    glColor3f(0.0f, 1.0f, 0.0f);
+
+    glBegin(GL_LINES);
+    for (const auto& vertex : _vertices) {
+        fvec3 start = GetVertexPosition(vertex);
+        fvec3 end = start + fvec3(vertex.normal[0], vertex.normal[1], vertex.normal[2]) * length;
+        glVertex3fv(glm::value_ptr(start));
+        glVertex3fv(glm::value_ptr(end));
+    }
+    glEnd();
+    RENDERER->CountDraw(_vertices.size() * 2, 0);
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include "types.h"
+#include "VertexFormat.h"
+#include <vector>
+#include <memory>
+#include <string>
+#include <span>
+#include <glm/vec2.hpp> // Include GLM vec2
+#include <glm/vec3.hpp> // Include GLM vec3
+
+
+struct Vertex {
+    vec3 position;
+    vec3 normal;
+    vec2 texCoords;
+
+    Vertex(const vec3& pos = vec3(0), const vec3& norm = vec3(0), const vec2& tex = vec2(0))
+        : position(pos), normal(norm), texCoords(tex) {}
+};
+
+inline fvec3 GetVertexPosition(const Vertex& vertex) { return fvec3(vertex.position); }
+
+// Source data is rotated into engine space once, when it is written into the GPU layout
+inline fvec3 ToEngineSpace(const fvec3& v) {
+    return fvec3(v.y, -v.z, -v.x);
+}
+
+// What happens to the CPU copy of a mesh once it has been uploaded
+enum class MeshResidency {
+    Keep,            // Keep the full vertex and index data
+    DropAfterUpload, // Free everything; reloaded from the source asset when needed
+    KeepCompact      // Keep float positions and indices only, for picking and physics
+};
+
+// Geometry and its GL buffers. Shared between every MeshComponent that draws it, so
+// format and residency changes apply to all of them. Owned through MeshPtr, usually
+// handed out by the MeshManager.
+class Mesh {
+private:
+    // CPU copy, already in the standard GPU layout
+    std::vector<StandardVertex> _vertices;
+    std::vector<unsigned int> _indices;
+
+    // OpenGL buffer objects
+    unsigned int _vao = 0; // Vertex Array Object
+    unsigned int _vbo = 0; // Vertex Buffer Object
+    unsigned int _ebo = 0; // Element Buffer Object
+
+    // GPU layout
+    VertexFormat _vertexFormat = s_defaultVertexFormat;
+    QuantizationInfo _quantization;       // Only used by the compact format
+    fvec3 _boundsMin = fvec3(0.0f);       // Bounds of the uploaded positions
+    fvec3 _boundsMax = fvec3(0.0f);
+    unsigned int _indexType = GL_UNSIGNED_INT;
+    size_t _gpuVertexBytes = 0;
+    size_t _gpuIndexBytes = 0;
+
+    static VertexFormat s_defaultVertexFormat;
+
+    // CPU residency
+    MeshResidency _residency = s_defaultResidency;
+    std::vector<fvec3> _compactPositions; // Engine-space positions kept by KeepCompact
+    size_t _vertexCount = 0;              // Counts of the uploaded data, valid after the CPU copy is dropped
+    size_t _indexCount = 0;
+    std::string _sourcePath;              // Asset the mesh can be reloaded from
+    int _sourceMeshIndex = -1;
+
+    static MeshResidency s_defaultResidency;
+
+    std::string _name;
+    uint64_t _contentHash = 0;
+
+    void SetupMesh();
+    void CleanupMesh();
+    void UploadBuffers(std::span<const StandardVertex> vertices, std::span<const unsigned int> indices);
+    void PackCompactVertices(std::span<const StandardVertex> vertices, std::vector<CompactVertex>& packed);
+    void ApplyResidency();
+    void RetainCPUData(std::span<const StandardVertex> vertices, std::span<const unsigned int> indices);
+    bool CanReload() const;
+
+public:
+    Mesh() = default;
+    ~Mesh();
+
+    // GL buffers have a single owner
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+    // Mesh data management
+    void SetData(std::vector<StandardVertex>&& vertices, std::vector<unsigned int>&& indices);   // Takes ownership, no copies
+    void SetData(std::span<const StandardVertex> vertices, std::span<const unsigned int> indices); // Uploads directly, copies only what the residency policy keeps
+
+    // Issues the draw call with the current modelview matrix; the caller sets up material state
+    void Draw() const;
+    void DrawNormals(float length) const;
+
+    // GPU vertex format; changing it re-uploads the buffers
+    void SetVertexFormat(VertexFormat format);
+    VertexFormat GetVertexFormat() const { return _vertexFormat; }
+    static void SetDefaultVertexFormat(VertexFormat format) { s_defaultVertexFormat = format; }
+    static VertexFormat GetDefaultVertexFormat() { return s_defaultVertexFormat; }
+
+    // GPU memory used by this mesh
+    size_t GetGPUVertexBytes() const { return _gpuVertexBytes; }
+    size_t GetGPUIndexBytes() const { return _gpuIndexBytes; }
+    unsigned int GetIndexType() const { return _indexType; }
+
+    // Local-space bounds of the uploaded geometry
+    const fvec3& GetBoundsMin() const { return _boundsMin; }
+    const fvec3& GetBoundsMax() const { return _boundsMax; }
+
+    // CPU copy management
+    void SetResidency(MeshResidency residency);
+    MeshResidency GetResidency() const { return _residency; }
+    static void SetDefaultResidency(MeshResidency residency) { s_defaultResidency = residency; }
+    static MeshResidency GetDefaultResidency() { return s_defaultResidency; }
+    void SetSourceAsset(const std::string& path, int meshIndex) { _sourcePath = path; _sourceMeshIndex = meshIndex; }
+    const std::string& GetSourcePath() const { return _sourcePath; }
+    int GetSourceMeshIndex() const { return _sourceMeshIndex; }
+    bool HasCPUData() const { return !_vertices.empty(); }
+    bool EnsureCPUData(); // Reloads the full copy from the source asset if it was dropped
+    size_t GetCPUBytes() const;
+
+    // Identity used by the MeshManager
+    void SetName(const std::string& name) { _name = name; }
+    const std::string& GetName() const { return _name; }
+    void SetContentHash(uint64_t hash) { _contentHash = hash; }
+    uint64_t GetContentHash() const { return _contentHash; }
+
+    // Getters for mesh data (vertices and indices may be empty depending on the residency policy)
+    const std::vector<StandardVertex>& GetVertices() const { return _vertices; }
+    const std::vector<unsigned int>& GetIndices() const { return _indices; }
+    const std::vector<fvec3>& GetCompactPositions() const { return _compactPositions; }
+    size_t GetVertexCount() const { return _vertexCount; }
+    size_t GetIndexCount() const { return _indexCount; }
+    unsigned int GetVAO() const { return _vao; }
+    bool IsUploaded() const { return _vao != 0 && _indexCount > 0; }
+};
+
+using MeshPtr = std::shared_ptr<Mesh>;
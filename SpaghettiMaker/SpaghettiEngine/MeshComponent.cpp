@@ -1,117 +1,50 @@
 // SpaghettiEngine/Graphics/MeshComponent.cpp
 #include "MeshComponent.h"
+#include "MeshManager.h"
 #include "GameObject.h"
 #include "TransformComponent.h"
 #include <GL/glew.h>
 #include "imgui.h"
 #include <iostream>
 
-MeshComponent::~MeshComponent() {
-    CleanupMesh();
-}
-
 void MeshComponent::OnStart() {
-    SetupMesh();
 }
 
 void MeshComponent::OnDestroy() {
-    CleanupMesh();
+    // The buffers go away with the last component (or the manager) holding the mesh
+    _mesh.reset();
 }
 
-void MeshComponent::SetupMesh() {
-    if (_vertices.empty() || _indices.empty()) return;
-
-    // Create and bind VAO first
-    glGenVertexArrays(1, &_vao);
-    glBindVertexArray(_vao);
-
-    // Create vertex buffer
-    glGenBuffers(1, &_vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-
-    // Calculate stride and prepare vertex data
-    const size_t stride = sizeof(Vertex);
-    std::vector<float> vertexData;
-    vertexData.reserve(_vertices.size() * 8); // 3 pos + 3 normal + 2 uv = 8 floats per vertex
-
-    for (const auto& vertex : _vertices) {
-
-        float rotatedX = vertex.position.y;    // New x after rotation
-        float rotatedY = -vertex.position.z;   // New y after rotation
-        float rotatedZ = -vertex.position.x;   // New z after rotation
-
-        // Position
-        vertexData.push_back(rotatedX);
-        vertexData.push_back(rotatedY);
-        vertexData.push_back(rotatedZ);
-
-        // Normal
-        vertexData.push_back(static_cast<float>(vertex.normal.x));
-        vertexData.push_back(static_cast<float>(vertex.normal.y));
-        vertexData.push_back(static_cast<float>(vertex.normal.z));
-
-        // UV coordinates
-        vertexData.push_back(static_cast<float>(vertex.texCoords.x));
-        vertexData.push_back(static_cast<float>(vertex.texCoords.y));
+void MeshComponent::SetMeshData(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices) {
+    // Legacy double-precision input, converted once into the GPU layout
+    std::vector<StandardVertex> converted(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        VertexPacking::PackStandard(ToEngineSpace(fvec3(vertices[i].position)), ToEngineSpace(fvec3(vertices[i].normal)),
+            fvec2(vertices[i].texCoords), converted[i]);
     }
+    SetMeshData(std::move(converted), std::vector<unsigned int>(indices));
+}
 
-    // Upload vertex data
-    glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_STATIC_DRAW);
-
-    // Create and set up index buffer
-    glGenBuffers(1, &_ebo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, _indices.size() * sizeof(unsigned int), _indices.data(), GL_STATIC_DRAW);
-
-    // Set up vertex attributes
-    // Position attribute
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-
-    // Normal attribute
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-
-    // UV attribute
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-
-    // Unbind VAO to prevent accidental modifications
-    glBindVertexArray(0);
-
-    // Debug output
-    std::cout << "Mesh buffer setup completed:" << std::endl;
-    std::cout << "- VAO: " << _vao << std::endl;
-    std::cout << "- VBO: " << _vbo << std::endl;
-    std::cout << "- EBO: " << _ebo << std::endl;
-    std::cout << "- Vertex count: " << _vertices.size() << std::endl;
-    std::cout << "- Index count: " << _indices.size() << std::endl;
-
-    // Debug first few vertices
-    for (size_t i = 0; i < std::min(_vertices.size(), size_t(5)); ++i) {
-        const auto& v = _vertices[i];
-        std::cout << "Vertex " << i << ":" << std::endl;
-        std::cout << "  Pos: " << v.position.x << ", " << v.position.y << ", " << v.position.z << std::endl;
-        std::cout << "  UV:  " << v.texCoords.x << ", " << v.texCoords.y << std::endl;
-    }
+void MeshComponent::SetMeshData(std::vector<StandardVertex>&& vertices, std::vector<unsigned int>&& indices) {
+    _mesh = MESH_MANAGER->AddMesh(std::move(vertices), std::move(indices));
 }
 
-void MeshComponent::CleanupMesh() {
-    if (_vao) glDeleteVertexArrays(1, &_vao);
-    if (_vbo) glDeleteBuffers(1, &_vbo);
-    if (_ebo) glDeleteBuffers(1, &_ebo);
-    _vao = _vbo = _ebo = 0;
+void MeshComponent::SetMeshData(std::span<const StandardVertex> vertices, std::span<const unsigned int> indices) {
+    _mesh = MESH_MANAGER->AddMesh(vertices, indices);
 }
 
-void MeshComponent::SetMeshData(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices) {
-    CleanupMesh();
-    _vertices = vertices;
-    _indices = indices;
-    SetupMesh();
+const std::vector<StandardVertex>& MeshComponent::GetVertices() const {
+    static const std::vector<StandardVertex> empty;
+    return _mesh ? _mesh->GetVertices() : empty;
+}
+
+const std::vector<unsigned int>& MeshComponent::GetIndices() const {
+    static const std::vector<unsigned int> empty;
+    return _mesh ? _mesh->GetIndices() : empty;
 }
 
 void MeshComponent::OnUpdate() {
-    if (_vao == 0 || _vertices.empty() || _indices.empty()) return;
+    if (!_mesh || !_mesh->IsUploaded()) return;
 
     auto transform = GetOwner()->GetComponent<TransformComponent>();
     if (!transform) return;
@@ -129,58 +62,11 @@ void MeshComponent::OnUpdate() {
     glEnable(GL_LIGHTING);
     glColor4f(1.0f, 1.0f, 1.0f, 1.0f); // Reset color to prevent tinting
 
-    // Use vertex arrays for better performance
-    glEnableClientState(GL_VERTEX_ARRAY);
-    glEnableClientState(GL_NORMAL_ARRAY);
-    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
-    // Bind vertex data
-    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-
-    // Set vertex pointers with correct stride and offsets
-    size_t stride = 8 * sizeof(float); // 3 pos + 3 normal + 2 uv = 8 floats
-    glVertexPointer(3, GL_FLOAT, stride, (void*)0);
-    glNormalPointer(GL_FLOAT, stride, (void*)(3 * sizeof(float)));
-    glTexCoordPointer(2, GL_FLOAT, stride, (void*)(6 * sizeof(float)));
-
-    // Draw
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(_indices.size()), GL_UNSIGNED_INT, 0);
-
-    // Debug texture coordinates
-    static bool firstTime = true;
-    if (firstTime) {
-        std::cout << "Mesh texture coordinates:" << std::endl;
-        for (int i = 0; i < std::min(5, (int)_vertices.size()); i++) {
-            std::cout << "Vertex " << i << " UV: " << _vertices[i].texCoords.x
-                << ", " << _vertices[i].texCoords.y << std::endl;
-        }
-        firstTime = false;
-    }
+    _mesh->Draw();
 
-    // Cleanup state
-    glDisableClientState(GL_VERTEX_ARRAY);
-    glDisableClientState(GL_NORMAL_ARRAY);
-    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-
-    // Draw normals if enabled
+    // Draw normals if enabled (needs the full CPU copy)
     if (_showNormals) {
-        glDisable(GL_TEXTURE_2D);
-        glDisable(GL_LIGHTING);
-        glColor3f(0.0f, 1.0f, 0.0f);
-
-        glBegin(GL_LINES);
-        for (const auto& vertex : _vertices) {
-            vec3 start = vertex.position;
-            vec3 end = start + (vertex.normal * static_cast<double>(_normalLength));
-            glVertex3dv(glm::value_ptr(start));
-            glVertex3dv(glm::value_ptr(end));
-        }
-        glEnd();
+        _mesh->DrawNormals(_normalLength);
     }
 
     // Restore state
@@ -189,15 +75,60 @@ void MeshComponent::OnUpdate() {
 }
 
 void MeshComponent::OnInspectorGUI() {
-    ImGui::Text("Vertices: %zu", _vertices.size());
-    ImGui::Text("Indices: %zu", _indices.size());
-    ImGui::Text("Triangles: %zu", _indices.size() / 3);
+    if (!_mesh) {
+        ImGui::Text("No mesh");
+        return;
+    }
+
+    const size_t vertexCount = _mesh->GetVertexCount();
+    const size_t indexCount = _mesh->GetIndexCount();
+    ImGui::Text("Vertices: %zu", vertexCount);
+    ImGui::Text("Indices: %zu", indexCount);
+    ImGui::Text("Triangles: %zu", indexCount / 3);
+
+    // Everything below belongs to the shared mesh
+    const long users = MESH_MANAGER->GetUserCount(_mesh);
+    if (users > 1) {
+        ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "Shared by %ld objects, changes apply to all", users);
+    }
+
+    // Vertex format and memory
+    int format = static_cast<int>(_mesh->GetVertexFormat());
+    const char* formatNames[] = { VertexPacking::GetFormatName(VertexFormat::Standard), VertexPacking::GetFormatName(VertexFormat::Compact) };
+    if (ImGui::Combo("Vertex Format", &format, formatNames, IM_ARRAYSIZE(formatNames))) {
+        _mesh->SetVertexFormat(static_cast<VertexFormat>(format));
+    }
+
+    // Baseline is the previous fixed layout: 32-byte float vertices and 32-bit indices
+    const size_t baselineBytes = vertexCount * sizeof(StandardVertex) + indexCount * sizeof(unsigned int);
+    const size_t gpuBytes = _mesh->GetGPUVertexBytes() + _mesh->GetGPUIndexBytes();
+    ImGui::Text("Index Type: %s", _mesh->GetIndexType() == GL_UNSIGNED_SHORT ? "16-bit" : "32-bit");
+    ImGui::Text("GPU Vertex Data: %.1f KB", _mesh->GetGPUVertexBytes() / 1024.0f);
+    ImGui::Text("GPU Index Data: %.1f KB", _mesh->GetGPUIndexBytes() / 1024.0f);
+    if (baselineBytes > 0 && gpuBytes > 0) {
+        ImGui::Text("Memory / bandwidth per draw: %.1f KB (%.0f%% saved vs %.1f KB)",
+            gpuBytes / 1024.0f, 100.0f * (1.0f - static_cast<float>(gpuBytes) / baselineBytes), baselineBytes / 1024.0f);
+    }
+
+    // CPU residency
+    int residency = static_cast<int>(_mesh->GetResidency());
+    const char* residencyNames[] = { "Keep", "Drop After Upload", "Keep Compact" };
+    if (ImGui::Combo("CPU Residency", &residency, residencyNames, IM_ARRAYSIZE(residencyNames))) {
+        _mesh->SetResidency(static_cast<MeshResidency>(residency));
+    }
+    ImGui::Text("CPU Data: %.1f KB", _mesh->GetCPUBytes() / 1024.0f);
+    if (!_mesh->GetSourcePath().empty()) {
+        ImGui::TextWrapped("Source: %s (mesh %d)", _mesh->GetSourcePath().c_str(), _mesh->GetSourceMeshIndex());
+    }
 
     if (ImGui::Checkbox("Show Normals", &_showNormals)) {
-        // Normal visualization toggled
+        // Normals are drawn from the full CPU copy
+        if (_showNormals) {
+            _mesh->EnsureCPUData();
+        }
     }
 
     if (_showNormals) {
         ImGui::DragFloat("Normal Length", &_normalLength, 0.01f, 0.01f, 1.0f);
     }
-}
\ No newline at end of file
+}
@@ -1,40 +1,23 @@
 #pragma once
 #include "Component.h"
 #include "types.h"
+#include "Mesh.h"
 #include <vector>
 #include <memory>
-#include <glm/vec2.hpp> // Include GLM vec2
-#include <glm/vec3.hpp> // Include GLM vec3
-
-
-struct Vertex {
-    vec3 position;
-    vec3 normal;
-    vec2 texCoords;
-
-    Vertex(const vec3& pos = vec3(0), const vec3& norm = vec3(0), const vec2& tex = vec2(0))
-        : position(pos), normal(norm), texCoords(tex) {}
-};
+#include <span>
 
+// Draws a shared Mesh with the owner's transform. Any number of components may point
+// at the same Mesh; its GL buffers are released with the last reference.
 class MeshComponent : public Component {
 private:
-    std::vector<Vertex> _vertices;
-    std::vector<unsigned int> _indices;
-
-    // OpenGL buffer objects
-    unsigned int _vao = 0; // Vertex Array Object
-    unsigned int _vbo = 0; // Vertex Buffer Object
-    unsigned int _ebo = 0; // Element Buffer Object
+    MeshPtr _mesh;
 
     bool _showNormals = false;
     float _normalLength = 0.1f; // Length of normal visualization lines
 
-    void SetupMesh();
-    void CleanupMesh();
-
 public:
     MeshComponent() : Component("Mesh") {}
-    ~MeshComponent();
+    ~MeshComponent() = default;
 
     // Component interface
     void OnStart() override;
@@ -42,16 +25,25 @@ public:
     void OnUpdate() override;
     void OnInspectorGUI() override;
 
-    // Mesh data management
-    void SetMeshData(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
+    // Shared mesh resource
+    void SetMesh(const MeshPtr& mesh) { _mesh = mesh; }
+    const MeshPtr& GetMesh() const { return _mesh; }
+
+    // Procedural data, deduplicated by content through the MeshManager
+    void SetMeshData(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices); // Converts from doubles
+    void SetMeshData(std::vector<StandardVertex>&& vertices, std::vector<unsigned int>&& indices);   // Takes ownership, no copies
+    void SetMeshData(std::span<const StandardVertex> vertices, std::span<const unsigned int> indices); // Copies only if the geometry is new
 
     // Debug visualization
     void SetShowNormals(bool show) { _showNormals = show; }
     bool GetShowNormals() const { return _showNormals; }
     void SetNormalLength(float length) { _normalLength = length; }
-
-    // Getters for mesh data
-    const std::vector<Vertex>& GetVertices() const { return _vertices; }
-    const std::vector<unsigned int>& GetIndices() const { return _indices; }
-    unsigned int GetVAO() const { return _vao; }
-};
\ No newline at end of file
+    float GetNormalLength() const { return _normalLength; }
+
+    // Forwarded to the shared mesh
+    const std::vector<StandardVertex>& GetVertices() const;
+    const std::vector<unsigned int>& GetIndices() const;
+    size_t GetVertexCount() const { return _mesh ? _mesh->GetVertexCount() : 0; }
+    size_t GetIndexCount() const { return _mesh ? _mesh->GetIndexCount() : 0; }
+    unsigned int GetVAO() const { return _mesh ? _mesh->GetVAO() : 0; }
+};
@@ -0,0 +1,191 @@
+#include "MeshManager.h"
+#include "Log.h"
+#include "AssetDatabase.h"
+#include "imgui.h"
+#include <filesystem>
+#include <unordered_set>
+#include <cstring>
+#include <cstdio>
+
+MeshManager* MeshManager::s_instance = nullptr;
+
+void MeshManager::Cleanup() {
+    _meshCache.clear();
+    _contentIndex.clear();
+}
+
+std::string MeshManager::MakeKey(const std::string& path, unsigned int meshIndex) {
+    // The contents the source was last imported with are part of the key, so a model re-cooked
+    // after an edit never gets the geometry cached for its previous version
+    AssetRecord record;
+    const uint64_t version = ASSET_DATABASE->GetRecord(path, record) ? record.contentHash : 0;
+
+    char suffix[48];
+    std::snprintf(suffix, sizeof(suffix), "#%u@%016llx", meshIndex, static_cast<unsigned long long>(version));
+    return std::filesystem::path(path).lexically_normal().generic_string() + suffix;
+}
+
+uint64_t MeshManager::HashContent(std::span<const StandardVertex> vertices, std::span<const unsigned int> indices) {
+    uint64_t hash = AssetDatabase::HashBytes(vertices.data(), vertices.size_bytes());
+    return AssetDatabase::HashBytes(indices.data(), indices.size_bytes(), hash);
+}
+
+MeshPtr MeshManager::FindByContent(uint64_t hash, std::span<const StandardVertex> vertices, std::span<const unsigned int> indices) const {
+    auto it = _contentIndex.find(hash);
+    if (it == _contentIndex.end()) return nullptr;
+
+    MeshPtr mesh = it->second.lock();
+    if (!mesh || mesh->GetVertexCount() != vertices.size() || mesh->GetIndexCount() != indices.size()) {
+        return nullptr;
+    }
+
+    // Compare the bytes when the resident copy allows it, otherwise trust the hash and counts
+    if (mesh->HasCPUData() &&
+        (std::memcmp(mesh->GetVertices().data(), vertices.data(), vertices.size_bytes()) != 0 ||
+         std::memcmp(mesh->GetIndices().data(), indices.data(), indices.size_bytes()) != 0)) {
+        return nullptr;
+    }
+    return mesh;
+}
+
+MeshPtr MeshManager::Register(const std::string& key, const MeshPtr& mesh) {
+    _meshCache[key] = mesh;
+    _contentIndex[mesh->GetContentHash()] = mesh;
+    return mesh;
+}
+
+MeshPtr MeshManager::GetMesh(const std::string& path, unsigned int meshIndex) const {
+    auto it = _meshCache.find(MakeKey(path, meshIndex));
+    return (it != _meshCache.end()) ? it->second.lock() : nullptr;
+}
+
+MeshPtr MeshManager::AddMesh(const std::string& path, unsigned int meshIndex, std::span<const StandardVertex> vertices,
+    std::span<const unsigned int> indices, const std::string& name) {
+    const std::string key = MakeKey(path, meshIndex);
+
+    // Already uploaded for another instance of this node or model
+    auto it = _meshCache.find(key);
+    if (it != _meshCache.end()) {
+        if (MeshPtr mesh = it->second.lock()) {
+            return mesh;
+        }
+    }
+
+    // The same geometry under another name (a copied asset, a duplicated mesh)
+    const uint64_t hash = HashContent(vertices, indices);
+    if (MeshPtr existing = FindByContent(hash, vertices, indices)) {
+        LOG_DEBUG(Mesh, "Mesh {} shares its geometry with {}", key, existing->GetName());
+        _meshCache[key] = existing;
+        return existing;
+    }
+
+    auto mesh = std::make_shared<Mesh>();
+    mesh->SetName(name.empty() ? key : name);
+    mesh->SetContentHash(hash);
+    mesh->SetSourceAsset(path, static_cast<int>(meshIndex));
+    mesh->SetData(vertices, indices);
+    return Register(key, mesh);
+}
+
+MeshPtr MeshManager::AddMesh(std::span<const StandardVertex> vertices, std::span<const unsigned int> indices) {
+    const uint64_t hash = HashContent(vertices, indices);
+    if (MeshPtr existing = FindByContent(hash, vertices, indices)) {
+        return existing;
+    }
+
+    return AddMesh(std::vector<StandardVertex>(vertices.begin(), vertices.end()),
+        std::vector<unsigned int>(indices.begin(), indices.end()));
+}
+
+MeshPtr MeshManager::AddMesh(std::vector<StandardVertex>&& vertices, std::vector<unsigned int>&& indices) {
+    const uint64_t hash = HashContent(vertices, indices);
+    if (MeshPtr existing = FindByContent(hash, vertices, indices)) {
+        return existing;
+    }
+
+    char key[32];
+    std::snprintf(key, sizeof(key), "#%016llx", static_cast<unsigned long long>(hash));
+
+    auto mesh = std::make_shared<Mesh>();
+    mesh->SetName(key);
+    mesh->SetContentHash(hash);
+    mesh->SetData(std::move(vertices), std::move(indices));
+    return Register(key, mesh);
+}
+
+long MeshManager::GetUserCount(const MeshPtr& mesh) const {
+    return mesh ? mesh.use_count() : 0;
+}
+
+void MeshManager::UnloadUnusedMeshes() {
+    // The meshes themselves were freed with their last user; this only trims the maps
+    for (auto it = _meshCache.begin(); it != _meshCache.end();) {
+        if (it->second.expired()) {
+            it = _meshCache.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    for (auto it = _contentIndex.begin(); it != _contentIndex.end();) {
+        if (it->second.expired()) {
+            it = _contentIndex.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+size_t MeshManager::GetLoadedMeshCount() const {
+    std::unordered_set<const Mesh*> unique;
+    for (const auto& [key, cached] : _meshCache) {
+        if (MeshPtr mesh = cached.lock()) {
+            unique.insert(mesh.get());
+        }
+    }
+    return unique.size();
+}
+
+size_t MeshManager::GetGPUBytes() const {
+    std::unordered_set<const Mesh*> counted;
+    size_t bytes = 0;
+    for (const auto& [key, cached] : _meshCache) {
+        MeshPtr mesh = cached.lock();
+        if (mesh && counted.insert(mesh.get()).second) {
+            bytes += mesh->GetGPUVertexBytes() + mesh->GetGPUIndexBytes();
+        }
+    }
+    return bytes;
+}
+
+void MeshManager::OnImGuiRender() {
+    if (ImGui::Begin("Mesh Manager")) {
+        ImGui::Text("Loaded Meshes: %zu (%zu keys)", GetLoadedMeshCount(), _meshCache.size());
+        ImGui::Text("GPU Memory: %.1f KB", GetGPUBytes() / 1024.0f);
+
+        if (ImGui::Button("Remove Expired Entries")) {
+            UnloadUnusedMeshes();
+        }
+
+        ImGui::Separator();
+
+        for (const auto& [key, cached] : _meshCache) {
+            MeshPtr mesh = cached.lock();
+            if (!mesh) continue;
+            ImGui::PushID(key.c_str());
+
+            if (ImGui::TreeNode(key.c_str())) {
+                ImGui::Text("Name: %s", mesh->GetName().c_str());
+                ImGui::Text("Vertices: %zu, Indices: %zu", mesh->GetVertexCount(), mesh->GetIndexCount());
+                ImGui::Text("GPU Data: %.1f KB", (mesh->GetGPUVertexBytes() + mesh->GetGPUIndexBytes()) / 1024.0f);
+                ImGui::Text("Users: %ld", GetUserCount(mesh) - 1); // Not counting the lock above
+                ImGui::TreePop();
+            }
+
+            ImGui::PopID();
+        }
+    }
+    ImGui::End();
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "Mesh.h"
+#include <unordered_map>
+#include <memory>
+#include <string>
+#include <span>
+
+// Caches uploaded meshes so identical geometry lives on the GPU once. Model meshes are
+// keyed by source path and mesh index; every mesh is also indexed by a hash of its
+// contents, which catches primitives and the same geometry reached through another file.
+// The cache only observes: a mesh and its GPU buffers go away with the last user.
+class MeshManager {
+private:
+    static MeshManager* s_instance;
+    std::unordered_map<std::string, std::weak_ptr<Mesh>> _meshCache;
+    std::unordered_map<uint64_t, std::weak_ptr<Mesh>> _contentIndex;
+
+    // Private constructor for singleton
+    MeshManager() = default;
+
+    MeshPtr FindByContent(uint64_t hash, std::span<const StandardVertex> vertices, std::span<const unsigned int> indices) const;
+    MeshPtr Register(const std::string& key, const MeshPtr& mesh);
+
+public:
+    static MeshManager* GetInstance() {
+        if (!s_instance) {
+            s_instance = new MeshManager();
+        }
+        return s_instance;
+    }
+
+    static void Destroy() {
+        delete s_instance;
+        s_instance = nullptr;
+    }
+
+    void Cleanup();
+
+    // Resource management
+    MeshPtr GetMesh(const std::string& path, unsigned int meshIndex) const; // nullptr if not loaded
+    MeshPtr AddMesh(const std::string& path, unsigned int meshIndex, std::span<const StandardVertex> vertices,
+        std::span<const unsigned int> indices, const std::string& name = "");
+    MeshPtr AddMesh(std::span<const StandardVertex> vertices, std::span<const unsigned int> indices); // Procedural, copied only if new
+    MeshPtr AddMesh(std::vector<StandardVertex>&& vertices, std::vector<unsigned int>&& indices);   // Procedural, takes ownership
+    void UnloadUnusedMeshes(); // Drops the entries of meshes that are already gone
+
+    // Number of references to a mesh, the caller's included
+    long GetUserCount(const MeshPtr& mesh) const;
+
+    static std::string MakeKey(const std::string& path, unsigned int meshIndex); // Includes the source's imported content hash
+    static uint64_t HashContent(std::span<const StandardVertex> vertices, std::span<const unsigned int> indices);
+
+    // Debug/Editor functions
+    void OnImGuiRender(); // Display loaded meshes in editor
+    size_t GetLoadedMeshCount() const;
+    size_t GetGPUBytes() const;
+};
+
+#define MESH_MANAGER MeshManager::GetInstance()
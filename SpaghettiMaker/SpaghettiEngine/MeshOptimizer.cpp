@@ -0,0 +1,352 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+    // Forsyth scoring constants, as published in "Linear-Speed Vertex Cache Optimisation"
+    const float CacheDecayPower = 1.5f;
+    const float LastTriScore = 0.75f;
+    const float ValenceBoostScale = 2.0f;
+    const float ValenceBoostPower = 0.5f;
+
+    float ComputeVertexScore(int cachePosition, unsigned int remainingTriangles) {
+        // No triangles left to draw, the vertex should never be chosen again
+        if (remainingTriangles == 0) return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            if (cachePosition < 3) {
+                // Used by the last triangle; fixed score so we don't favour re-using it immediately
+                score = LastTriScore;
+            }
+            else {
+                const float scaler = 1.0f / (MeshOptimizer::CacheSize - 3);
+                score = 1.0f - (cachePosition - 3) * scaler;
+                score = std::pow(score, CacheDecayPower);
+            }
+        }
+
+        // Boost vertices with few triangles left so that lone triangles are not left behind
+        score += ValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -ValenceBoostPower);
+        return score;
+    }
+
+    uint64_t HashBytes(const unsigned char* data, size_t size) {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= data[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // Simulated FIFO cache; a vertex is resident while fewer than cacheSize misses happened since it was loaded
+    struct FifoCache {
+        std::vector<unsigned int> timestamps;
+        unsigned int time;
+        unsigned int size;
+
+        FifoCache(size_t vertexCount, unsigned int cacheSize)
+            : timestamps(vertexCount, 0), time(cacheSize + 1), size(cacheSize) {}
+
+        // Returns true on a miss
+        bool Access(unsigned int vertex) {
+            if (time - timestamps[vertex] > size) {
+                timestamps[vertex] = time++;
+                return true;
+            }
+            return false;
+        }
+
+        void Flush() { time += size + 1; }
+    };
+}
+
+size_t MeshOptimizer::GenerateWeldRemap(const void* vertices, size_t vertexCount, size_t vertexStride, std::vector<unsigned int>& remap) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(vertices);
+    remap.assign(vertexCount, ~0u);
+
+    // Open addressing table of first occurrences, kept at most half full
+    size_t tableSize = 16;
+    while (tableSize < vertexCount * 2) tableSize *= 2;
+    std::vector<unsigned int> table(tableSize, ~0u);
+
+    size_t uniqueCount = 0;
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const unsigned char* vertex = bytes + i * vertexStride;
+        size_t slot = static_cast<size_t>(HashBytes(vertex, vertexStride)) & (tableSize - 1);
+
+        while (true) {
+            unsigned int existing = table[slot];
+            if (existing == ~0u) {
+                table[slot] = static_cast<unsigned int>(i);
+                remap[i] = static_cast<unsigned int>(uniqueCount++);
+                break;
+            }
+            if (std::memcmp(bytes + existing * vertexStride, vertex, vertexStride) == 0) {
+                remap[i] = remap[existing];
+                break;
+            }
+            slot = (slot + 1) & (tableSize - 1);
+        }
+    }
+
+    return uniqueCount;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0) return;
+
+    // Build vertex -> triangle adjacency
+    std::vector<unsigned int> remaining(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        remaining[indices[i]]++;
+    }
+
+    std::vector<unsigned int> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] = offsets[v] + remaining[v];
+    }
+
+    std::vector<unsigned int> adjacency(triangleCount * 3);
+    std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            adjacency[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+        }
+    }
+
+    // Initial scores
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        vertexScore[v] = ComputeVertexScore(-1, remaining[v]);
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+
+    std::vector<unsigned int> output;
+    output.reserve(triangleCount * 3);
+
+    std::vector<unsigned int> cache;
+    std::vector<unsigned int> newCache;
+    cache.reserve(CacheSize + 3);
+    newCache.reserve(CacheSize + 3);
+
+    long long bestTriangle = -1;
+    size_t cursor = 0;
+
+    for (size_t step = 0; step < triangleCount; ++step) {
+        if (bestTriangle < 0) {
+            // Nothing adjacent to the cache is left; continue with the next triangle in input order
+            while (emitted[cursor]) ++cursor;
+            bestTriangle = static_cast<long long>(cursor);
+        }
+
+        const size_t t = static_cast<size_t>(bestTriangle);
+        const unsigned int a = indices[t * 3];
+        const unsigned int b = indices[t * 3 + 1];
+        const unsigned int c = indices[t * 3 + 2];
+
+        emitted[t] = true;
+        output.push_back(a);
+        output.push_back(b);
+        output.push_back(c);
+
+        // Remove the triangle from the active adjacency of its vertices
+        for (unsigned int v : { a, b, c }) {
+            unsigned int* begin = adjacency.data() + offsets[v];
+            unsigned int* end = begin + remaining[v];
+            unsigned int* found = std::find(begin, end, static_cast<unsigned int>(t));
+            if (found != end) {
+                std::swap(*found, *(end - 1));
+                remaining[v]--;
+            }
+        }
+
+        // New cache: the triangle's vertices first, then the previous contents
+        newCache.clear();
+        for (unsigned int v : { a, b, c }) {
+            if (std::find(newCache.begin(), newCache.end(), v) == newCache.end()) {
+                newCache.push_back(v);
+            }
+        }
+        for (unsigned int v : cache) {
+            if (v != a && v != b && v != c) {
+                newCache.push_back(v);
+            }
+        }
+
+        // Update positions and scores, including the vertices being evicted
+        for (size_t i = 0; i < newCache.size(); ++i) {
+            unsigned int v = newCache[i];
+            cachePosition[v] = (i < CacheSize) ? static_cast<int>(i) : -1;
+            vertexScore[v] = ComputeVertexScore(cachePosition[v], remaining[v]);
+        }
+
+        // Re-score triangles touching the cache and pick the best one for the next step
+        bestTriangle = -1;
+        float bestScore = -1.0f;
+        for (unsigned int v : newCache) {
+            for (unsigned int i = offsets[v]; i < offsets[v] + remaining[v]; ++i) {
+                unsigned int tri = adjacency[i];
+                float score = vertexScore[indices[tri * 3]] + vertexScore[indices[tri * 3 + 1]] + vertexScore[indices[tri * 3 + 2]];
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = tri;
+                }
+            }
+        }
+
+        if (newCache.size() > CacheSize) {
+            newCache.resize(CacheSize);
+        }
+        cache.swap(newCache);
+    }
+
+    indices.swap(output);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<fvec3>& positions, float threshold) {
+    const size_t triangleCount = indices.size() / 3;
+    const size_t vertexCount = positions.size();
+    if (triangleCount < 2 || vertexCount == 0) return;
+
+    // Hard boundaries: triangles that miss on every vertex start from a cold cache anyway
+    std::vector<unsigned int> hardClusters;
+    {
+        FifoCache cache(vertexCount, CacheSize);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            int misses = 0;
+            for (int k = 0; k < 3; ++k) {
+                misses += cache.Access(indices[t * 3 + k]) ? 1 : 0;
+            }
+            if (t == 0 || misses == 3) {
+                hardClusters.push_back(static_cast<unsigned int>(t));
+            }
+        }
+    }
+    hardClusters.push_back(static_cast<unsigned int>(triangleCount));
+
+    // Soft boundaries: split hard clusters wherever the prefix ACMR stays within the threshold
+    std::vector<unsigned int> clusters;
+    {
+        FifoCache cache(vertexCount, CacheSize);
+        for (size_t h = 0; h + 1 < hardClusters.size(); ++h) {
+            const size_t start = hardClusters[h];
+            const size_t end = hardClusters[h + 1];
+
+            cache.Flush();
+            size_t hardMisses = 0;
+            for (size_t t = start; t < end; ++t) {
+                for (int k = 0; k < 3; ++k) {
+                    hardMisses += cache.Access(indices[t * 3 + k]) ? 1 : 0;
+                }
+            }
+            const float hardAcmr = static_cast<float>(hardMisses) / static_cast<float>(end - start);
+
+            cache.Flush();
+            clusters.push_back(static_cast<unsigned int>(start));
+            size_t clusterStart = start;
+            size_t clusterMisses = 0;
+            for (size_t t = start; t < end; ++t) {
+                for (int k = 0; k < 3; ++k) {
+                    clusterMisses += cache.Access(indices[t * 3 + k]) ? 1 : 0;
+                }
+
+                const float acmr = static_cast<float>(clusterMisses) / static_cast<float>(t + 1 - clusterStart);
+                if (t + 1 < end && acmr <= hardAcmr * threshold) {
+                    clusterStart = t + 1;
+                    clusterMisses = 0;
+                    clusters.push_back(static_cast<unsigned int>(clusterStart));
+                    cache.Flush();
+                }
+            }
+        }
+    }
+    clusters.push_back(static_cast<unsigned int>(triangleCount));
+
+    const size_t clusterCount = clusters.size() - 1;
+
+    // Mesh centroid
+    fvec3 meshCentroid(0.0f);
+    for (const auto& p : positions) {
+        meshCentroid += p;
+    }
+    meshCentroid /= static_cast<float>(vertexCount);
+
+    // Sort key: how far the cluster faces outwards from the mesh centre
+    std::vector<float> sortKey(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        fvec3 centroid(0.0f);
+        fvec3 normal(0.0f);
+        float area = 0.0f;
+
+        for (size_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+            const fvec3& p0 = positions[indices[t * 3]];
+            const fvec3& p1 = positions[indices[t * 3 + 1]];
+            const fvec3& p2 = positions[indices[t * 3 + 2]];
+
+            fvec3 n = glm::cross(p1 - p0, p2 - p0);
+            float triangleArea = glm::length(n);
+
+            centroid += (p0 + p1 + p2) * (triangleArea / 3.0f);
+            normal += n;
+            area += triangleArea;
+        }
+
+        float normalLength = glm::length(normal);
+        if (area > 0.0f && normalLength > 0.0f) {
+            centroid /= area;
+            sortKey[c] = glm::dot(centroid - meshCentroid, normal / normalLength);
+        }
+        else {
+            sortKey[c] = 0.0f;
+        }
+    }
+
+    std::vector<unsigned int> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) order[c] = static_cast<unsigned int>(c);
+    std::stable_sort(order.begin(), order.end(), [&sortKey](unsigned int lhs, unsigned int rhs) {
+        return sortKey[lhs] > sortKey[rhs];
+    });
+
+    std::vector<unsigned int> output;
+    output.reserve(indices.size());
+    for (unsigned int c : order) {
+        output.insert(output.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+    }
+    indices.swap(output);
+}
+
+size_t MeshOptimizer::GenerateFetchRemap(const std::vector<unsigned int>& indices, size_t vertexCount, std::vector<unsigned int>& remap) {
+    remap.assign(vertexCount, ~0u);
+
+    unsigned int next = 0;
+    for (unsigned int index : indices) {
+        if (remap[index] == ~0u) {
+            remap[index] = next++;
+        }
+    }
+    return next;
+}
+
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize) {
+    VertexCacheStats stats;
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0) return stats;
+
+    FifoCache cache(vertexCount, cacheSize);
+    size_t misses = 0;
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        misses += cache.Access(indices[i]) ? 1 : 0;
+    }
+
+    stats.acmr = static_cast<double>(misses) / static_cast<double>(triangleCount);
+    stats.atvr = static_cast<double>(misses) / static_cast<double>(vertexCount);
+    return stats;
+}
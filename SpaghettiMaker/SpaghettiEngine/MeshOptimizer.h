@@ -0,0 +1,95 @@
+#pragma once
+#include "types.h"
+#include <vector>
+#include <cstddef>
+
+// Post-transform cache statistics for an index buffer
+struct VertexCacheStats {
+    double acmr = 0.0; // Average cache miss ratio: transformed vertices per triangle (0.5 - 3.0)
+    double atvr = 0.0; // Average transformed vertex ratio: transformed vertices per unique vertex (1.0 is optimal)
+};
+
+// Result of a full optimisation pass, used for import logging
+struct MeshOptimizationReport {
+    VertexCacheStats before;
+    VertexCacheStats after;
+    size_t verticesBefore = 0;
+    size_t verticesAfter = 0;
+};
+
+// Import-time mesh optimisation stages, in the order they should run:
+// weld -> vertex cache (Forsyth) -> overdraw (cluster sort) -> vertex fetch
+class MeshOptimizer {
+public:
+    static const unsigned int CacheSize = 32;
+
+    // Builds a remap table that merges bitwise identical vertices. Returns the unique vertex count.
+    static size_t GenerateWeldRemap(const void* vertices, size_t vertexCount, size_t vertexStride, std::vector<unsigned int>& remap);
+
+    // Reorders triangles for the post-transform vertex cache (Tom Forsyth's linear-speed algorithm)
+    static void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+    // Reorders cache-friendly clusters of triangles front-to-back from the outside in, so that
+    // from most view directions the closer surfaces are drawn first. A threshold of 1.05 allows
+    // the ACMR to degrade by at most 5% in exchange for finer clusters.
+    static void OptimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<fvec3>& positions, float threshold = 1.05f);
+
+    // Builds a remap table that orders vertices by first use in the index buffer. Unreferenced
+    // vertices are dropped. Returns the referenced vertex count.
+    static size_t GenerateFetchRemap(const std::vector<unsigned int>& indices, size_t vertexCount, std::vector<unsigned int>& remap);
+
+    // Simulates a FIFO post-transform cache of the given size
+    static VertexCacheStats AnalyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize = CacheSize);
+
+    // Applies a remap table to both buffers. Entries equal to ~0u are discarded.
+    template<typename V>
+    static void RemapBuffers(std::vector<V>& vertices, std::vector<unsigned int>& indices, const std::vector<unsigned int>& remap, size_t newVertexCount) {
+        std::vector<V> remapped(newVertexCount);
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            if (remap[i] != ~0u) {
+                remapped[remap[i]] = vertices[i];
+            }
+        }
+        for (auto& index : indices) {
+            index = remap[index];
+        }
+        vertices.swap(remapped);
+    }
+
+    // Runs every stage on any vertex type with a GetVertexPosition() overload
+    template<typename V>
+    static MeshOptimizationReport Optimize(std::vector<V>& vertices, std::vector<unsigned int>& indices) {
+        MeshOptimizationReport report;
+        report.verticesBefore = vertices.size();
+        report.before = AnalyzeVertexCache(indices, vertices.size());
+
+        if (vertices.empty() || indices.size() < 3) {
+            report.after = report.before;
+            report.verticesAfter = vertices.size();
+            return report;
+        }
+
+        std::vector<unsigned int> remap;
+
+        // Weld duplicates so that shared vertices can actually hit the cache
+        size_t uniqueCount = GenerateWeldRemap(vertices.data(), vertices.size(), sizeof(V), remap);
+        RemapBuffers(vertices, indices, remap, uniqueCount);
+
+        OptimizeVertexCache(indices, vertices.size());
+
+        std::vector<fvec3> positions;
+        positions.reserve(vertices.size());
+        for (const auto& vertex : vertices) {
+            positions.push_back(GetVertexPosition(vertex));
+        }
+        OptimizeOverdraw(indices, positions);
+
+        // Re-sequence vertices in the order the GPU will fetch them
+        size_t referencedCount = GenerateFetchRemap(indices, vertices.size(), remap);
+        RemapBuffers(vertices, indices, remap, referencedCount);
+
+        report.verticesAfter = vertices.size();
+        report.after = AnalyzeVertexCache(indices, vertices.size());
+        return report;
+    }
+};
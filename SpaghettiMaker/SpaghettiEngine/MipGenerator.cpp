@@ -0,0 +1,202 @@
+#include "MipGenerator.h"
+#include "Log.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIP_GENERATOR_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace {
+    // One RGBA pixel in float, the unit every filter tap works on
+#ifdef MIP_GENERATOR_SSE
+    using Pixel = __m128;
+    inline Pixel Zero() { return _mm_setzero_ps(); }
+    inline Pixel Load(const float* p) { return _mm_loadu_ps(p); }
+    inline void Store(float* p, Pixel v) { _mm_storeu_ps(p, v); }
+    inline Pixel MulAdd(Pixel sum, Pixel v, float weight) { return _mm_add_ps(sum, _mm_mul_ps(v, _mm_set1_ps(weight))); }
+#else
+    struct Pixel { float v[4]; };
+    inline Pixel Zero() { return { { 0.0f, 0.0f, 0.0f, 0.0f } }; }
+    inline Pixel Load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+    inline void Store(float* p, Pixel v) { std::copy(v.v, v.v + 4, p); }
+    inline Pixel MulAdd(Pixel sum, Pixel v, float weight) {
+        for (int c = 0; c < 4; c++) sum.v[c] += v.v[c] * weight;
+        return sum;
+    }
+#endif
+
+    // sRGB transfer function both ways; the encode table is fine enough to round trip 8 bits
+    struct ColorTables {
+        float toLinear[256];
+        unsigned char toSRGB[4096];
+
+        ColorTables() {
+            for (int i = 0; i < 256; i++) {
+                float c = i / 255.0f;
+                toLinear[i] = (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (int i = 0; i < 4096; i++) {
+                float l = i / 4095.0f;
+                float c = (l <= 0.0031308f) ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+                toSRGB[i] = static_cast<unsigned char>(std::clamp(static_cast<int>(c * 255.0f + 0.5f), 0, 255));
+            }
+        }
+    };
+
+    const ColorTables& GetColorTables() {
+        static const ColorTables tables;
+        return tables;
+    }
+
+    // Modified Bessel function of the first kind, order 0, for the Kaiser window
+    double BesselI0(double x) {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; k++) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1e-12) break;
+        }
+        return sum;
+    }
+
+    // Weights of a 2:1 reduction, applied to source texels 2x + firstTap + k
+    struct FilterKernel {
+        int firstTap = 0;
+        std::vector<float> weights;
+    };
+
+    FilterKernel MakeKernel(MipFilter filter) {
+        FilterKernel kernel;
+        if (filter == MipFilter::Box) {
+            kernel.firstTap = 0;
+            kernel.weights = { 0.5f, 0.5f };
+            return kernel;
+        }
+
+        // Sinc at half the source rate, windowed over four source texels each side
+        const double alpha = 4.0;
+        const double radius = 4.0;
+        const double pi = 3.14159265358979323846;
+        kernel.firstTap = -3;
+        double total = 0.0;
+        for (int k = 0; k < 8; k++) {
+            double d = (kernel.firstTap + k + 0.5) - 1.0; // Texel center relative to the output center
+            double x = d / 2.0;
+            double sinc = (x == 0.0) ? 1.0 : std::sin(pi * x) / (pi * x);
+            double t = d / radius;
+            double window = BesselI0(alpha * std::sqrt(std::max(0.0, 1.0 - t * t))) / BesselI0(alpha);
+            kernel.weights.push_back(static_cast<float>(sinc * window));
+            total += sinc * window;
+        }
+        for (float& weight : kernel.weights) {
+            weight = static_cast<float>(weight / total);
+        }
+        return kernel;
+    }
+
+    // Separable 2:1 reduction; edges clamp
+    void Reduce(const std::vector<float>& source, int width, int height, std::vector<float>& output, int outputWidth, int outputHeight, const FilterKernel& kernel) {
+        const int taps = static_cast<int>(kernel.weights.size());
+        std::vector<float> columns(static_cast<size_t>(outputWidth) * height * 4);
+        output.resize(static_cast<size_t>(outputWidth) * outputHeight * 4);
+
+        // Horizontal pass; a one texel wide level passes through
+        JOB_SYSTEM->ParallelFor(static_cast<size_t>(height), [&](size_t y) {
+            const float* row = source.data() + y * width * 4;
+            float* out = columns.data() + y * outputWidth * 4;
+            for (int x = 0; x < outputWidth; x++) {
+                Pixel sum = Zero();
+                for (int k = 0; k < taps; k++) {
+                    int sourceX = (width == 1) ? 0 : std::clamp(2 * x + kernel.firstTap + k, 0, width - 1);
+                    sum = MulAdd(sum, Load(row + sourceX * 4), kernel.weights[k]);
+                }
+                Store(out + x * 4, sum);
+            }
+        });
+
+        // Vertical pass
+        JOB_SYSTEM->ParallelFor(static_cast<size_t>(outputHeight), [&](size_t y) {
+            float* out = output.data() + y * outputWidth * 4;
+            for (int x = 0; x < outputWidth; x++) {
+                Pixel sum = Zero();
+                for (int k = 0; k < taps; k++) {
+                    int sourceY = (height == 1) ? 0 : std::clamp(2 * static_cast<int>(y) + kernel.firstTap + k, 0, height - 1);
+                    sum = MulAdd(sum, Load(columns.data() + (static_cast<size_t>(sourceY) * outputWidth + x) * 4), kernel.weights[k]);
+                }
+                Store(out + x * 4, sum);
+            }
+        });
+    }
+}
+
+bool MipGenerator::Generate(const ImageData& source, ImageData& output, MipFilter filter) {
+    if (source.format != TextureFormat::RGBA8 || !source.levels.empty() || source.width <= 0 || source.height <= 0 ||
+        source.pixels.size() < static_cast<size_t>(source.width) * source.height * 4) {
+        LOG_ERROR(Texture, "Mip generation needs a single level RGBA8 image");
+        return false;
+    }
+
+    const ColorTables& tables = GetColorTables();
+    const FilterKernel kernel = MakeKernel(filter);
+
+    output.width = source.width;
+    output.height = source.height;
+    output.channels = source.channels;
+    output.format = TextureFormat::RGBA8;
+    output.firstLevel = 0;
+    output.levels.clear();
+    output.pixels.assign(source.pixels.begin(), source.pixels.begin() + static_cast<size_t>(source.width) * source.height * 4);
+    output.levels.push_back({ source.width, source.height, 0, output.pixels.size() });
+
+    // Work in linear light from the full resolution level down
+    int width = source.width;
+    int height = source.height;
+    std::vector<float> level(static_cast<size_t>(width) * height * 4);
+    JOB_SYSTEM->ParallelFor(static_cast<size_t>(height), [&](size_t y) {
+        for (size_t i = y * width * 4; i < (y + 1) * width * 4; i += 4) {
+            level[i + 0] = tables.toLinear[source.pixels[i + 0]];
+            level[i + 1] = tables.toLinear[source.pixels[i + 1]];
+            level[i + 2] = tables.toLinear[source.pixels[i + 2]];
+            level[i + 3] = source.pixels[i + 3] / 255.0f;
+        }
+    });
+
+    std::vector<float> next;
+    while (width > 1 || height > 1) {
+        const int nextWidth = std::max(width / 2, 1);
+        const int nextHeight = std::max(height / 2, 1);
+        Reduce(level, width, height, next, nextWidth, nextHeight, kernel);
+        level.swap(next);
+        width = nextWidth;
+        height = nextHeight;
+
+        // Back to 8-bit sRGB; the Kaiser lobes can overshoot, so clamp
+        const size_t offset = output.pixels.size();
+        const size_t size = static_cast<size_t>(width) * height * 4;
+        output.pixels.resize(offset + size);
+        unsigned char* pixels = output.pixels.data() + offset;
+        JOB_SYSTEM->ParallelFor(static_cast<size_t>(height), [&](size_t y) {
+            for (size_t i = y * width * 4; i < (y + 1) * width * 4; i += 4) {
+                for (int c = 0; c < 3; c++) {
+                    pixels[i + c] = tables.toSRGB[std::clamp(static_cast<int>(level[i + c] * 4095.0f + 0.5f), 0, 4095)];
+                }
+                pixels[i + 3] = static_cast<unsigned char>(std::clamp(static_cast<int>(level[i + 3] * 255.0f + 0.5f), 0, 255));
+            }
+        });
+        output.levels.push_back({ width, height, offset, size });
+    }
+    return true;
+}
+
+const char* MipGenerator::GetFilterName(MipFilter filter) {
+    switch (filter) {
+    case MipFilter::Box: return "Box";
+    case MipFilter::Kaiser: return "Kaiser";
+    default: return "Unknown";
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "Texture.h"
+
+// Downsampling filter for each mip level
+enum class MipFilter {
+    Box,   // 2x2 average, cheap but blurry and prone to aliasing
+    Kaiser // 8-tap Kaiser-windowed sinc, keeps more detail without ringing
+};
+
+// Builds full mip chains on the CPU, so textures never depend on glGenerateMipmap and the
+// driver's filter. Color is filtered in linear light (sRGB decoded, filtered, re-encoded);
+// alpha is filtered as is. Rows are spread over the JobSystem and each pixel is processed
+// as one SSE vector where available.
+class MipGenerator {
+public:
+    // Takes a single RGBA8 level and returns it with every level down to 1x1
+    static bool Generate(const ImageData& source, ImageData& output, MipFilter filter = MipFilter::Kaiser);
+
+    static const char* GetFilterName(MipFilter filter);
+};
@@ -1,16 +1,69 @@
 #include "ModelLoader.h"
 #include "MeshComponent.h"
 #include "MaterialComponent.h"
+#include "MaterialManager.h"
 #include "TransformComponent.h"
+#include "MeshOptimizer.h"
+#include "CookedMesh.h"
+#include "AssetDatabase.h"
+#include "JobSystem.h"
+#include "UploadQueue.h"
+#include "TextureManager.h"
+#include "ResourceId.h"
+#include "Log.h"
+#include "Profiler.h"
 #include <filesystem>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <chrono>
+#include <thread>
 #include <iostream>
-#include <glm/gtx/matrix_decompose.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include "ConsoleWindow.h"
 
-GameObject* ModelLoader::LoadModel(Scene* scene, const std::string& path, const std::string& texturePath)
-{
+std::vector<ModelLoadHandle> ModelLoader::s_activeLoads;
+std::unordered_map<std::string, std::weak_ptr<const Prefab>> ModelLoader::s_prefabs;
+
+namespace {
+    // Post-processing shared by LoadModel and LoadMeshData, so reloaded meshes match the originals
+    const unsigned int ImportFlags =
+        aiProcess_Triangulate |
+        aiProcess_GenNormals |
+        aiProcess_CalcTangentSpace |
+        aiProcess_SortByPType |
+        aiProcess_FlipUVs | // OpenGL convention
+        aiProcess_GlobalScale;   // Add global scaling
+    // The node hierarchy is kept (no aiProcess_PreTransformVertices), so a mesh that several
+    // nodes instance is stored and uploaded once
+
+    // ToEngineSpace as a rotation, used to carry node transforms into engine space
+    const quat EngineSpaceRotation = glm::quat_cast(glm::dmat3(
+        vec3(0.0, 0.0, -1.0),
+        vec3(1.0, 0.0, 0.0),
+        vec3(0.0, -1.0, 0.0)));
+
+    // UVs this close to 0-1 still count as not repeating; exporters often overshoot slightly
+    const float UnitTexCoordTolerance = 1e-3f;
+}
+
+uint64_t ModelLoader::GetImportSettingsHash() {
+    // Anything that changes the cooked output must be part of this hash
+    const uint64_t settings[] = { ImportFlags, CookedMeshVersion, MeshOptimizer::CacheSize };
+    return AssetDatabase::HashBytes(settings, sizeof(settings));
+}
+
+std::string ModelLoader::ImportModel(const std::string& path) {
+    PROFILE_SCOPE("ModelLoader::ImportModel");
+    const uint64_t settingsHash = GetImportSettingsHash();
+    return ASSET_DATABASE->ImportOnce(path, settingsHash, [&path, settingsHash]() { return CookModel(path, settingsHash); });
+}
+
+std::string ModelLoader::CookModel(const std::string& path, uint64_t settingsHash) {
+    LOG_INFO(Assets, "Importing model: {}", path);
+
     // Create Assimp importer
     Assimp::Importer importer;
 
@@ -18,23 +71,29 @@ GameObject* ModelLoader::LoadModel(Scene* scene, const std::string& path, const
     importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
 
     // Import scene
-    const aiScene* scene_ai = importer.ReadFile(path,
-        aiProcess_Triangulate |
-        aiProcess_GenNormals |
-        aiProcess_CalcTangentSpace |
-        aiProcess_JoinIdenticalVertices |
-        aiProcess_SortByPType |
-        aiProcess_FlipUVs | // OpenGL convention
-        aiProcess_GlobalScale |  // Add global scaling
-        aiProcess_PreTransformVertices  // Pre-transform vertices to fix scaling issues
-    );
+    const aiScene* scene_ai = importer.ReadFile(path, ImportFlags);
 
     // Check for errors
     if (!scene_ai || scene_ai->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene_ai->mRootNode) {
-        std::cerr << "Assimp error: " << importer.GetErrorString() << std::endl;
-        return nullptr;
+        LOG_ERROR(Assets, "Assimp error: {}", importer.GetErrorString());
+        return "";
     }
 
+    std::string cookedPath = ASSET_DATABASE->GetCookedPath(path, ".smesh");
+    if (!CookScene(scene_ai, cookedPath)) {
+        return "";
+    }
+
+    ASSET_DATABASE->MarkImported(path, cookedPath, settingsHash);
+    return cookedPath;
+}
+
+GameObject* ModelLoader::LoadModel(Scene* scene, const std::string& path, const std::string& texturePath)
+{
+    PROFILE_SCOPE("ModelLoader::LoadModel");
+    // Bring the cooked output up to date; the source is only parsed if it changed
+    std::string cookedPath = ImportModel(path);
+
     // Create root game object with the file name
     std::string fileName = std::filesystem::path(path).stem().string();
     GameObject* rootObject = scene->CreateGameObject(fileName.c_str());
@@ -46,6 +105,54 @@ GameObject* ModelLoader::LoadModel(Scene* scene, const std::string& path, const
     rootTransform->SetLocalScale(vec3(0.1));  // Scale down by default
 
     // Handle texture path
+    std::string finalTexturePath = ResolveTexturePath(path, texturePath);
+
+    LOG_DEBUG(Assets, "Model path: {}", std::filesystem::absolute(path).string());
+    LOG_DEBUG(Assets, "Texture path: {}", finalTexturePath);
+
+    // Prefer the cooked file: a memory map and a direct upload, no parsing
+    CookedMesh cooked;
+    if (!cookedPath.empty() && cooked.Open(cookedPath)) {
+        LOG_DEBUG(Assets, "Loading cooked model: {}", cookedPath);
+        InstantiateCooked(scene, cooked, rootObject, path, finalTexturePath);
+        LOG_INFO(Assets, "Loaded model {}: {} meshes, {} materials", path, cooked.GetSubmeshCount(), cooked.GetMaterialCount());
+        return rootObject;
+    }
+
+    // Cooking failed (e.g. read-only library), build from the Assimp scene instead
+    std::vector<MeshData> meshes;
+    std::vector<MaterialData> materials;
+    std::vector<NodeData> nodes;
+    if (!ParseModel(path, meshes, materials, nodes)) {
+        scene->DestroyGameObject(rootObject);
+        return nullptr;
+    }
+
+    std::vector<ModelMesh> modelMeshes(meshes.size());
+    for (unsigned int i = 0; i < meshes.size(); i++) {
+        modelMeshes[i] = LoadParsedMesh(meshes[i], i, path);
+    }
+    InstantiateModel(scene, modelMeshes, LoadModelMaterials(path, materials, finalTexturePath), nodes, rootObject);
+
+    LOG_INFO(Assets, "Loaded model {}: {} meshes, {} materials", path, meshes.size(), materials.size());
+
+    return rootObject;
+}
+
+bool ModelLoader::ParseModel(const std::string& path, std::vector<MeshData>& meshes, std::vector<MaterialData>& materials, std::vector<NodeData>& nodes) {
+    Assimp::Importer importer;
+    importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+    const aiScene* scene_ai = importer.ReadFile(path, ImportFlags);
+    if (!scene_ai || scene_ai->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene_ai->mRootNode) {
+        LOG_ERROR(Assets, "Assimp error: {}", importer.GetErrorString());
+        return false;
+    }
+
+    ExtractScene(scene_ai, meshes, materials, nodes);
+    return true;
+}
+
+std::string ModelLoader::ResolveTexturePath(const std::string& path, const std::string& texturePath) {
     std::string finalTexturePath;
     if (!texturePath.empty()) {
         // If explicit texture path provided, make it absolute
@@ -65,116 +172,628 @@ GameObject* ModelLoader::LoadModel(Scene* scene, const std::string& path, const
             finalTexturePath = defaultTexPath.string();
         }
     }
+    return finalTexturePath;
+}
 
-    std::cout << "Model path: " << std::filesystem::absolute(path) << std::endl;
-    std::cout << "Texture path: " << finalTexturePath << std::endl;
-
-    // Process the root node
-    ProcessNode(scene, scene_ai->mRootNode, scene_ai, rootObject, finalTexturePath);
+ModelLoadHandle ModelLoader::LoadModelAsync(Scene* scene, const std::string& path, const std::string& texturePath, std::function<void(GameObject*)> onComplete) {
+    auto state = std::make_shared<ModelLoadState>();
+    state->path = path;
+    state->onComplete = std::move(onComplete);
+    s_activeLoads.push_back(state);
 
-    std::cout << "Loading model: " << path << std::endl;
-    std::cout << "Number of meshes: " << scene_ai->mNumMeshes << std::endl;
-    std::cout << "Number of materials: " << scene_ai->mNumMaterials << std::endl;
+    JOB_SYSTEM->Schedule([scene, state, texturePath]() {
+        RunAsyncLoad(scene, state, texturePath);
+    });
 
-    return rootObject;
+    return state;
 }
 
-GameObject* ModelLoader::ProcessNode(Scene* scene, aiNode* node, const aiScene* scene_ai, GameObject* parent, const std::string& texturePath) {
-    // Create game object for this node
-    GameObject* gameObject = scene->CreateGameObject(node->mName.C_Str(), parent);
+ModelLoadHandle ModelLoader::InstantiatePrefabAsync(Scene* scene, const std::string& path, const std::string& texturePath, std::function<void(GameObject*)> onComplete) {
+    auto state = std::make_shared<ModelLoadState>();
+    state->path = path;
+    state->onComplete = std::move(onComplete);
+    s_activeLoads.push_back(state);
+
+    JOB_SYSTEM->Schedule([scene, state, texturePath]() {
+        // The cook is the slow part; LoadPrefab then only opens the library copy
+        bool imported = false;
+        if (!state->cancelRequested) {
+            state->status = ModelLoadStatus::Importing;
+            imported = !ImportModel(state->path).empty();
+            state->progress = 0.5f;
+        }
 
-    // Add transform component and set local transform
-    auto transform = gameObject->AddComponent<TransformComponent>();
+        // Always queued, so a cancelled load still finishes
+        state->status = ModelLoadStatus::Uploading;
+        UPLOAD_QUEUE->Enqueue([scene, state, texturePath, imported]() {
+            if (state->cancelRequested) {
+                state->status = ModelLoadStatus::Cancelled;
+                LOG_INFO(Assets, "Cancelled loading model: {}", state->path);
+                return;
+            }
+
+            PrefabPtr prefab = imported ? LoadPrefab(state->path, texturePath) : nullptr;
+            if (!prefab) {
+                LOG_ERROR(Assets, "Failed to load model {}: import failed", state->path);
+                state->error = "import failed";
+                state->status = ModelLoadStatus::Failed;
+                return;
+            }
+
+            GameObject* instance = Prefab::Instantiate(scene, prefab);
+            instance->GetComponent<TransformComponent>()->SetLocalScale(vec3(0.1));  // Scale down by default, as LoadModel does
+
+            state->result = instance;
+            state->progress = 1.0f;
+            state->status = ModelLoadStatus::Done;
+            LOG_INFO(Assets, "Placed prefab instance: {}", state->path);
+
+            if (state->onComplete) {
+                state->onComplete(state->result);
+            }
+        });
+    });
+
+    return state;
+}
 
-    // Convert Assimp matrix to glm
-    aiMatrix4x4 aiMat = node->mTransformation;
-    mat4 glmMat;
-    // Transpose because Assimp uses row-major matrices
-    for (int i = 0; i < 4; i++)
-        for (int j = 0; j < 4; j++)
-            glmMat[i][j] = aiMat[j][i];
-
-    // Decompose transform
-    vec3 scale;
-    glm::dquat rotation;
-    vec3 translation;
-    vec3 skew;
-    vec4 perspective;
-
-    // Use explicit types for decompose
-    bool success = glm::decompose(
-        glmMat,
-        scale,
-        rotation,
-        translation,
-        skew,
-        perspective
-    );
-
-    // Set transform values
-    if (success) {
-        transform->SetLocalPosition(translation);
-        transform->SetLocalRotation(rotation);
-        transform->SetLocalScale(scale);
+void ModelLoader::RunAsyncLoad(Scene* scene, ModelLoadHandle state, const std::string& texturePath) {
+    PROFILE_SCOPE("ModelLoader::RunAsyncLoad");
+    auto fail = [&state](const std::string& message) {
+        LOG_ERROR(Assets, "Failed to load model {}: {}", state->path, message);
+        state->error = message;
+        state->status = ModelLoadStatus::Failed;
+    };
+
+    // Checked again after every step that can take long; a cancelled load creates nothing
+    auto cancelled = [&state]() {
+        if (!state->cancelRequested) return false;
+        state->status = ModelLoadStatus::Cancelled;
+        return true;
+    };
+    if (cancelled()) return;
+
+    // Parse and cook (skipped when the library copy is current)
+    state->status = ModelLoadStatus::Importing;
+    std::string cookedPath = ImportModel(state->path);
+    if (cancelled()) return;
+    state->progress = 0.4f;
+
+    // Plain copies of the tables, so the queued jobs only touch the mapping for vertex data
+    auto cooked = std::make_shared<CookedMesh>();
+    auto parsed = std::make_shared<std::vector<MeshData>>();
+    auto materials = std::make_shared<std::vector<MaterialData>>();
+    auto nodes = std::make_shared<std::vector<NodeData>>();
+    if (!cookedPath.empty() && cooked->Open(cookedPath)) {
+        for (uint32_t i = 0; i < cooked->GetMaterialCount(); i++) {
+            materials->push_back(cooked->GetMaterial(i));
+        }
+        for (uint32_t i = 0; i < cooked->GetNodeCount(); i++) {
+            nodes->push_back(cooked->GetNode(i));
+        }
     }
     else {
-        std::cerr << "Failed to decompose transformation matrix for node: " << node->mName.C_Str() << std::endl;
-        transform->SetLocalPosition(vec3(0.0));
-        transform->SetLocalRotation(glm::dquat(1.0, 0.0, 0.0, 0.0));
-        transform->SetLocalScale(vec3(1.0));
+        // Cooking failed (e.g. read-only library); parse here instead, as LoadModel does
+        cooked.reset();
+        if (!ParseModel(state->path, *parsed, *materials, *nodes)) {
+            fail("import failed");
+            return;
+        }
+    }
+    if (cancelled()) return;
+    const size_t meshCount = cooked ? cooked->GetSubmeshCount() : parsed->size();
+
+    // Atlas pages come packed and compressed from the library (cooked on first use), so the
+    // main thread only uploads them
+    std::string finalTexturePath = ResolveTexturePath(state->path, texturePath);
+    auto atlas = std::make_shared<PreparedAtlas>();
+    TEXTURE_MANAGER->PrepareAtlas(GetAtlasTexturePaths(*materials, finalTexturePath), *atlas);
+    std::unordered_set<ResourceId, ResourceIdHash> packed;
+    for (size_t i = 0; i < atlas->textures.size(); i++) {
+        if (atlas->regions[i].page >= 0) {
+            packed.insert(atlas->textures[i]);
+        }
+    }
+    if (cancelled()) return;
+
+    // Decode every other texture the materials use; a failed decode leaves the default texture
+    auto images = std::make_shared<std::unordered_map<std::string, std::shared_ptr<PreparedTexture>>>();
+    std::vector<std::string> texturePaths;
+    for (const MaterialData& material : *materials) {
+        std::string texPath = GetMaterialTexturePath(material, finalTexturePath);
+        if (texPath.empty() || ((material.flags & CookedMaterial_UnitTexCoords) && packed.count(ResourceId::FromPath(texPath)))) continue;
+        if (!images->count(texPath)) {
+            (*images)[texPath] = nullptr;
+            texturePaths.push_back(texPath);
+        }
     }
 
-    // Process all meshes for this node
-    for (unsigned int i = 0; i < node->mNumMeshes; i++) {
-        aiMesh* mesh = scene_ai->mMeshes[node->mMeshes[i]];
-        ProcessMesh(gameObject, mesh, scene_ai, texturePath);
+    // One texture per iteration across the workers. Cooked textures arrive block-compressed;
+    // streamed ones only read their small mips here.
+    std::vector<std::shared_ptr<PreparedTexture>> prepared(texturePaths.size());
+    JOB_SYSTEM->ParallelFor(texturePaths.size(), [&](size_t i) {
+        if (state->cancelRequested) return;
+
+        auto image = std::make_shared<PreparedTexture>();
+        if (TEXTURE_MANAGER->PrepareTexture(texturePaths[i], *image)) {
+            prepared[i] = image;
+        }
+    });
+    for (size_t i = 0; i < texturePaths.size(); i++) {
+        (*images)[texturePaths[i]] = prepared[i];
     }
+    if (cancelled()) return;
+    state->progress = 0.6f;
+
+    // Everything below runs on the main thread. The root only exists there, so it is shared
+    // between the queued uploads rather than returned from here. The objects are held weakly:
+    // the user may delete them from the hierarchy, or the scene may be cleared, between frames.
+    state->status = ModelLoadStatus::Uploading;
+    auto root = std::make_shared<std::weak_ptr<GameObject>>();
+    auto meshes = std::make_shared<std::vector<ModelMesh>>(meshCount);
+    auto sharedMaterials = std::make_shared<std::vector<MaterialPtr>>();
+    auto objects = std::make_shared<std::vector<std::weak_ptr<GameObject>>>(nodes->size());
+    const size_t jobCount = meshes->size() + nodes->size();
+
+    UPLOAD_QUEUE->Enqueue([scene, state, root, images, atlas, materials, sharedMaterials, finalTexturePath]() {
+        if (state->cancelRequested) return;
+        PROFILE_SCOPE("ModelLoader::UploadMaterials");
+
+        // Create root game object with the file name, as LoadModel does
+        std::string fileName = std::filesystem::path(state->path).stem().string();
+        GameObject* rootObject = scene->CreateGameObject(fileName.c_str());
+        *root = rootObject->weak_from_this();
+        auto rootTransform = rootObject->AddComponent<TransformComponent>();
+        rootTransform->SetLocalScale(vec3(0.1));  // Scale down by default
+
+        // Hand the decoded images to the texture cache, where the materials will find them
+        for (const auto& [texPath, image] : *images) {
+            if (image) {
+                TEXTURE_MANAGER->AddTexture(texPath, std::move(*image));
+            }
+        }
+        *sharedMaterials = LoadModelMaterials(state->path, *materials, finalTexturePath, atlas.get());
+    }, &state->cancelRequested);
+
+    // Unique meshes first, a few per frame, then the nodes that instance them
+    bool queued = true;
+    for (uint32_t i = 0; queued && i < meshes->size(); i++) {
+        queued = UPLOAD_QUEUE->Enqueue([state, root, cooked, parsed, meshes, i, jobCount]() {
+            if (state->cancelRequested) return;
+            if (root->expired()) {
+                // The root was deleted or the scene cleared; nothing is left to upload for
+                state->Cancel();
+                return;
+            }
+            PROFILE_SCOPE("ModelLoader::UploadMesh");
 
-    // Process children
-    for (unsigned int i = 0; i < node->mNumChildren; i++) {
-        ProcessNode(scene, node->mChildren[i], scene_ai, gameObject, texturePath);
+            (*meshes)[i] = cooked ? LoadCookedMesh(*cooked, i, state->path) : LoadParsedMesh((*parsed)[i], i, state->path);
+            state->progress = 0.6f + 0.4f * static_cast<float>(i + 1) / static_cast<float>(jobCount);
+        }, &state->cancelRequested);
+    }
+
+    for (size_t i = 0; queued && i < nodes->size(); i++) {
+        queued = UPLOAD_QUEUE->Enqueue([scene, state, root, meshes, sharedMaterials, nodes, objects, i, jobCount]() {
+            if (state->cancelRequested) return;
+            std::shared_ptr<GameObject> rootObject = root->lock();
+            if (!rootObject) {
+                state->Cancel();
+                return;
+            }
+            PROFILE_SCOPE("ModelLoader::InstantiateNode");
+
+            // Parents come first in the node table, so they were created by an earlier job.
+            // A parent deleted since then takes the rest of its subtree with it.
+            const NodeData& node = (*nodes)[i];
+            std::shared_ptr<GameObject> parent = node.parent >= 0 ? (*objects)[node.parent].lock() : rootObject;
+            if (parent) {
+                (*objects)[i] = InstantiateNode(scene, node, parent.get(), *meshes, *sharedMaterials)->weak_from_this();
+            }
+
+            state->progress = 0.6f + 0.4f * static_cast<float>(meshes->size() + i + 1) / static_cast<float>(jobCount);
+        }, &state->cancelRequested);
+    }
+
+    // Always queued, so a cancelled load still removes what it already created
+    UPLOAD_QUEUE->Enqueue([scene, state, root, meshes, sharedMaterials]() {
+        // GL objects must be released on this thread; once the objects hold what they use, the
+        // load's own references must not be the last ones left to this worker
+        meshes->clear();
+        sharedMaterials->clear();
+
+        std::shared_ptr<GameObject> rootObject = root->lock();
+        if (state->cancelRequested || !rootObject) {
+            if (rootObject) {
+                scene->DestroyGameObject(rootObject.get());
+            }
+            state->status = ModelLoadStatus::Cancelled;
+            LOG_INFO(Assets, "Cancelled loading model: {}", state->path);
+            return;
+        }
+
+        state->result = rootObject.get();
+        state->progress = 1.0f;
+        state->status = ModelLoadStatus::Done;
+        LOG_INFO(Assets, "Finished loading model: {}", state->path);
+
+        if (state->onComplete) {
+            state->onComplete(state->result);
+        }
+    });
+}
+
+void ModelLoader::ClearFinishedLoads() {
+    s_activeLoads.erase(
+        std::remove_if(s_activeLoads.begin(), s_activeLoads.end(),
+            [](const ModelLoadHandle& load) { return load->IsFinished(); }),
+        s_activeLoads.end());
+}
+
+void ModelLoader::CancelAllLoads() {
+    for (const auto& load : s_activeLoads) {
+        load->Cancel();
     }
+}
+
+bool ModelLoader::CookScene(const aiScene* scene_ai, const std::string& cookedPath) {
+    std::vector<MeshData> meshes;
+    std::vector<MaterialData> materials;
+    std::vector<NodeData> nodes;
+    ExtractScene(scene_ai, meshes, materials, nodes);
 
-    // Debug output for transforms
-    std::cout << "Processing node: " << node->mName.C_Str() << std::endl;
-    std::cout << "Transform matrix:" << std::endl;
-    for (int i = 0; i < 4; i++) {
-        std::cout << glmMat[i][0] << ", " << glmMat[i][1] << ", "
-            << glmMat[i][2] << ", " << glmMat[i][3] << std::endl;
+    return CookedMesh::Write(cookedPath, meshes, materials, nodes);
+}
+
+void ModelLoader::ExtractScene(const aiScene* scene_ai, std::vector<MeshData>& meshes, std::vector<MaterialData>& materials, std::vector<NodeData>& nodes) {
+    PROFILE_SCOPE("ModelLoader::ExtractScene");
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    // Meshes and materials are independent, so each one is a parallel iteration writing its own
+    // slot. The results keep the scene's order, which keeps the hierarchy built later deterministic.
+    meshes.clear();
+    meshes.resize(scene_ai->mNumMeshes);
+    std::vector<MeshOptimizationReport> reports(scene_ai->mNumMeshes);
+    JOB_SYSTEM->ParallelFor(scene_ai->mNumMeshes, [&](size_t i) {
+        const aiMesh* mesh = scene_ai->mMeshes[i];
+        meshes[i].name = mesh->mName.C_Str();
+        meshes[i].materialIndex = mesh->mMaterialIndex;
+        reports[i] = ExtractMeshData(mesh, meshes[i].vertices, meshes[i].indices);
+    });
+
+    materials.clear();
+    materials.resize(scene_ai->mNumMaterials);
+    JOB_SYSTEM->ParallelFor(scene_ai->mNumMaterials, [&](size_t i) {
+        materials[i] = ExtractMaterialData(scene_ai->mMaterials[i]);
+    });
+
+    // Materials whose meshes never repeat their texture may have it packed into an atlas
+    std::vector<char> repeats(materials.size(), 0);
+    for (const MeshData& mesh : meshes) {
+        if (mesh.materialIndex >= materials.size() || repeats[mesh.materialIndex]) continue;
+        for (const StandardVertex& vertex : mesh.vertices) {
+            if (vertex.texCoords[0] < -UnitTexCoordTolerance || vertex.texCoords[0] > 1.0f + UnitTexCoordTolerance ||
+                vertex.texCoords[1] < -UnitTexCoordTolerance || vertex.texCoords[1] > 1.0f + UnitTexCoordTolerance) {
+                repeats[mesh.materialIndex] = 1;
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; i < materials.size(); i++) {
+        if (!repeats[i]) {
+            materials[i].flags |= CookedMaterial_UnitTexCoords;
+        }
+    }
+
+    // The hierarchy is small next to the geometry, so it is walked on this thread
+    nodes.clear();
+    ExtractNodes(scene_ai->mRootNode, -1, nodes);
+
+    // One summary instead of a block of output per mesh
+    size_t verticesBefore = 0;
+    size_t verticesAfter = 0;
+    double acmrBefore = 0.0;
+    double acmrAfter = 0.0;
+    for (const auto& report : reports) {
+        verticesBefore += report.verticesBefore;
+        verticesAfter += report.verticesAfter;
+        acmrBefore += report.before.acmr;
+        acmrAfter += report.after.acmr;
+    }
+    if (!reports.empty()) {
+        acmrBefore /= reports.size();
+        acmrAfter /= reports.size();
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+    LOG_INFO(Assets, "Extracted {} meshes, {} materials and {} nodes in {} ms ({} threads)",
+        meshes.size(), materials.size(), nodes.size(), elapsed.count(), JOB_SYSTEM->GetWorkerCount() + 1);
+    LOG_DEBUG(Mesh, "Vertices: {} -> {}, average ACMR: {} -> {}", verticesBefore, verticesAfter, acmrBefore, acmrAfter);
+}
+
+void ModelLoader::BenchmarkImport(const std::string& path, int repetitions) {
+    Assimp::Importer importer;
+    importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+
+    auto parseStart = std::chrono::high_resolution_clock::now();
+    const aiScene* scene_ai = importer.ReadFile(path, ImportFlags);
+    if (!scene_ai || scene_ai->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene_ai->mRootNode) {
+        LOG_ERROR(Assets, "Assimp error: {}", importer.GetErrorString());
+        return;
+    }
+    std::chrono::duration<double, std::milli> parseTime = std::chrono::high_resolution_clock::now() - parseStart;
+
+    // Thread counts to measure: 1, 2, 4, ... up to every core
+    std::vector<unsigned int> threadCounts;
+    const unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int threads = 1; threads < cores; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(cores);
+
+    std::cout << "Import benchmark: " << path << std::endl;
+    std::cout << "- Meshes: " << scene_ai->mNumMeshes << ", materials: " << scene_ai->mNumMaterials << std::endl;
+    std::cout << "- Assimp parse: " << parseTime.count() << " ms" << std::endl;
+    std::cout << "threads\tbest ms\tspeedup" << std::endl;
+
+    double baseline = 0.0;
+    for (unsigned int threads : threadCounts) {
+        // The calling thread takes part in ParallelFor, so it needs one worker fewer
+        JOB_SYSTEM->Shutdown();
+        if (threads > 1) {
+            JOB_SYSTEM->Initialize(threads - 1);
+        }
+
+        double best = 0.0;
+        for (int run = 0; run < repetitions; ++run) {
+            std::vector<MeshData> meshes;
+            std::vector<MaterialData> materials;
+            std::vector<NodeData> nodes;
+            auto start = std::chrono::high_resolution_clock::now();
+            ExtractScene(scene_ai, meshes, materials, nodes);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+            if (run == 0 || elapsed.count() < best) {
+                best = elapsed.count();
+            }
+        }
+
+        if (threads == 1) {
+            baseline = best;
+        }
+        std::cout << threads << "\t" << best << "\t" << (best > 0.0 ? baseline / best : 0.0) << "x" << std::endl;
+    }
+}
+
+ModelLoader::ModelMesh ModelLoader::LoadCookedMesh(const CookedMesh& cooked, uint32_t index, const std::string& modelPath) {
+    const CookedSubmesh& submesh = cooked.GetSubmesh(index);
+    ModelMesh mesh;
+    mesh.name = std::string(submesh.name, strnlen(submesh.name, sizeof(submesh.name)));
+    mesh.materialIndex = submesh.materialIndex;
+
+    // Upload straight from the mapping, unless an earlier load of this model already did
+    mesh.mesh = MESH_MANAGER->AddMesh(modelPath, index, cooked.GetVertices(index), cooked.GetIndices(index), mesh.name);
+    return mesh;
+}
+
+ModelLoader::ModelMesh ModelLoader::LoadParsedMesh(const MeshData& data, uint32_t index, const std::string& modelPath) {
+    ModelMesh mesh;
+    mesh.name = data.name;
+    mesh.materialIndex = data.materialIndex;
+    mesh.mesh = MESH_MANAGER->AddMesh(modelPath, index, data.vertices, data.indices, data.name);
+    return mesh;
+}
+
+void ModelLoader::ReadCooked(const CookedMesh& cooked, const std::string& modelPath, std::vector<ModelMesh>& meshes, std::vector<MaterialData>& materials, std::vector<NodeData>& nodes) {
+    for (uint32_t i = 0; i < cooked.GetSubmeshCount(); i++) {
+        meshes.push_back(LoadCookedMesh(cooked, i, modelPath));
+    }
+    for (uint32_t i = 0; i < cooked.GetMaterialCount(); i++) {
+        materials.push_back(cooked.GetMaterial(i));
+    }
+    for (uint32_t i = 0; i < cooked.GetNodeCount(); i++) {
+        nodes.push_back(cooked.GetNode(i));
+    }
+}
+
+void ModelLoader::InstantiateCooked(Scene* scene, const CookedMesh& cooked, GameObject* parent, const std::string& modelPath, const std::string& texturePath) {
+    std::vector<ModelMesh> meshes;
+    std::vector<MaterialData> materials;
+    std::vector<NodeData> nodes;
+    ReadCooked(cooked, modelPath, meshes, materials, nodes);
+
+    InstantiateModel(scene, meshes, LoadModelMaterials(modelPath, materials, texturePath), nodes, parent);
+}
+
+PrefabPtr ModelLoader::LoadPrefab(const std::string& path, const std::string& texturePath) {
+    PROFILE_SCOPE("ModelLoader::LoadPrefab");
+    const std::string key = ResourceId::FromPath(path).GetPath() + "|" + texturePath;
+    auto it = s_prefabs.find(key);
+    if (it != s_prefabs.end()) {
+        if (PrefabPtr prefab = it->second.lock()) {
+            return prefab;
+        }
+    }
+
+    // Prefabs are built from the cooked model only; the meshes are the ones LoadModel shares
+    const std::string cookedPath = ImportModel(path);
+    CookedMesh cooked;
+    if (cookedPath.empty() || !cooked.Open(cookedPath)) {
+        LOG_ERROR(Assets, "Failed to load prefab, model could not be cooked: {}", path);
+        return nullptr;
+    }
+
+    std::vector<ModelMesh> meshes;
+    std::vector<MaterialData> materials;
+    std::vector<NodeData> nodes;
+    ReadCooked(cooked, path, meshes, materials, nodes);
+
+    PrefabPtr prefab = BuildPrefab(path, texturePath, meshes, LoadModelMaterials(path, materials, ResolveTexturePath(path, texturePath)), nodes);
+    s_prefabs[key] = prefab;
+    LOG_INFO(Assets, "Loaded prefab {}: {} nodes, {} meshes", path, prefab->GetNodeCount(), prefab->GetMeshNodeCount());
+    return prefab;
+}
+
+PrefabPtr ModelLoader::BuildPrefab(const std::string& modelPath, const std::string& texturePath, const std::vector<ModelMesh>& meshes, const std::vector<MaterialPtr>& materials, const std::vector<NodeData>& nodes) {
+    // Same layout InstantiateModel creates: every mesh after a node's first becomes a child node
+    std::vector<PrefabNode> prefabNodes;
+    std::vector<int> remap(nodes.size(), -1);
+    prefabNodes.reserve(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const NodeData& node = nodes[i];
+        const int index = static_cast<int>(prefabNodes.size());
+        remap[i] = index;
+
+        PrefabNode prefabNode;
+        prefabNode.name = node.name;
+        prefabNode.parent = node.parent >= 0 ? remap[node.parent] : -1;
+        prefabNode.position = node.position;
+        prefabNode.rotation = node.rotation;
+        prefabNode.scale = node.scale;
+        prefabNodes.push_back(std::move(prefabNode));
+
+        bool first = true;
+        for (unsigned int meshIndex : node.meshes) {
+            const ModelMesh& mesh = meshes[meshIndex];
+            if (!mesh.mesh) continue;
+
+            PrefabNode* target = &prefabNodes[index];
+            if (!first) {
+                PrefabNode child;
+                child.name = mesh.name;
+                child.parent = index;
+                prefabNodes.push_back(std::move(child));
+                target = &prefabNodes.back();
+            }
+            first = false;
+
+            target->mesh = mesh.mesh;
+            if (mesh.materialIndex < materials.size()) {
+                target->material = materials[mesh.materialIndex];
+            }
+        }
+    }
+
+    const std::string name = std::filesystem::path(modelPath).stem().string();
+    return std::make_shared<const Prefab>(name, modelPath, texturePath, std::move(prefabNodes));
+}
+
+void ModelLoader::InstantiateModel(Scene* scene, const std::vector<ModelMesh>& meshes, const std::vector<MaterialPtr>& materials, const std::vector<NodeData>& nodes, GameObject* parent) {
+    PROFILE_SCOPE("ModelLoader::InstantiateModel");
+    // Nodes are stored parents first, so every parent exists by the time its children are created
+    std::vector<GameObject*> objects(nodes.size(), nullptr);
+    size_t instances = 0;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        GameObject* nodeParent = nodes[i].parent >= 0 ? objects[nodes[i].parent] : parent;
+        objects[i] = InstantiateNode(scene, nodes[i], nodeParent, meshes, materials);
+        instances += nodes[i].meshes.size();
+    }
+
+    LOG_DEBUG(Scene, "Instantiated {} nodes, {} mesh instances of {} meshes", nodes.size(), instances, meshes.size());
+}
+
+GameObject* ModelLoader::InstantiateNode(Scene* scene, const NodeData& node, GameObject* parent, const std::vector<ModelMesh>& meshes, const std::vector<MaterialPtr>& materials) {
+    // Create game object for this node
+    GameObject* gameObject = scene->CreateGameObject(node.name.c_str(), parent);
+
+    auto transform = gameObject->AddComponent<TransformComponent>();
+    transform->SetLocalPosition(node.position);
+    transform->SetLocalRotation(node.rotation);
+    transform->SetLocalScale(node.scale);
+
+    // An object draws a single mesh, so every mesh after the first gets a child of its own
+    for (size_t i = 0; i < node.meshes.size(); i++) {
+        const ModelMesh& mesh = meshes[node.meshes[i]];
+        if (!mesh.mesh) continue;
+
+        GameObject* target = gameObject;
+        if (i > 0) {
+            target = scene->CreateGameObject(mesh.name.c_str(), gameObject);
+            target->AddComponent<TransformComponent>();
+        }
+
+        // Shared with every other instance of this mesh
+        target->AddComponent<MeshComponent>()->SetMesh(mesh.mesh);
+
+        if (mesh.materialIndex < materials.size()) {
+            target->AddComponent<MaterialComponent>()->SetMaterial(materials[mesh.materialIndex]);
+        }
     }
-    std::cout << "Position: " << translation.x << ", " << translation.y << ", " << translation.z << std::endl;
-    std::cout << "Scale: " << scale.x << ", " << scale.y << ", " << scale.z << std::endl;
 
     return gameObject;
 }
 
-void ModelLoader::ProcessMesh(GameObject* gameObject, aiMesh* mesh, const aiScene* scene_ai, const std::string& texturePath) {
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
+bool ModelLoader::LoadMeshData(const std::string& path, unsigned int meshIndex, std::vector<StandardVertex>& vertices, std::vector<unsigned int>& indices) {
+    AssetRecord record;
+    if (ASSET_DATABASE->GetRecord(path, record) && !record.cookedPath.empty() && record.settingsHash == GetImportSettingsHash()) {
+        CookedMesh cooked;
+        if (cooked.Open(record.cookedPath) && meshIndex < cooked.GetSubmeshCount()) {
+            auto cookedVertices = cooked.GetVertices(meshIndex);
+            auto cookedIndices = cooked.GetIndices(meshIndex);
+            vertices.assign(cookedVertices.begin(), cookedVertices.end());
+            indices.assign(cookedIndices.begin(), cookedIndices.end());
+            return true;
+        }
+    }
 
-    // Print mesh info
-    std::cout << "Processing Mesh: " << mesh->mName.C_Str() << std::endl;
-    std::cout << "Number of Vertices: " << mesh->mNumVertices << std::endl;
-    std::cout << "Number of Faces: " << mesh->mNumFaces << std::endl;
+    Assimp::Importer importer;
+    importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
 
-    // Process vertices
-    vertices.reserve(mesh->mNumVertices);
-    for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
-        Vertex vertex;
+    const aiScene* scene_ai = importer.ReadFile(path, ImportFlags);
+    if (!scene_ai || scene_ai->mFlags & AI_SCENE_FLAGS_INCOMPLETE || meshIndex >= scene_ai->mNumMeshes) {
+        LOG_ERROR(Assets, "Assimp error: {}", importer.GetErrorString());
+        return false;
+    }
+
+    ExtractMeshData(scene_ai->mMeshes[meshIndex], vertices, indices);
+    return true;
+}
 
-        // Convert to GLM vectors
-        vertex.position = AssimpToGlm(mesh->mVertices[i]);
+void ModelLoader::ExtractNodes(const aiNode* node, int parent, std::vector<NodeData>& nodes) {
+    NodeData data;
+    data.name = node->mName.C_Str();
+    data.parent = parent;
+    data.meshes.assign(node->mMeshes, node->mMeshes + node->mNumMeshes);
+
+    aiVector3D scaling;
+    aiQuaternion rotation;
+    aiVector3D position;
+    node->mTransformation.Decompose(scaling, rotation, position);
+
+    // Vertices were rotated into engine space, so the local transform is conjugated by the same
+    // rotation. Being an axis permutation, it only reorders the scale.
+    data.position = vec3(ToEngineSpace(fvec3(position.x, position.y, position.z)));
+    data.rotation = EngineSpaceRotation * quat(rotation.w, rotation.x, rotation.y, rotation.z) * glm::conjugate(EngineSpaceRotation);
+    data.scale = vec3(scaling.y, scaling.z, scaling.x);
+
+    // Depth first, so parents always precede their children
+    const int index = static_cast<int>(nodes.size());
+    nodes.push_back(std::move(data));
+    for (unsigned int i = 0; i < node->mNumChildren; i++) {
+        ExtractNodes(node->mChildren[i], index, nodes);
+    }
+}
+
+MeshOptimizationReport ModelLoader::ExtractMeshData(const aiMesh* mesh, std::vector<StandardVertex>& vertices, std::vector<unsigned int>& indices) {
+    vertices.clear();
+    indices.clear();
+
+    // Write straight into the GPU layout, already in engine space
+    vertices.resize(mesh->mNumVertices);
+    for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
+        const aiVector3D& p = mesh->mVertices[i];
+        fvec3 normal(0.0f);
+        fvec2 texCoords(0.0f);
 
         if (mesh->HasNormals()) {
-            vertex.normal = glm::normalize(AssimpToGlm(mesh->mNormals[i]));
+            const aiVector3D& n = mesh->mNormals[i];
+            normal = glm::normalize(ToEngineSpace(fvec3(n.x, n.y, n.z)));
         }
 
         if (mesh->mTextureCoords[0]) {
-            vertex.texCoords.x = mesh->mTextureCoords[0][i].x;
-            vertex.texCoords.y = 1.0f - mesh->mTextureCoords[0][i].y;
+            texCoords.x = mesh->mTextureCoords[0][i].x;
+            texCoords.y = 1.0f - mesh->mTextureCoords[0][i].y;
         }
 
-        vertices.push_back(vertex);
+        VertexPacking::PackStandard(ToEngineSpace(fvec3(p.x, p.y, p.z)), normal, texCoords, vertices[i]);
     }
 
     // Process indices
@@ -186,67 +805,130 @@ void ModelLoader::ProcessMesh(GameObject* gameObject, aiMesh* mesh, const aiScen
         }
     }
 
-    // Create and setup components
-    auto meshComp = gameObject->AddComponent<MeshComponent>();
-    meshComp->SetMeshData(vertices, indices);
-
-    // Process material
-    if (mesh->mMaterialIndex >= 0) {
-        std::string customTexturePath = texturePath; // Specify your custom texture path
-        ProcessMaterial(gameObject, scene_ai->mMaterials[mesh->mMaterialIndex], customTexturePath);
-    }
-
-    std::cout << "Processing mesh with " << mesh->mNumVertices << " vertices and "
-        << mesh->mNumFaces << " faces" << std::endl;
-
+    // Weld duplicates and reorder for the post-transform cache, overdraw and vertex fetch.
+    // This replaces aiProcess_JoinIdenticalVertices, which only did the welding part.
+    return MeshOptimizer::Optimize(vertices, indices);
 }
 
-void ModelLoader::ProcessMaterial(GameObject* gameObject, aiMaterial* material, const std::string& texturePath) {
-    auto materialComp = gameObject->AddComponent<MaterialComponent>();
+MaterialData ModelLoader::ExtractMaterialData(const aiMaterial* material) {
+    MaterialData data;
 
     // Load material properties
     aiColor3D color(0.f, 0.f, 0.f);
 
-    if (material->Get(AI_MATKEY_COLOR_AMBIENT, color) == AI_SUCCESS)
-        materialComp->SetAmbient(AssimpToGlm(color));
+    if (material->Get(AI_MATKEY_COLOR_AMBIENT, color) == AI_SUCCESS) {
+        data.ambient = AssimpToGlm(color);
+        data.flags |= CookedMaterial_Ambient;
+    }
 
-    if (material->Get(AI_MATKEY_COLOR_DIFFUSE, color) == AI_SUCCESS)
-        materialComp->SetDiffuse(AssimpToGlm(color));
+    if (material->Get(AI_MATKEY_COLOR_DIFFUSE, color) == AI_SUCCESS) {
+        data.diffuse = AssimpToGlm(color);
+        data.flags |= CookedMaterial_Diffuse;
+    }
 
-    if (material->Get(AI_MATKEY_COLOR_SPECULAR, color) == AI_SUCCESS)
-        materialComp->SetSpecular(AssimpToGlm(color));
+    if (material->Get(AI_MATKEY_COLOR_SPECULAR, color) == AI_SUCCESS) {
+        data.specular = AssimpToGlm(color);
+        data.flags |= CookedMaterial_Specular;
+    }
 
     float shininess;
-    if (material->Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS)
-        materialComp->SetShininess(shininess / 128.0f); // Convert to 0-1 range
-
-    // Add debug logging
-    std::cout << "Processing material for: " << gameObject->GetName() << std::endl;
-    std::cout << "Custom texture path: " << texturePath << std::endl;
+    if (material->Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS) {
+        data.shininess = shininess / 128.0f; // Convert to 0-1 range
+        data.flags |= CookedMaterial_Shininess;
+    }
 
-    // Try loading texture
-    if (!texturePath.empty()) {
-        if (materialComp->SetDiffuseTexture(texturePath)) {
-            std::cout << "Successfully applied custom texture: " << texturePath << std::endl;
+    // Embedded texture path, used when no custom texture is given
+    if (material->GetTextureCount(aiTextureType_DIFFUSE) > 0) {
+        aiString path;
+        if (material->GetTexture(aiTextureType_DIFFUSE, 0, &path) == AI_SUCCESS) {
+            data.diffuseTexture = path.C_Str();
+            data.flags |= CookedMaterial_DiffuseTexture;
         }
-        else {
-            std::cerr << "Failed to apply custom texture: " << texturePath << std::endl;
+    }
+
+    return data;
+}
+
+std::string ModelLoader::GetMaterialTexturePath(const MaterialData& material, const std::string& texturePath) {
+    // A custom texture overrides the one embedded in the model
+    if (!texturePath.empty()) return texturePath;
+    if (material.flags & CookedMaterial_DiffuseTexture) return material.diffuseTexture;
+    return "";
+}
+
+std::vector<std::string> ModelLoader::GetAtlasTexturePaths(const std::vector<MaterialData>& materials, const std::string& texturePath) {
+    std::vector<std::string> paths;
+    for (const MaterialData& material : materials) {
+        std::string texPath = GetMaterialTexturePath(material, texturePath);
+        if (!texPath.empty() && (material.flags & CookedMaterial_UnitTexCoords)) {
+            paths.push_back(texPath);
         }
     }
+    return paths;
+}
+
+std::vector<MaterialPtr> ModelLoader::LoadModelMaterials(const std::string& modelPath, const std::vector<MaterialData>& materials, const std::string& texturePath,
+    PreparedAtlas* atlas) {
+    PROFILE_SCOPE("ModelLoader::LoadModelMaterials");
+    // Small textures only sampled inside 0-1 share atlas pages, so their materials bind the same texture
+    if (atlas) {
+        TEXTURE_MANAGER->AddAtlas(std::move(*atlas));
+    }
     else {
-        // Try to load embedded texture
-        if (material->GetTextureCount(aiTextureType_DIFFUSE) > 0) {
-            aiString path;
-            if (material->GetTexture(aiTextureType_DIFFUSE, 0, &path) == AI_SUCCESS) {
-                std::string texPath = path.C_Str();
-                std::cout << "Found embedded texture path: " << texPath << std::endl;
-                materialComp->SetDiffuseTexture(texPath);
-            }
-        }
-        else {
-            std::cout << "No texture found for material, using default" << std::endl;
-        }
+        TEXTURE_MANAGER->PackIntoAtlas(GetAtlasTexturePaths(materials, texturePath));
+    }
+
+    // Decode the rest in parallel up front; the materials below then hit the cache
+    std::vector<std::string> texturePaths;
+    for (const MaterialData& material : materials) {
+        std::string texPath = GetMaterialTexturePath(material, texturePath);
+        if (texPath.empty()) continue;
+        if ((material.flags & CookedMaterial_UnitTexCoords) && TEXTURE_MANAGER->GetAtlasTexture(texPath)) continue;
+        texturePaths.push_back(texPath);
+    }
+    TEXTURE_MANAGER->LoadTextures(texturePaths);
+
+    std::vector<MaterialPtr> shared;
+    shared.reserve(materials.size());
+    for (unsigned int i = 0; i < materials.size(); i++) {
+        shared.push_back(LoadModelMaterial(modelPath, i, materials[i], texturePath));
     }
+    return shared;
+}
+
+MaterialPtr ModelLoader::LoadModelMaterial(const std::string& modelPath, unsigned int index, const MaterialData& material, const std::string& texturePath) {
+    // A custom texture makes it a different material than the model's own
+    if (MaterialPtr cached = MATERIAL_MANAGER->GetMaterial(modelPath, index, texturePath)) {
+        return cached;
+    }
+
+    Material parameters;
+
+    if (material.flags & CookedMaterial_Ambient)
+        parameters.SetAmbient(material.ambient);
+
+    if (material.flags & CookedMaterial_Diffuse)
+        parameters.SetDiffuse(material.diffuse);
+
+    if (material.flags & CookedMaterial_Specular)
+        parameters.SetSpecular(material.specular);
+
+    if (material.flags & CookedMaterial_Shininess)
+        parameters.SetShininess(material.shininess);
+
+    // Try loading texture, once per material rather than once per mesh
+    std::string texPath = GetMaterialTexturePath(material, texturePath);
+    if (texPath.empty()) {
+        LOG_DEBUG(Material, "No texture found for material {}, using default", index);
+    }
+    else {
+        // Materials that keep their UVs inside 0-1 draw from the atlas page when the texture is packed
+        TexturePtr texture = (material.flags & CookedMaterial_UnitTexCoords) ? TEXTURE_MANAGER->GetAtlasTexture(texPath) : nullptr;
+        parameters.SetDiffuseTexture(texture ? texture : TEXTURE_MANAGER->LoadTexture(texPath), texPath);
+        LOG_DEBUG(Material, "Applied texture to material {}: {}", index, texPath);
+    }
+
+    return MATERIAL_MANAGER->AddMaterial(modelPath, index, parameters, texturePath);
 }
 
 vec3 ModelLoader::AssimpToGlm(const aiVector3D& v) {
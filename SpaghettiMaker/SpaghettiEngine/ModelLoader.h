@@ -1,21 +1,125 @@
 #pragma once
 #include "GameObject.h"
 #include "Scene.h"
+#include "MeshComponent.h"
+#include "MeshManager.h"
+#include "MaterialManager.h"
+#include "CookedMesh.h"
+#include "MeshOptimizer.h"
+#include "Prefab.h"
 #include <string>
 #include <vector>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+struct PreparedAtlas;
+
+enum class ModelLoadStatus {
+    Queued,
+    Importing, // Parsing, cooking and decoding on a worker thread
+    Uploading, // Waiting for the main thread to create objects and GL buffers
+    Done,
+    Failed,
+    Cancelled
+};
+
+// Shared state of one LoadModelAsync call. Status, progress and the cancel flag may be
+// read from any thread; the result and callback belong to the main thread.
+struct ModelLoadState {
+    std::string path;
+    std::atomic<ModelLoadStatus> status{ ModelLoadStatus::Queued };
+    std::atomic<float> progress{ 0.0f };
+    std::atomic<bool> cancelRequested{ false };
+    std::string error;              // Written before status becomes Failed
+    GameObject* result = nullptr;   // Valid once Done
+    std::function<void(GameObject*)> onComplete;
+
+    void Cancel() { cancelRequested = true; }
+    bool IsFinished() const {
+        ModelLoadStatus current = status.load();
+        return current == ModelLoadStatus::Done || current == ModelLoadStatus::Failed || current == ModelLoadStatus::Cancelled;
+    }
+};
+
+using ModelLoadHandle = std::shared_ptr<ModelLoadState>;
+
 class ModelLoader {
 public:
     // Add overloaded function that takes texture path
     static GameObject* LoadModel(Scene* scene, const std::string& path, const std::string& texturePath = "");
 
+    // Imports on the job system and uploads through the UploadQueue, a few meshes per frame.
+    // onComplete runs on the main thread with the root object once everything is uploaded.
+    static ModelLoadHandle LoadModelAsync(Scene* scene, const std::string& path, const std::string& texturePath = "",
+        std::function<void(GameObject*)> onComplete = nullptr);
+
+    // The model as a shared template (main thread only). Loaded once per model and texture path
+    // while any instance holds it; place it with Prefab::Instantiate.
+    static PrefabPtr LoadPrefab(const std::string& path, const std::string& texturePath = "");
+
+    // Cooks the model on the job system, then places one instance of its prefab from the
+    // UploadQueue. Only the first instance of a model builds the prefab; onComplete gets the instance.
+    static ModelLoadHandle InstantiatePrefabAsync(Scene* scene, const std::string& path, const std::string& texturePath = "",
+        std::function<void(GameObject*)> onComplete = nullptr);
+
+    // Loads started with LoadModelAsync that have not been cleared yet (main thread only)
+    static const std::vector<ModelLoadHandle>& GetActiveLoads() { return s_activeLoads; }
+    static void ClearFinishedLoads();
+    // Nothing waits for them: a worker stops at its next check, queued uploads bail out and
+    // whatever a load created so far is destroyed by its last upload
+    static void CancelAllLoads();
+
+    // Re-imports a single mesh of a model, producing the same data LoadModel gave the MeshComponent
+    static bool LoadMeshData(const std::string& path, unsigned int meshIndex, std::vector<StandardVertex>& vertices, std::vector<unsigned int>& indices);
+
+    // Cooks a model into the asset library if its source or the import settings changed.
+    // Returns the cooked file, or an empty string if the import failed.
+    static std::string ImportModel(const std::string& path);
+    static uint64_t GetImportSettingsHash();
+
+    // Converts every mesh, material and node of a parsed scene; meshes and materials are fanned out over the job system
+    static void ExtractScene(const aiScene* scene_ai, std::vector<MeshData>& meshes, std::vector<MaterialData>& materials, std::vector<NodeData>& nodes);
+
+    // Times ExtractScene on one model at 1, 2, 4... threads and prints the scaling
+    static void BenchmarkImport(const std::string& path, int repetitions = 5);
+
 private:
-    static GameObject* ProcessNode(Scene* scene, aiNode* node, const aiScene* scene_ai, GameObject* parent = nullptr, const std::string& texturePath="");
-    static void ProcessMesh(GameObject* gameObject, aiMesh* mesh, const aiScene* scene_ai, const std::string& texturePath = "");
-    static void ProcessMaterial(GameObject* gameObject, aiMaterial* material, const std::string& texturePath = "");
+    // One mesh of a model, uploaded once and drawn by every node that references it
+    struct ModelMesh {
+        MeshPtr mesh;
+        std::string name;
+        unsigned int materialIndex = 0;
+    };
+
+    static std::vector<ModelLoadHandle> s_activeLoads;
+    static std::unordered_map<std::string, std::weak_ptr<const Prefab>> s_prefabs; // By canonical path and texture path
+
+    static void RunAsyncLoad(Scene* scene, ModelLoadHandle state, const std::string& texturePath);
+    static std::string CookModel(const std::string& path, uint64_t settingsHash); // Parses and cooks unconditionally
+    static bool ParseModel(const std::string& path, std::vector<MeshData>& meshes, std::vector<MaterialData>& materials, std::vector<NodeData>& nodes); // Without cooking
+    static bool CookScene(const aiScene* scene_ai, const std::string& cookedPath);
+    static void InstantiateCooked(Scene* scene, const CookedMesh& cooked, GameObject* parent, const std::string& modelPath, const std::string& texturePath);
+    static void InstantiateModel(Scene* scene, const std::vector<ModelMesh>& meshes, const std::vector<MaterialPtr>& materials, const std::vector<NodeData>& nodes, GameObject* parent);
+    static GameObject* InstantiateNode(Scene* scene, const NodeData& node, GameObject* parent, const std::vector<ModelMesh>& meshes, const std::vector<MaterialPtr>& materials);
+    static void ReadCooked(const CookedMesh& cooked, const std::string& modelPath, std::vector<ModelMesh>& meshes, std::vector<MaterialData>& materials, std::vector<NodeData>& nodes);
+    static PrefabPtr BuildPrefab(const std::string& modelPath, const std::string& texturePath, const std::vector<ModelMesh>& meshes, const std::vector<MaterialPtr>& materials, const std::vector<NodeData>& nodes);
+    static ModelMesh LoadCookedMesh(const CookedMesh& cooked, uint32_t index, const std::string& modelPath);
+    static ModelMesh LoadParsedMesh(const MeshData& data, uint32_t index, const std::string& modelPath);
+
+    static void ExtractNodes(const aiNode* node, int parent, std::vector<NodeData>& nodes);
+    static MeshOptimizationReport ExtractMeshData(const aiMesh* mesh, std::vector<StandardVertex>& vertices, std::vector<unsigned int>& indices);
+    static MaterialData ExtractMaterialData(const aiMaterial* material);
+    static std::vector<MaterialPtr> LoadModelMaterials(const std::string& modelPath, const std::vector<MaterialData>& materials, const std::string& texturePath,
+        PreparedAtlas* atlas = nullptr); // Atlas read on a worker; read here when null
+    static std::vector<std::string> GetAtlasTexturePaths(const std::vector<MaterialData>& materials, const std::string& texturePath);
+    static MaterialPtr LoadModelMaterial(const std::string& modelPath, unsigned int index, const MaterialData& material, const std::string& texturePath);
+    static std::string GetMaterialTexturePath(const MaterialData& material, const std::string& texturePath);
+    static std::string ResolveTexturePath(const std::string& modelPath, const std::string& texturePath);
 
     // Conversion helpers
     static vec3 AssimpToGlm(const aiVector3D& v);
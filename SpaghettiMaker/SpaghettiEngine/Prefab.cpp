@@ -0,0 +1,66 @@
+#include "Prefab.h"
+#include "PrefabInstanceComponent.h"
+#include "Scene.h"
+#include "GameObject.h"
+#include "TransformComponent.h"
+#include "MeshComponent.h"
+#include "MaterialComponent.h"
+#include <iostream>
+
+Prefab::Prefab(const std::string& name, const std::string& sourcePath, const std::string& texturePath, std::vector<PrefabNode> nodes)
+    : _name(name), _sourcePath(sourcePath), _texturePath(texturePath), _nodes(std::move(nodes)) {
+    for (PrefabNode& node : _nodes) {
+        const mat4 local = glm::translate(mat4(1.0), node.position) * glm::mat4_cast(node.rotation) * glm::scale(mat4(1.0), node.scale);
+        node.prefabMatrix = node.parent >= 0 ? _nodes[node.parent].prefabMatrix * local : local;
+        if (node.mesh) ++_meshNodeCount;
+    }
+}
+
+PrefabPtr Prefab::FromGameObject(GameObject* root) {
+    std::vector<PrefabNode> nodes;
+
+    // Depth first without recursion, so parents are always stored before their children
+    std::vector<std::pair<GameObject*, int>> stack;
+    const auto& children = root->GetChildren();
+    for (auto it = children.rbegin(); it != children.rend(); ++it) {
+        stack.emplace_back(it->get(), -1);
+    }
+    while (!stack.empty()) {
+        auto [gameObject, parent] = stack.back();
+        stack.pop_back();
+
+        PrefabNode node;
+        node.name = gameObject->GetName();
+        node.parent = parent;
+        if (auto transform = gameObject->GetComponent<TransformComponent>()) {
+            node.position = transform->GetLocalPosition();
+            node.rotation = transform->GetLocalRotation();
+            node.scale = transform->GetLocalScale();
+        }
+        if (auto mesh = gameObject->GetComponent<MeshComponent>()) {
+            node.mesh = mesh->GetMesh();
+        }
+        if (auto material = gameObject->GetComponent<MaterialComponent>()) {
+            node.material = material->GetMaterial();
+        }
+
+        const int index = static_cast<int>(nodes.size());
+        nodes.push_back(std::move(node));
+
+        const auto& nodeChildren = gameObject->GetChildren();
+        for (auto it = nodeChildren.rbegin(); it != nodeChildren.rend(); ++it) {
+            stack.emplace_back(it->get(), index);
+        }
+    }
+
+    return std::make_shared<const Prefab>(root->GetName(), "", "", std::move(nodes));
+}
+
+GameObject* Prefab::Instantiate(Scene* scene, const PrefabPtr& prefab, GameObject* parent) {
+    if (!prefab) return nullptr;
+
+    GameObject* gameObject = scene->CreateGameObject(prefab->GetName().c_str(), parent);
+    gameObject->AddComponent<TransformComponent>();
+    gameObject->AddComponent<PrefabInstanceComponent>(prefab);
+    return gameObject;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "types.h"
+#include "Mesh.h"
+#include "Material.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class Scene;
+class GameObject;
+class Prefab;
+
+using PrefabPtr = std::shared_ptr<const Prefab>;
+
+// One object of a prefab. Like a loaded model, a node draws at most one mesh.
+struct PrefabNode {
+    std::string name;
+    int parent = -1; // Index of the parent node, -1 for the prefab root
+    vec3 position = vec3(0.0);
+    quat rotation = quat(1.0, 0.0, 0.0, 0.0);
+    vec3 scale = vec3(1.0);
+    mat4 prefabMatrix = mat4(1.0); // Node to prefab root, baked from the local transforms
+    MeshPtr mesh;
+    MaterialPtr material; // Default material when null
+};
+
+// A hierarchy captured as a template. Immutable once built and shared by every instance:
+// an instance is one GameObject with a transform and a PrefabInstanceComponent, which keeps
+// only the nodes it overrides.
+class Prefab {
+private:
+    std::string _name;
+    std::string _sourcePath;
+    std::string _texturePath; // As passed to ModelLoader::LoadPrefab, empty for the default textures
+    std::vector<PrefabNode> _nodes; // Parents before children
+    size_t _meshNodeCount = 0;
+
+public:
+    // Nodes must be stored parents first; prefab matrices are computed here
+    Prefab(const std::string& name, const std::string& sourcePath, const std::string& texturePath, std::vector<PrefabNode> nodes);
+
+    // Captures everything below root, relative to it; root's own transform is left to the instances
+    static PrefabPtr FromGameObject(GameObject* root);
+
+    // Creates an instance under parent, or the scene root if null
+    static GameObject* Instantiate(Scene* scene, const PrefabPtr& prefab, GameObject* parent = nullptr);
+
+    const std::string& GetName() const { return _name; }
+    const std::string& GetSourcePath() const { return _sourcePath; } // Empty unless built from a model
+    const std::string& GetTexturePath() const { return _texturePath; }
+    const std::vector<PrefabNode>& GetNodes() const { return _nodes; }
+    size_t GetNodeCount() const { return _nodes.size(); }
+    size_t GetMeshNodeCount() const { return _meshNodeCount; }
+};
@@ -0,0 +1,249 @@
+#include "PrefabInstanceComponent.h"
+#include "Scene.h"
+#include "GameObject.h"
+#include "TransformComponent.h"
+#include "MeshComponent.h"
+#include "MaterialComponent.h"
+#include "MaterialManager.h"
+#include "Renderer.h"
+#include "imgui.h"
+#include <algorithm>
+
+namespace {
+    mat4 ComposeMatrix(const vec3& position, const quat& rotation, const vec3& scale) {
+        return glm::translate(mat4(1.0), position) * glm::mat4_cast(rotation) * glm::scale(mat4(1.0), scale);
+    }
+}
+
+PrefabInstanceComponent::PrefabInstanceComponent(const PrefabPtr& prefab)
+    : Component("Prefab"), _prefab(prefab) {
+}
+
+void PrefabInstanceComponent::SetPrefab(const PrefabPtr& prefab) {
+    _prefab = prefab;
+    _overrides.clear();
+    _matrices.clear();
+}
+
+PrefabInstanceComponent::NodeOverride& PrefabInstanceComponent::EditNode(uint32_t node) {
+    auto it = _overrides.find(node);
+    if (it != _overrides.end()) return it->second;
+
+    // Starts out equal to the prefab, so setting one field leaves the others as they were
+    const PrefabNode& source = _prefab->GetNodes()[node];
+    NodeOverride& entry = _overrides[node];
+    entry.position = source.position;
+    entry.rotation = source.rotation;
+    entry.scale = source.scale;
+    return entry;
+}
+
+void PrefabInstanceComponent::DropIfUnchanged(uint32_t node) {
+    auto it = _overrides.find(node);
+    if (it != _overrides.end() && !it->second.hasTransform && !it->second.material && !it->second.hidden) {
+        _overrides.erase(it);
+    }
+}
+
+void PrefabInstanceComponent::RebuildMatrices() {
+    const bool anyTransform = std::any_of(_overrides.begin(), _overrides.end(),
+        [](const auto& entry) { return entry.second.hasTransform; });
+    if (!anyTransform) {
+        // Back to reading the prefab's matrices
+        _matrices.clear();
+        _matrices.shrink_to_fit();
+        return;
+    }
+
+    // An overridden node moves its whole subtree, so every matrix is recomputed
+    const auto& nodes = _prefab->GetNodes();
+    _matrices.resize(nodes.size());
+    for (uint32_t i = 0; i < nodes.size(); ++i) {
+        vec3 position;
+        quat rotation;
+        vec3 scale;
+        GetNodeTransform(i, position, rotation, scale);
+        const mat4 local = ComposeMatrix(position, rotation, scale);
+        _matrices[i] = nodes[i].parent >= 0 ? _matrices[nodes[i].parent] * local : local;
+    }
+}
+
+void PrefabInstanceComponent::SetNodeTransform(uint32_t node, const vec3& position, const quat& rotation, const vec3& scale) {
+    if (!_prefab || node >= _prefab->GetNodeCount()) return;
+
+    NodeOverride& entry = EditNode(node);
+    entry.hasTransform = true;
+    entry.position = position;
+    entry.rotation = rotation;
+    entry.scale = scale;
+    RebuildMatrices();
+}
+
+void PrefabInstanceComponent::SetNodeMaterial(uint32_t node, const MaterialPtr& material) {
+    if (!_prefab || node >= _prefab->GetNodeCount()) return;
+
+    EditNode(node).material = material == _prefab->GetNodes()[node].material ? nullptr : material;
+    DropIfUnchanged(node);
+}
+
+void PrefabInstanceComponent::SetNodeVisible(uint32_t node, bool visible) {
+    if (!_prefab || node >= _prefab->GetNodeCount()) return;
+
+    EditNode(node).hidden = !visible;
+    DropIfUnchanged(node);
+}
+
+void PrefabInstanceComponent::RevertNode(uint32_t node) {
+    if (_overrides.erase(node) > 0) {
+        RebuildMatrices();
+    }
+}
+
+void PrefabInstanceComponent::RevertAll() {
+    _overrides.clear();
+    _matrices.clear();
+    _matrices.shrink_to_fit();
+}
+
+const PrefabInstanceComponent::NodeOverride* PrefabInstanceComponent::GetOverride(uint32_t node) const {
+    auto it = _overrides.find(node);
+    return it != _overrides.end() ? &it->second : nullptr;
+}
+
+void PrefabInstanceComponent::GetNodeTransform(uint32_t node, vec3& position, quat& rotation, vec3& scale) const {
+    const NodeOverride* entry = GetOverride(node);
+    if (entry && entry->hasTransform) {
+        position = entry->position;
+        rotation = entry->rotation;
+        scale = entry->scale;
+        return;
+    }
+
+    const PrefabNode& source = _prefab->GetNodes()[node];
+    position = source.position;
+    rotation = source.rotation;
+    scale = source.scale;
+}
+
+const MaterialPtr& PrefabInstanceComponent::GetNodeMaterial(uint32_t node) const {
+    const NodeOverride* entry = GetOverride(node);
+    return entry && entry->material ? entry->material : _prefab->GetNodes()[node].material;
+}
+
+bool PrefabInstanceComponent::IsNodeVisible(uint32_t node) const {
+    const NodeOverride* entry = GetOverride(node);
+    return !entry || !entry->hidden;
+}
+
+const mat4& PrefabInstanceComponent::GetNodeMatrix(uint32_t node) const {
+    return _matrices.empty() ? _prefab->GetNodes()[node].prefabMatrix : _matrices[node];
+}
+
+void PrefabInstanceComponent::Submit(const mat4& world) const {
+    if (!_prefab) return;
+
+    const auto& nodes = _prefab->GetNodes();
+
+    // A hidden node hides its subtree, as an inactive object does. Overrides are rare, so most
+    // instances skip this and the lookups below entirely.
+    std::vector<char> hidden;
+    if (!_overrides.empty()) {
+        hidden.resize(nodes.size());
+        for (uint32_t i = 0; i < nodes.size(); ++i) {
+            hidden[i] = !IsNodeVisible(i) || (nodes[i].parent >= 0 && hidden[nodes[i].parent]);
+        }
+    }
+
+    MaterialPtr defaultMaterial;
+    for (uint32_t i = 0; i < nodes.size(); ++i) {
+        if (!nodes[i].mesh || (!hidden.empty() && hidden[i])) continue;
+
+        const NodeOverride* entry = _overrides.empty() ? nullptr : GetOverride(i);
+
+        const MaterialPtr& material = entry && entry->material ? entry->material : nodes[i].material;
+        const Material* shared = material.get();
+        if (!shared) {
+            if (!defaultMaterial) defaultMaterial = MATERIAL_MANAGER->GetDefaultMaterial();
+            shared = defaultMaterial.get();
+        }
+
+        const mat4& matrix = _matrices.empty() ? nodes[i].prefabMatrix : _matrices[i];
+        RENDERER->Submit(nodes[i].mesh.get(), shared, world * matrix);
+    }
+}
+
+void PrefabInstanceComponent::Unpack(Scene* scene) {
+    if (!_prefab || !_owner) return;
+
+    // Nodes are stored parents first, so every parent exists by the time its children are created
+    const auto& nodes = _prefab->GetNodes();
+    std::vector<GameObject*> objects(nodes.size(), nullptr);
+    for (uint32_t i = 0; i < nodes.size(); ++i) {
+        GameObject* parent = nodes[i].parent >= 0 ? objects[nodes[i].parent] : _owner;
+        GameObject* gameObject = scene->CreateGameObject(nodes[i].name.c_str(), parent);
+
+        vec3 position;
+        quat rotation;
+        vec3 scale;
+        GetNodeTransform(i, position, rotation, scale);
+        gameObject->AddComponent<TransformComponent>()->SetLocalTransform(position, rotation, scale);
+
+        if (nodes[i].mesh) {
+            gameObject->AddComponent<MeshComponent>()->SetMesh(nodes[i].mesh);
+        }
+        if (const MaterialPtr& material = GetNodeMaterial(i)) {
+            gameObject->AddComponent<MaterialComponent>()->SetMaterial(material);
+        }
+        if (!IsNodeVisible(i)) {
+            gameObject->SetActive(false);
+        }
+        objects[i] = gameObject;
+    }
+
+    SetPrefab(nullptr);
+}
+
+void PrefabInstanceComponent::OnInspectorGUI() {
+    if (!_prefab) {
+        ImGui::Text("No prefab");
+        return;
+    }
+
+    ImGui::Text("Prefab: %s", _prefab->GetName().c_str());
+    if (!_prefab->GetSourcePath().empty()) {
+        ImGui::TextWrapped("Source: %s", _prefab->GetSourcePath().c_str());
+    }
+    ImGui::Text("Nodes: %zu (%zu with meshes)", _prefab->GetNodeCount(), _prefab->GetMeshNodeCount());
+
+    // The prefab holds the data; this instance only what it changed
+    const long users = _prefab.use_count();
+    if (users > 1) {
+        ImGui::Text("Shared by %ld instances", users);
+    }
+    ImGui::Text("Overrides: %zu%s", _overrides.size(), _matrices.empty() ? "" : " (own transforms)");
+
+    if (ImGui::TreeNode("Nodes")) {
+        const auto& nodes = _prefab->GetNodes();
+        for (uint32_t i = 0; i < nodes.size(); ++i) {
+            ImGui::PushID(static_cast<int>(i));
+            bool visible = IsNodeVisible(i);
+            if (ImGui::Checkbox("##Visible", &visible)) {
+                SetNodeVisible(i, visible);
+            }
+            ImGui::SameLine();
+            ImGui::Text("%s%s", nodes[i].name.c_str(), GetOverride(i) ? " *" : "");
+            if (GetOverride(i)) {
+                ImGui::SameLine();
+                if (ImGui::SmallButton("Revert")) {
+                    RevertNode(i);
+                }
+            }
+            ImGui::PopID();
+        }
+        ImGui::TreePop();
+    }
+
+    if (!_overrides.empty() && ImGui::Button("Revert All")) {
+        RevertAll();
+    }
+}
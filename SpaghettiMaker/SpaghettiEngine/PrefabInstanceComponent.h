@@ -0,0 +1,66 @@
+#pragma once
+#include "Component.h"
+#include "Prefab.h"
+#include "types.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class Scene;
+
+// Draws a shared Prefab with the owner's transform. Every node reads the prefab's data until
+// the instance changes it: overrides are stored per node, and the node matrices are only copied
+// out of the prefab once a transform is overridden.
+class PrefabInstanceComponent : public Component {
+public:
+    struct NodeOverride {
+        bool hasTransform = false;
+        vec3 position = vec3(0.0);
+        quat rotation = quat(1.0, 0.0, 0.0, 0.0);
+        vec3 scale = vec3(1.0);
+        MaterialPtr material; // Prefab's material when null
+        bool hidden = false;
+    };
+
+private:
+    PrefabPtr _prefab;
+    std::unordered_map<uint32_t, NodeOverride> _overrides; // By node index, only nodes that differ
+    std::vector<mat4> _matrices; // Own node matrices; empty while no transform is overridden
+
+    NodeOverride& EditNode(uint32_t node);
+    void DropIfUnchanged(uint32_t node);
+    void RebuildMatrices();
+
+public:
+    explicit PrefabInstanceComponent(const PrefabPtr& prefab = nullptr);
+
+    // Component interface
+    void OnInspectorGUI() override;
+
+    // Shared template; replacing it reverts every override
+    void SetPrefab(const PrefabPtr& prefab);
+    const PrefabPtr& GetPrefab() const { return _prefab; }
+
+    // Overrides
+    void SetNodeTransform(uint32_t node, const vec3& position, const quat& rotation, const vec3& scale);
+    void SetNodeMaterial(uint32_t node, const MaterialPtr& material);
+    void SetNodeVisible(uint32_t node, bool visible);
+    void RevertNode(uint32_t node);
+    void RevertAll();
+    const NodeOverride* GetOverride(uint32_t node) const;
+    size_t GetOverrideCount() const { return _overrides.size(); }
+    bool OwnsMatrices() const { return !_matrices.empty(); }
+
+    // Node state with overrides applied
+    void GetNodeTransform(uint32_t node, vec3& position, quat& rotation, vec3& scale) const;
+    const MaterialPtr& GetNodeMaterial(uint32_t node) const;
+    bool IsNodeVisible(uint32_t node) const;
+    const mat4& GetNodeMatrix(uint32_t node) const; // Node to instance root
+
+    // Queues every visible node with the renderer
+    void Submit(const mat4& world) const;
+
+    // Turns the instance into ordinary objects under the owner, overrides applied, and detaches
+    // it from the prefab. For editing the structure, which an instance cannot change.
+    void Unpack(Scene* scene);
+};
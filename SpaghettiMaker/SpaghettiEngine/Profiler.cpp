@@ -0,0 +1,386 @@
+#include "Profiler.h"
+#include "Log.h"
+#include "imgui.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+Profiler* Profiler::s_instance = nullptr;
+std::atomic<uint64_t> Profiler::s_generation{ 0 };
+std::atomic<bool> Profiler::s_enabled{ true };
+
+namespace {
+    const float TimelineRowHeight = 18.0f;
+    const float FrameGraphHeight = 60.0f;
+    const double FrameGraphScaleMs = 33.3; // Full height; 30 FPS
+
+    // Same scope, same color, in every frame
+    ImU32 GetScopeColor(const char* name) {
+        static const ImU32 palette[] = {
+            IM_COL32(86, 156, 214, 255), IM_COL32(78, 201, 176, 255), IM_COL32(220, 220, 170, 255),
+            IM_COL32(206, 145, 120, 255), IM_COL32(197, 134, 192, 255), IM_COL32(156, 220, 254, 255),
+            IM_COL32(181, 206, 168, 255), IM_COL32(214, 157, 133, 255)
+        };
+        const size_t hash = std::hash<const void*>()(name);
+        return palette[(hash >> 4) % (sizeof(palette) / sizeof(palette[0]))];
+    }
+
+    void WriteJsonString(std::ofstream& out, const char* text) {
+        out << '"';
+        for (const char* c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') out << '\\';
+            out << *c;
+        }
+        out << '"';
+    }
+}
+
+Profiler::Profiler() {
+    _generation = ++s_generation;
+}
+
+Profiler::Ring* Profiler::GetThreadRing() {
+    // Registered once per thread; a ring outlives its thread and is freed with the profiler
+    thread_local uint64_t cachedGeneration = 0;
+    thread_local Ring* cachedRing = nullptr;
+    if (cachedGeneration == _generation) {
+        return cachedRing;
+    }
+
+    std::lock_guard<std::mutex> lock(_ringMutex);
+    _rings.push_back(std::make_unique<Ring>());
+    cachedRing = _rings.back().get();
+    cachedRing->index = static_cast<uint32_t>(_rings.size() - 1);
+    cachedRing->name = "Thread " + std::to_string(cachedRing->index);
+    cachedGeneration = _generation;
+    return cachedRing;
+}
+
+uint64_t Profiler::BeginScope() {
+    ++GetThreadRing()->depth;
+    return Now();
+}
+
+void Profiler::EndScope(const char* name, uint64_t start) {
+    const uint64_t end = Now();
+    Ring* ring = GetThreadRing();
+    --ring->depth;
+
+    const uint32_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= Ring::Capacity) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    ring->events[head & (Ring::Capacity - 1)] = { name, start, end, ring->index, ring->depth };
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::SetThreadName(const std::string& name) {
+    Ring* ring = GetThreadRing();
+    std::lock_guard<std::mutex> lock(_ringMutex);
+    ring->name = name;
+}
+
+void Profiler::EndFrame() {
+    const uint64_t now = Now();
+
+    ProfileFrame frame;
+    frame.index = _frameIndex++;
+    frame.start = _frameStart;
+    frame.end = now;
+    _frameStart = now;
+
+    std::vector<Ring*> rings;
+    {
+        std::lock_guard<std::mutex> lock(_ringMutex);
+        for (const auto& ring : _rings) {
+            rings.push_back(ring.get());
+        }
+    }
+
+    // Rings are emptied even while paused, so they never fill up and drop scopes
+    for (Ring* ring : rings) {
+        const uint32_t head = ring->head.load(std::memory_order_acquire);
+        uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+        if (!_paused) {
+            for (uint32_t i = tail; i != head; ++i) {
+                frame.events.push_back(ring->events[i & (Ring::Capacity - 1)]);
+            }
+        }
+        ring->tail.store(head, std::memory_order_release);
+    }
+    if (_paused) return;
+
+    // Scopes are recorded as they close, so children come before their parents until sorted
+    std::sort(frame.events.begin(), frame.events.end(), [](const ProfileEvent& a, const ProfileEvent& b) {
+        return a.start != b.start ? a.start < b.start : a.depth < b.depth;
+    });
+
+    _frames.push_back(std::move(frame));
+    while (_frames.size() > _maxFrames) {
+        _frames.pop_front();
+    }
+}
+
+bool Profiler::ExportChromeTrace(const std::string& path) {
+    std::error_code error;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        LOG_ERROR(General, "Failed to open trace for writing: {}", path);
+        return false;
+    }
+
+    // Timestamps are microseconds; "X" events carry their own duration
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) out << ",\n";
+        first = false;
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(_ringMutex);
+        for (const auto& ring : _rings) {
+            separator();
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->index << ",\"args\":{\"name\":";
+            WriteJsonString(out, ring->name.c_str());
+            out << "}}";
+        }
+    }
+
+    char number[64];
+    auto writeEvent = [&](const char* name, const char* category, uint64_t start, uint64_t end, uint32_t thread) {
+        separator();
+        out << "{\"name\":";
+        WriteJsonString(out, name);
+        std::snprintf(number, sizeof(number), "%.3f", start / 1e3);
+        out << ",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread << ",\"ts\":" << number;
+        std::snprintf(number, sizeof(number), "%.3f", (end - start) / 1e3);
+        out << ",\"dur\":" << number << "}";
+    };
+
+    // Frames go on the thread that ends them, around everything it did that frame
+    const uint32_t mainThread = GetThreadRing()->index;
+    size_t count = 0;
+    for (const ProfileFrame& frame : _frames) {
+        writeEvent("Frame", "frame", frame.start, frame.end, mainThread);
+        for (const ProfileEvent& event : frame.events) {
+            writeEvent(event.name, "cpu", event.start, event.end, event.thread);
+        }
+        count += frame.events.size();
+    }
+    out << "\n]}\n";
+
+    if (!out) {
+        LOG_ERROR(General, "Failed to write trace: {}", path);
+        return false;
+    }
+
+    LOG_INFO(General, "Exported {} frames, {} scopes to {}", _frames.size(), count, path);
+    return true;
+}
+
+void Profiler::OnInspectorGUI() {
+    bool enabled = IsEnabled();
+    if (ImGui::Checkbox("Capture", &enabled)) {
+        SetEnabled(enabled);
+    }
+    ImGui::SameLine();
+    ImGui::Checkbox("Pause", &_paused);
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome Trace")) {
+        const std::string path = "Profiles/trace_" + std::to_string(_frameIndex) + ".json";
+        _exportStatus = ExportChromeTrace(path) ? "Saved " + path : "Export failed";
+    }
+    if (!_exportStatus.empty()) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("%s", _exportStatus.c_str());
+    }
+    if (GetDroppedCount() > 0) {
+        ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.3f, 1.0f), "%llu scopes dropped, a thread's ring was full",
+            static_cast<unsigned long long>(GetDroppedCount()));
+    }
+
+    if (_frames.empty()) {
+        ImGui::Text("No frames recorded");
+        return;
+    }
+
+    DrawFrameGraph();
+
+    // The selected frame, or the latest while following
+    const ProfileFrame* frame = &_frames.back();
+    if (_selectedFrame >= 0) {
+        auto it = std::find_if(_frames.begin(), _frames.end(), [this](const ProfileFrame& f) { return int64_t(f.index) == _selectedFrame; });
+        if (it != _frames.end()) {
+            frame = &*it;
+        }
+        else {
+            _selectedFrame = -1;
+        }
+    }
+
+    ImGui::Text("Frame %llu: %.2f ms, %zu scopes", static_cast<unsigned long long>(frame->index), frame->GetDurationMs(), frame->events.size());
+    if (_selectedFrame >= 0) {
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Follow Latest")) {
+            _selectedFrame = -1;
+        }
+    }
+
+    DrawTimeline(*frame);
+    DrawScopeTable(*frame);
+}
+
+void Profiler::DrawFrameGraph() {
+    // One bar per frame, newest on the right; click a bar to inspect that frame
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    const float width = ImGui::GetContentRegionAvail().x;
+    const float barWidth = std::max(1.0f, width / _maxFrames);
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+    ImGui::InvisibleButton("##FrameGraph", ImVec2(width, FrameGraphHeight));
+    const bool clicked = ImGui::IsItemClicked();
+    const ImVec2 mouse = ImGui::GetMousePos();
+
+    drawList->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + FrameGraphHeight), IM_COL32(30, 30, 30, 255));
+    const float firstX = origin.x + width - barWidth * _frames.size();
+    for (size_t i = 0; i < _frames.size(); ++i) {
+        const ProfileFrame& frame = _frames[i];
+        const float x = firstX + barWidth * i;
+        const float height = static_cast<float>(std::min(frame.GetDurationMs() / FrameGraphScaleMs, 1.0)) * FrameGraphHeight;
+        const bool selected = int64_t(frame.index) == _selectedFrame;
+        const ImU32 color = selected ? IM_COL32(255, 255, 255, 255)
+            : frame.GetDurationMs() > 16.7 ? IM_COL32(220, 90, 70, 255) : IM_COL32(90, 180, 90, 255);
+        drawList->AddRectFilled(ImVec2(x, origin.y + FrameGraphHeight - height), ImVec2(x + barWidth - 1.0f, origin.y + FrameGraphHeight), color);
+
+        if (clicked && mouse.x >= x && mouse.x < x + barWidth) {
+            _selectedFrame = static_cast<int64_t>(frame.index);
+            _paused = true; // Otherwise the frame scrolls out of the history
+        }
+    }
+
+    // 60 FPS budget
+    const float budgetY = origin.y + FrameGraphHeight - static_cast<float>(16.7 / FrameGraphScaleMs) * FrameGraphHeight;
+    drawList->AddRect(ImVec2(origin.x, budgetY), ImVec2(origin.x + width, budgetY + 1.0f), IM_COL32(200, 200, 200, 120));
+}
+
+void Profiler::DrawTimeline(const ProfileFrame& frame) {
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(_ringMutex);
+        for (const auto& ring : _rings) {
+            names.push_back(ring->name);
+        }
+    }
+
+    // Rows per thread, as deep as its deepest scope this frame
+    std::vector<uint32_t> rows(names.size(), 0);
+    for (const ProfileEvent& event : frame.events) {
+        if (event.thread < rows.size()) {
+            rows[event.thread] = std::max(rows[event.thread], event.depth + 1);
+        }
+    }
+
+    const float labelWidth = 90.0f;
+    const double duration = static_cast<double>(std::max<uint64_t>(frame.end - frame.start, 1));
+    const float width = std::max(ImGui::GetContentRegionAvail().x - labelWidth, 50.0f);
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    const ImVec2 mouse = ImGui::GetMousePos();
+
+    for (size_t thread = 0; thread < names.size(); ++thread) {
+        if (rows[thread] == 0) continue;
+
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        const float height = rows[thread] * TimelineRowHeight;
+        ImGui::PushID(static_cast<int>(thread));
+        ImGui::InvisibleButton("##Thread", ImVec2(labelWidth + width, height));
+        const bool hovered = ImGui::IsItemHovered();
+        ImGui::PopID();
+
+        drawList->AddText(origin, IM_COL32(200, 200, 200, 255), names[thread].c_str());
+        const float left = origin.x + labelWidth;
+        drawList->AddRectFilled(ImVec2(left, origin.y), ImVec2(left + width, origin.y + height), IM_COL32(25, 25, 25, 255));
+        drawList->PushClipRect(ImVec2(left, origin.y), ImVec2(left + width, origin.y + height), true);
+
+        const ProfileEvent* tooltip = nullptr;
+        for (const ProfileEvent& event : frame.events) {
+            if (event.thread != thread) continue;
+
+            // Worker scopes may have started in an earlier frame; they are clipped to this one
+            const double begin = (static_cast<double>(event.start) - static_cast<double>(frame.start)) / duration;
+            const double end = (static_cast<double>(event.end) - static_cast<double>(frame.start)) / duration;
+            const ImVec2 min(left + static_cast<float>(std::max(begin, 0.0) * width), origin.y + event.depth * TimelineRowHeight);
+            const ImVec2 max(left + static_cast<float>(std::min(end, 1.0) * width), min.y + TimelineRowHeight - 1.0f);
+            if (max.x - min.x < 1.0f) continue;
+
+            drawList->AddRectFilled(min, max, GetScopeColor(event.name));
+            if (max.x - min.x > 30.0f) {
+                drawList->PushClipRect(min, max, true);
+                drawList->AddText(ImVec2(min.x + 2.0f, min.y + 1.0f), IM_COL32(0, 0, 0, 255), event.name);
+                drawList->PopClipRect();
+            }
+            if (hovered && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y) {
+                tooltip = &event;
+            }
+        }
+        drawList->PopClipRect();
+
+        if (tooltip) {
+            ImGui::SetTooltip("%s\n%.3f ms", tooltip->name, (tooltip->end - tooltip->start) / 1e6);
+        }
+    }
+}
+
+void Profiler::DrawScopeTable(const ProfileFrame& frame) {
+    struct ScopeStats {
+        const char* name = nullptr;
+        uint32_t calls = 0;
+        uint64_t total = 0;
+        uint64_t longest = 0;
+    };
+
+    // Literal names compare by pointer; the same text from two call sites stays two rows
+    std::unordered_map<const char*, ScopeStats> byName;
+    for (const ProfileEvent& event : frame.events) {
+        ScopeStats& stats = byName[event.name];
+        stats.name = event.name;
+        ++stats.calls;
+        stats.total += event.end - event.start;
+        stats.longest = std::max(stats.longest, event.end - event.start);
+    }
+
+    std::vector<ScopeStats> sorted;
+    for (const auto& [name, stats] : byName) {
+        sorted.push_back(stats);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const ScopeStats& a, const ScopeStats& b) { return a.total > b.total; });
+
+    if (ImGui::BeginTable("##Scopes", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Scope");
+        ImGui::TableSetupColumn("Calls");
+        ImGui::TableSetupColumn("Total ms");
+        ImGui::TableSetupColumn("Longest ms");
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < sorted.size() && i < 20; ++i) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(sorted[i].name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", sorted[i].calls);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", sorted[i].total / 1e6);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", sorted[i].longest / 1e6);
+        }
+        ImGui::EndTable();
+    }
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Scoped timers compiled out when SPAGHETTI_PROFILE is 0
+#ifndef SPAGHETTI_PROFILE
+#define SPAGHETTI_PROFILE 1
+#endif
+
+// One closed scope. Names are kept by pointer and must be literals.
+struct ProfileEvent {
+    const char* name;
+    uint64_t start;  // Nanoseconds since the profiler started
+    uint64_t end;
+    uint32_t thread; // Ring index
+    uint32_t depth;  // Scopes open around this one on its thread
+};
+
+struct ProfileFrame {
+    uint64_t index = 0;
+    uint64_t start = 0;
+    uint64_t end = 0;
+    std::vector<ProfileEvent> events; // Scopes that closed during the frame, any thread, by start time
+
+    double GetDurationMs() const { return (end - start) / 1e6; }
+};
+
+// Hierarchical CPU profiler. Scopes record into a ring per thread without locks; the main
+// thread collects them once per frame in EndFrame() and keeps the most recent frames for the
+// timeline and for export as a Chrome trace (chrome://tracing, Perfetto).
+class Profiler {
+private:
+    // Single producer (the owning thread), single consumer (EndFrame)
+    struct Ring {
+        static constexpr uint32_t Capacity = 8192; // Power of two
+        alignas(64) std::atomic<uint32_t> head{ 0 };
+        alignas(64) std::atomic<uint32_t> tail{ 0 };
+        uint32_t index = 0;
+        uint32_t depth = 0; // Owning thread only
+        std::string name;   // Guarded by _ringMutex
+        ProfileEvent events[Capacity];
+    };
+
+    static Profiler* s_instance;
+    static std::atomic<uint64_t> s_generation;
+    static std::atomic<bool> s_enabled;
+
+    std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+    uint64_t _generation = 0;
+
+    std::mutex _ringMutex; // Guards registration and thread names
+    std::vector<std::unique_ptr<Ring>> _rings;
+    std::atomic<uint64_t> _dropped{ 0 };
+
+    // Main thread
+    std::deque<ProfileFrame> _frames;
+    size_t _maxFrames = 300;
+    uint64_t _frameIndex = 0;
+    uint64_t _frameStart = 0;
+    bool _paused = false;
+    int64_t _selectedFrame = -1; // Frame index, -1 follows the latest
+    std::string _exportStatus;
+
+    Profiler();
+
+    Ring* GetThreadRing();
+    void DrawFrameGraph();
+    void DrawTimeline(const ProfileFrame& frame);
+    void DrawScopeTable(const ProfileFrame& frame);
+
+public:
+    static Profiler* GetInstance() {
+        if (!s_instance) {
+            s_instance = new Profiler();
+        }
+        return s_instance;
+    }
+
+    static void Destroy() {
+        delete s_instance;
+        s_instance = nullptr;
+    }
+
+    static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void SetEnabled(bool enabled) { s_enabled = enabled; }
+
+    uint64_t Now() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - _start).count());
+    }
+
+    // Used by ProfileScope
+    uint64_t BeginScope();
+    void EndScope(const char* name, uint64_t start);
+
+    // Shown in the timeline and the trace; call from the thread itself
+    void SetThreadName(const std::string& name);
+
+    // Main thread, once per frame: collects every thread's scopes into the frame that just ended
+    void EndFrame();
+
+    // Paused keeps the recorded frames as they are for inspection
+    void SetPaused(bool paused) { _paused = paused; }
+    bool IsPaused() const { return _paused; }
+    const std::deque<ProfileFrame>& GetFrames() const { return _frames; }
+    uint64_t GetDroppedCount() const { return _dropped.load(); }
+
+    // Every recorded frame as Chrome trace event JSON
+    bool ExportChromeTrace(const std::string& path);
+
+    // Editor GUI: frame graph, timeline of the selected frame and its most expensive scopes
+    void OnInspectorGUI();
+};
+
+#define PROFILER Profiler::GetInstance()
+
+// Times the rest of the enclosing block
+class ProfileScope {
+private:
+    const char* _name;
+    uint64_t _start = 0;
+    bool _active;
+
+public:
+    explicit ProfileScope(const char* name) : _name(name), _active(Profiler::IsEnabled()) {
+        if (_active) _start = PROFILER->BeginScope();
+    }
+    ~ProfileScope() {
+        if (_active) PROFILER->EndScope(_name, _start);
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if SPAGHETTI_PROFILE
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_FUNCTION() ((void)0)
+#endif
@@ -1,6 +1,14 @@
 // SpaghettiEngine/Graphics/Renderer.cpp
 #include "Renderer.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "Texture.h"
+#include "Profiler.h"
 #include "imgui.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <functional>
+#include <cmath>
 
 Renderer* Renderer::_instance = nullptr;
 
@@ -28,7 +36,12 @@ void Renderer::Initialize() {
 }
 
 void Renderer::Cleanup() {
-    // Cleanup renderer resources if needed
+    for (PassTimer& timer : _passTimers) {
+        if (timer.queries[0]) {
+            glDeleteQueries(TimerLatency, timer.queries);
+        }
+        timer = PassTimer();
+    }
 }
 
 void Renderer::BeginFrame() {
@@ -36,30 +49,220 @@ void Renderer::BeginFrame() {
 }
 
 void Renderer::EndFrame() {
-    // Any end-of-frame operations
+    ReadPassTimers();
+    _lastStats = _frameStats;
+    _frameStats = RenderStats();
+    ++_frameIndex;
+}
+
+void Renderer::CountDrawData(const ImDrawData* data) {
+    if (!data) return;
+
+    // The OpenGL3 backend streams every list's vertices and indices, then issues one draw
+    // with a texture bind per command
+    for (int i = 0; i < data->CmdListsCount; ++i) {
+        const ImDrawList* list = data->CmdLists[i];
+        for (int command = 0; command < list->CmdBuffer.Size; ++command) {
+            CountDraw(0, list->CmdBuffer[command].ElemCount / 3);
+            CountTextureBind();
+        }
+        CountBufferUpload(static_cast<uint64_t>(list->VtxBuffer.Size) * sizeof(ImDrawVert));
+        CountBufferUpload(static_cast<uint64_t>(list->IdxBuffer.Size) * sizeof(ImDrawIdx));
+    }
+    _frameStats.vertices += data->TotalVtxCount;
+}
+
+void Renderer::BeginPass(RenderPass pass) {
+    PassTimer& timer = _passTimers[static_cast<size_t>(pass)];
+    timer.cpuStart = std::chrono::steady_clock::now();
+    timer.timing = false;
+
+    if (_timerSupport < 0) {
+        _timerSupport = GLEW_VERSION_3_3 || GLEW_ARB_timer_query ? 1 : 0;
+    }
+
+    // Only one GL_TIME_ELAPSED query can be active, so a pass inside another gets its CPU time only
+    if (++_openPasses > 1 || _timerSupport == 0) return;
+
+    if (!timer.queries[0]) {
+        glGenQueries(TimerLatency, timer.queries);
+    }
+
+    const int slot = static_cast<int>(_frameIndex % TimerLatency);
+    if (timer.pending[slot]) {
+        // The GPU is more than TimerLatency frames behind; reading the old result now would stall
+        ++_skippedTimers;
+        return;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, timer.queries[slot]);
+    timer.issuedFrame[slot] = _frameIndex;
+    timer.timing = true;
+}
+
+void Renderer::EndPass(RenderPass pass) {
+    PassTimer& timer = _passTimers[static_cast<size_t>(pass)];
+    --_openPasses;
+    if (timer.timing) {
+        glEndQuery(GL_TIME_ELAPSED);
+        timer.pending[_frameIndex % TimerLatency] = true;
+        timer.timing = false;
+    }
+    timer.cpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timer.cpuStart).count();
+}
+
+void Renderer::ReadPassTimers() {
+    // Only results the GPU already has; the rest are picked up by a later frame
+    for (PassTimer& timer : _passTimers) {
+        for (int slot = 0; slot < TimerLatency; ++slot) {
+            if (!timer.pending[slot]) continue;
+
+            GLint available = 0;
+            glGetQueryObjectiv(timer.queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) continue;
+
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(timer.queries[slot], GL_QUERY_RESULT, &elapsed);
+            timer.pending[slot] = false;
+            if (timer.issuedFrame[slot] >= timer.resultFrame) {
+                timer.resultFrame = timer.issuedFrame[slot];
+                timer.gpuMs = elapsed / 1e6;
+            }
+        }
+    }
+}
+
+const char* Renderer::GetPassName(RenderPass pass) {
+    switch (pass) {
+    case RenderPass::Scene: return "Scene";
+    case RenderPass::Grid: return "Grid";
+    case RenderPass::UI: return "UI";
+    case RenderPass::Count: break;
+    }
+    return "Unknown";
+}
+
+void Renderer::Submit(const Mesh* mesh, const Material* material, const mat4& world, float normalLength) {
+    if (!mesh || !material || !mesh->IsUploaded()) return;
+    _renderQueue.push_back({ mesh, material, world, normalLength });
+}
+
+void Renderer::FlushRenderQueue() {
+    PROFILE_SCOPE("Renderer::FlushRenderQueue");
+    // Group by GL texture, then material identity, then mesh, so materials sharing an atlas
+    // page are drawn back to back and each material is applied once per frame
+    std::sort(_renderQueue.begin(), _renderQueue.end(), [](const RenderItem& a, const RenderItem& b) {
+        const unsigned int textureA = GetTextureID(a.material);
+        const unsigned int textureB = GetTextureID(b.material);
+        if (textureA != textureB) return textureA < textureB;
+        if (a.material != b.material) return std::less<const Material*>()(a.material, b.material);
+        return std::less<const Mesh*>()(a.mesh, b.mesh);
+    });
+
+    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    glEnable(GL_TEXTURE_2D);
+    glEnable(GL_LIGHTING);
+
+    RequestTextureMips();
+
+    const Material* applied = nullptr;
+    _lastMaterialBatches = 0;
+    for (const auto& item : _renderQueue) {
+        if (item.material != applied) {
+            item.material->Apply();
+            glColor4f(1.0f, 1.0f, 1.0f, 1.0f); // Reset color to prevent tinting
+            applied = item.material;
+            ++_lastMaterialBatches;
+        }
+
+        glPushMatrix();
+        glMultMatrixd(glm::value_ptr(item.world));
+        item.mesh->Draw();
+        if (item.normalLength > 0.0f) {
+            item.mesh->DrawNormals(item.normalLength);
+            applied = nullptr; // Normals change the material state
+        }
+        glPopMatrix();
+    }
+
+    // Atlas regions leave their UV transform in the texture matrix
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    glMatrixMode(GL_MODELVIEW);
+
+    glPopAttrib();
+    _renderQueue.clear();
+}
+
+unsigned int Renderer::GetTextureID(const Material* material) {
+    const TexturePtr& texture = material->GetDiffuseTexture();
+    return texture ? texture->GetBindID() : 0;
+}
+
+void Renderer::RequestTextureMips() {
+    // The modelview matrix still holds the camera view here
+    GLdouble view[16];
+    GLdouble projection[16];
+    GLint viewport[4];
+    glGetDoublev(GL_MODELVIEW_MATRIX, view);
+    glGetDoublev(GL_PROJECTION_MATRIX, projection);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    const mat4 viewMatrix = glm::make_mat4(view);
+    const double pixelsPerUnit = projection[5] * viewport[3] * 0.5; // Screen pixels per world unit at distance 1
+
+    const Material* material = nullptr;
+    Texture* texture = nullptr;
+    for (const auto& item : _renderQueue) {
+        if (item.material != material) {
+            material = item.material;
+            texture = material->GetDiffuseTexture().get();
+        }
+        if (!texture || texture->GetMipCount() < 2) continue;
+
+        // Bounding sphere in view space, scaled by the largest axis of the world matrix
+        const fvec3 boundsMin = item.mesh->GetBoundsMin();
+        const fvec3 boundsMax = item.mesh->GetBoundsMax();
+        const vec3 center = vec3((boundsMin + boundsMax) * 0.5f);
+        const double scale = std::max({ glm::length(vec3(item.world[0])), glm::length(vec3(item.world[1])), glm::length(vec3(item.world[2])) });
+        const double radius = glm::length(vec3(boundsMax - boundsMin)) * 0.5 * scale;
+        const double distance = glm::length(vec3(viewMatrix * item.world * glm::dvec4(center, 1.0)));
+
+        // Assume the texture spans the object once: one texel per covered pixel
+        int level = 0;
+        if (distance > radius && radius > 0.0) {
+            const double pixels = 2.0 * radius * pixelsPerUnit / distance;
+            const double texels = std::max(texture->GetWidth(), texture->GetHeight());
+            level = std::max(static_cast<int>(std::floor(std::log2(texels / std::max(pixels, 1.0)))), 0);
+        }
+        texture->RequestMip(level);
+    }
 }
 
 void Renderer::SetWireframeMode(bool enable) {
     _wireframeMode = enable;
     glPolygonMode(GL_FRONT_AND_BACK, enable ? GL_LINE : GL_FILL);
+    CountStateChange();
 }
 
 void Renderer::SetDepthTest(bool enable) {
     _depthTestEnabled = enable;
     if (enable) glEnable(GL_DEPTH_TEST);
     else glDisable(GL_DEPTH_TEST);
+    CountStateChange();
 }
 
 void Renderer::SetCullFace(bool enable) {
     _cullFaceEnabled = enable;
     if (enable) glEnable(GL_CULL_FACE);
     else glDisable(GL_CULL_FACE);
+    CountStateChange();
 }
 
 void Renderer::SetLighting(bool enable) {
     _lightingEnabled = enable;
     if (enable) glEnable(GL_LIGHTING);
     else glDisable(GL_LIGHTING);
+    CountStateChange();
 }
 
 void Renderer::OnInspectorGUI() {
@@ -84,4 +287,59 @@ void Renderer::OnInspectorGUI() {
             SetLighting(lighting);
         }
     }
+}
+
+void Renderer::OnStatsGUI() {
+    // The last complete frame; the counts of the frame being drawn are still growing
+    const RenderStats& stats = _lastStats;
+    ImGui::Text("Draw calls: %u", stats.drawCalls);
+    ImGui::Text("Triangles: %llu", static_cast<unsigned long long>(stats.triangles));
+    ImGui::Text("Vertices: %llu", static_cast<unsigned long long>(stats.vertices));
+    ImGui::Text("Texture binds: %u", stats.textureBinds);
+    ImGui::Text("State changes: %u (%zu material batches)", stats.stateChanges, _lastMaterialBatches);
+    ImGui::Text("Buffer uploads: %u (%.1f KB)", stats.bufferUploads, stats.uploadBytes / 1024.0);
+
+    if (!HasGpuTimers()) {
+        ImGui::TextDisabled("GPU timer queries are not supported, CPU times only");
+    }
+
+    double cpuTotal = 0.0;
+    double gpuTotal = 0.0;
+    if (ImGui::BeginTable("RenderPasses", 3)) {
+        ImGui::TableSetupColumn("Pass");
+        ImGui::TableSetupColumn("CPU ms");
+        ImGui::TableSetupColumn("GPU ms");
+        ImGui::TableHeadersRow();
+        for (size_t i = 0; i < static_cast<size_t>(RenderPass::Count); ++i) {
+            const PassTimer& timer = _passTimers[i];
+            cpuTotal += timer.cpuMs;
+            gpuTotal += timer.gpuMs;
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%s", GetPassName(static_cast<RenderPass>(i)));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", timer.cpuMs);
+            ImGui::TableNextColumn();
+            if (HasGpuTimers()) ImGui::Text("%.3f", timer.gpuMs);
+            else ImGui::TextDisabled("-");
+        }
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("Total");
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", cpuTotal);
+        ImGui::TableNextColumn();
+        if (HasGpuTimers()) ImGui::Text("%.3f", gpuTotal);
+        else ImGui::TextDisabled("-");
+        ImGui::EndTable();
+    }
+
+    if (HasGpuTimers()) {
+        // CPU time is submission only; GPU work taking longer means the driver is waiting on the GPU
+        ImGui::Text("Passes are %s bound", gpuTotal > cpuTotal ? "GPU" : "CPU submission");
+        ImGui::TextDisabled("GPU times are read back up to %d frames late", TimerLatency);
+        if (_skippedTimers > 0) {
+            ImGui::TextDisabled("Passes left untimed, GPU too far behind: %u", _skippedTimers);
+        }
+    }
 }
\ No newline at end of file
@@ -1,7 +1,41 @@
 #pragma once
 #include "types.h"
 #include <GL/glew.h>
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <vector>
+
+class Mesh;
+class Material;
+struct ImDrawData;
+
+// One draw waiting in the render queue. Pointers only need to live until FlushRenderQueue().
+struct RenderItem {
+    const Mesh* mesh;
+    const Material* material;
+    mat4 world;
+    float normalLength; // Debug normals are drawn when > 0
+};
+
+// What the CPU handed to the driver during one frame
+struct RenderStats {
+    uint32_t drawCalls = 0;
+    uint64_t triangles = 0;
+    uint64_t vertices = 0;
+    uint32_t textureBinds = 0;
+    uint32_t stateChanges = 0;  // Material applications and render state toggles
+    uint32_t bufferUploads = 0; // Vertex, index and texture data sent to the GPU
+    uint64_t uploadBytes = 0;
+};
+
+// Parts of the frame timed on the GPU. Passes follow one another; they cannot nest.
+enum class RenderPass : uint8_t {
+    Scene,
+    Grid,
+    UI,
+    Count
+};
 
 class Renderer {
 private:
@@ -13,8 +47,40 @@ private:
     bool _cullFaceEnabled = true;
     bool _lightingEnabled = true;
 
+    // GL_TIME_ELAPSED queries per pass, one per frame in flight. A result is read back once the
+    // GPU has it, a few frames later, so waiting on the GPU never stalls the frame.
+    static constexpr int TimerLatency = 4;
+    struct PassTimer {
+        GLuint queries[TimerLatency] = {};
+        uint64_t issuedFrame[TimerLatency] = {};
+        bool pending[TimerLatency] = {};
+        uint64_t resultFrame = 0;
+        double gpuMs = 0.0;  // Latest result read back
+        double cpuMs = 0.0;  // Submission time of the last frame
+        std::chrono::steady_clock::time_point cpuStart;
+        bool timing = false; // A query was started for the current frame
+    };
+
+    // Draws collected during the scene traversal, sorted by material before submission
+    std::vector<RenderItem> _renderQueue;
+    size_t _lastMaterialBatches = 0;
+
+    RenderStats _frameStats; // Being counted
+    RenderStats _lastStats;  // The last complete frame
+    PassTimer _passTimers[static_cast<size_t>(RenderPass::Count)];
+    uint64_t _frameIndex = 0;
+    int _openPasses = 0;
+    int _timerSupport = -1; // Unknown until the first pass, then 0 or 1
+    uint32_t _skippedTimers = 0; // Passes left untimed because their query was still in flight
+
     Renderer() = default;
 
+    void ReadPassTimers();
+
+    // Tells streamed textures how much detail their largest on-screen use needs
+    void RequestTextureMips();
+    static unsigned int GetTextureID(const Material* material); // GL texture the material binds, atlas page included
+
 public:
     static Renderer* GetInstance() {
         if (!_instance) _instance = new Renderer();
@@ -28,6 +94,34 @@ public:
     void BeginFrame();
     void EndFrame();
 
+    // Render queue
+    void Submit(const Mesh* mesh, const Material* material, const mat4& world, float normalLength = 0.0f);
+    void FlushRenderQueue();
+    size_t GetLastMaterialBatches() const { return _lastMaterialBatches; }
+
+    // Frame statistics, main thread only. EndFrame() publishes the counts and starts new ones.
+    void CountDraw(uint64_t vertices, uint64_t triangles) {
+        ++_frameStats.drawCalls;
+        _frameStats.vertices += vertices;
+        _frameStats.triangles += triangles;
+    }
+    void CountTextureBind() { ++_frameStats.textureBinds; }
+    void CountStateChange() { ++_frameStats.stateChanges; }
+    void CountBufferUpload(uint64_t bytes) {
+        ++_frameStats.bufferUploads;
+        _frameStats.uploadBytes += bytes;
+    }
+    void CountDrawData(const ImDrawData* data); // What the ImGui backend submits for the frame
+    const RenderStats& GetLastFrameStats() const { return _lastStats; }
+
+    // GPU and CPU time of a pass; see RenderPassScope
+    void BeginPass(RenderPass pass);
+    void EndPass(RenderPass pass);
+    bool HasGpuTimers() const { return _timerSupport == 1; }
+    double GetPassGpuMs(RenderPass pass) const { return _passTimers[static_cast<size_t>(pass)].gpuMs; }
+    double GetPassCpuMs(RenderPass pass) const { return _passTimers[static_cast<size_t>(pass)].cpuMs; }
+    static const char* GetPassName(RenderPass pass);
+
     // State management
     void SetWireframeMode(bool enable);
     void SetDepthTest(bool enable);
@@ -42,4 +136,19 @@ public:
 
     // Editor GUI
     void OnInspectorGUI();
-};
\ No newline at end of file
+    void OnStatsGUI(); // Frame statistics and pass timings
+};
+
+#define RENDERER Renderer::GetInstance()
+
+// Times the rest of the enclosing block as a render pass
+class RenderPassScope {
+private:
+    RenderPass _pass;
+
+public:
+    explicit RenderPassScope(RenderPass pass) : _pass(pass) { RENDERER->BeginPass(pass); }
+    ~RenderPassScope() { RENDERER->EndPass(_pass); }
+    RenderPassScope(const RenderPassScope&) = delete;
+    RenderPassScope& operator=(const RenderPassScope&) = delete;
+};
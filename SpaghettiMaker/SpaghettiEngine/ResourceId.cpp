@@ -0,0 +1,93 @@
+#include "ResourceId.h"
+#include "Log.h"
+#include "AssetDatabase.h"
+#include <filesystem>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace {
+    // Every id ever made, and the spellings FromPath has already canonicalised
+    struct InternTable {
+        std::shared_mutex mutex;
+        std::unordered_map<uint64_t, std::string> paths;
+        std::unordered_map<std::string, uint64_t> spellings;
+    };
+
+    InternTable& GetInternTable() {
+        static InternTable table;
+        return table;
+    }
+
+    uint64_t HashPath(const std::string& path) {
+        // FNV-1a, then a finalizer so the low bits are usable as a table index on their own
+        uint64_t hash = AssetDatabase::HashBytes(path.data(), path.size());
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ull;
+        hash ^= hash >> 33;
+        return hash != 0 ? hash : 1; // 0 is the invalid id
+    }
+
+    const std::string EmptyPath;
+}
+
+ResourceId ResourceId::FromPath(const std::string& path) {
+    if (path.empty()) return ResourceId();
+
+    InternTable& table = GetInternTable();
+    {
+        std::shared_lock<std::shared_mutex> lock(table.mutex);
+        auto it = table.spellings.find(path);
+        if (it != table.spellings.end()) {
+            return ResourceId(it->second);
+        }
+    }
+
+    // File system work outside the lock; a race only canonicalises the same spelling twice
+    ResourceId id = FromCanonical(Canonicalize(path));
+    std::unique_lock<std::shared_mutex> lock(table.mutex);
+    table.spellings.emplace(path, id._value);
+    return id;
+}
+
+ResourceId ResourceId::FromCanonical(const std::string& canonical) {
+    if (canonical.empty()) return ResourceId();
+
+    const uint64_t value = HashPath(canonical);
+    InternTable& table = GetInternTable();
+    {
+        std::shared_lock<std::shared_mutex> lock(table.mutex);
+        auto it = table.paths.find(value);
+        if (it != table.paths.end()) {
+            if (it->second != canonical) {
+                LOG_ERROR(Assets, "Resource id collision: {} and {}", canonical, it->second);
+            }
+            return ResourceId(value);
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(table.mutex);
+    table.paths.emplace(value, canonical);
+    return ResourceId(value);
+}
+
+std::string ResourceId::Canonicalize(const std::string& path) {
+    std::error_code error;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+    if (error) {
+        canonical = std::filesystem::absolute(path).lexically_normal();
+    }
+    return canonical.generic_string();
+}
+
+const std::string& ResourceId::GetPath() const {
+    if (!_value) return EmptyPath;
+
+    // Entries are never removed and unordered_map nodes don't move, so the reference stays valid
+    InternTable& table = GetInternTable();
+    std::shared_lock<std::shared_mutex> lock(table.mutex);
+    auto it = table.paths.find(_value);
+    return it != table.paths.end() ? it->second : EmptyPath;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Compact handle for an asset path. The path is canonicalised and hashed once, when the id is
+// made, and interned so the id can be turned back into it; after that, comparing or looking up
+// ids never touches a string. Safe to use from any thread.
+class ResourceId {
+private:
+    uint64_t _value = 0;
+
+    explicit ResourceId(uint64_t value) : _value(value) {}
+
+public:
+    ResourceId() = default;
+
+    // Canonical form (absolute, normalized, forward slashes), cached per spelling
+    static ResourceId FromPath(const std::string& path);
+    // Interns the string as is, for paths already canonical and built-in names like "__default"
+    static ResourceId FromCanonical(const std::string& canonical);
+    static std::string Canonicalize(const std::string& path);
+
+    const std::string& GetPath() const; // What the id was made from; empty for the invalid id
+    uint64_t GetValue() const { return _value; }
+    bool IsValid() const { return _value != 0; }
+
+    bool operator==(const ResourceId& other) const { return _value == other._value; }
+    bool operator!=(const ResourceId& other) const { return _value != other._value; }
+};
+
+// The value is already a well mixed 64-bit hash
+struct ResourceIdHash {
+    size_t operator()(const ResourceId& id) const { return static_cast<size_t>(id.GetValue()); }
+};
@@ -1,7 +1,15 @@
 #include "Scene.h"
 #include "imgui.h"
 #include "ModelLoader.h"
+#include "AssetDatabase.h"
+#include "MaterialManager.h"
+#include "Renderer.h"
+#include "SceneSerializer.h"
+#include "WorldStreamer.h"
+#include "PrefabInstanceComponent.h"
+#include "Profiler.h"
 #include <algorithm>
+#include <unordered_set>
 #include <iostream>
 #include <filesystem>
 #include <GL/glew.h>
@@ -34,6 +42,7 @@ void Scene::Start() {
 }
 
 void Scene::Update() {
+    PROFILE_SCOPE("Scene::Update");
     if (!_isPlaying || _isPaused) return;
 
     // Update starting from root
@@ -67,6 +76,7 @@ GameObject* Scene::CreateGameObject(const char* name, GameObject* parent) {
 }
 
 void Scene::Render() {
+    PROFILE_SCOPE("Scene::Render");
     if (!_root) return;
 
     // Save current OpenGL state
@@ -88,6 +98,7 @@ void Scene::Render() {
 
     // Render all game objects
     RenderGameObject(_root);
+    RENDERER->FlushRenderQueue();
 
     // Restore OpenGL state
     glPopMatrix();
@@ -164,22 +175,29 @@ void Scene::RenderGameObject(GameObject* gameObject) {
             glVertex3d(0, 0, 1);
 
             glEnd();
+            RENDERER->CountDraw(6, 0);
             glEnable(GL_LIGHTING);
         }
     }
 
-    // Render mesh and material if they exist
+    // Queue mesh and material if they exist; the renderer draws them grouped by material
     auto mesh = gameObject->GetComponent<MeshComponent>();
     auto material = gameObject->GetComponent<MaterialComponent>();
+    auto transform = gameObject->GetComponent<TransformComponent>();
 
-    if (mesh) {
-        // The mesh component will handle its own rendering
-        mesh->OnUpdate(); // This will trigger the mesh rendering
-
+    if (mesh && mesh->GetMesh() && transform) {
+        MaterialPtr shared = material ? material->GetMaterial() : MATERIAL_MANAGER->GetDefaultMaterial();
+        RENDERER->Submit(mesh->GetMesh().get(), shared.get(), transform->GetWorldMatrix(),
+            mesh->GetShowNormals() ? mesh->GetNormalLength() : 0.0f);
+    }
+    // Prefab instances draw the shared nodes directly, there are no objects for them
+    if (transform) {
+        if (auto prefab = gameObject->GetComponent<PrefabInstanceComponent>()) {
+            prefab->Submit(transform->GetWorldMatrix());
+        }
     }
     if (material)
     {
-        material->OnUpdate();
 		material->SetActive(true);
     }
 
@@ -212,22 +230,35 @@ void Scene::HandleFileDrop(const char* path) {
     // Convert to lowercase for comparison
     std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
 
-    if (extension == ".fbx") {
-        // Load the model
-        GameObject* loadedModel = ModelLoader::LoadModel(this,path,path);
-        if (loadedModel) {
-            std::cout << "Successfully loaded model: " << path << std::endl;
+    if (extension == SceneSerializer::GetExtension()) {
+        // Replaces everything in this scene, streamed cells included
+        WORLD_STREAMER->Close();
+        if (!SceneSerializer::Load(this, path)) {
+            std::cerr << "Failed to load scene: " << path << std::endl;
+        }
+    }
+    else if (extension == ".fbx") {
+        // Load the model in the background so the editor keeps running
+        std::cout << "Loading model in background: " << path << std::endl;
+        auto onLoaded = [this](GameObject* loadedModel) {
             // Auto-focus on the newly loaded model
             FocusOnGameObject(loadedModel);
             // Set it as selected object
             SetSelectedGameObject(loadedModel);
+        };
+        if (_dropModelsAsPrefabs) {
+            // Every drop of the same model shares its meshes, materials and nodes
+            ModelLoader::InstantiatePrefabAsync(this, path, "", onLoaded);
         }
         else {
-            std::cerr << "Failed to load model: " << path << std::endl;
+            ModelLoader::LoadModelAsync(this, path, path, onLoaded);
         }
     }
     // For texture frop
-    else if (extension == ".png" || extension == ".dds") {
+    else if (extension == ".png" || extension == ".tga" || extension == ".dds") {
+        // Track the texture so later loads resolve through the asset library
+        ASSET_DATABASE->Import(path);
+
         // Handle texture drop - apply to selected object
         if (_selectedGameObject) {
             auto material = _selectedGameObject->GetComponent<MaterialComponent>();
@@ -250,25 +281,47 @@ void Scene::HandleFileDrop(const char* path) {
 
 void Scene::DestroyGameObject(GameObject* gameObject) {
     if (!gameObject) return;
+    DestroyGameObjects(std::span<GameObject* const>(&gameObject, 1));
+}
 
-    // First, destroy all children
-    auto children = gameObject->GetChildren();
-    for (const auto& child : children) {
-        DestroyGameObject(child.get());
+void Scene::DestroyGameObjects(std::span<GameObject* const> gameObjects) {
+    // Every object in every subtree, so the scene's list is filtered once for the whole batch
+    std::unordered_set<GameObject*> destroyed;
+    std::vector<GameObject*> pending(gameObjects.begin(), gameObjects.end());
+    while (!pending.empty()) {
+        GameObject* gameObject = pending.back();
+        pending.pop_back();
+        if (!gameObject || !destroyed.insert(gameObject).second) continue;
+        for (const auto& child : gameObject->GetChildren()) {
+            pending.push_back(child.get());
+        }
+    }
+    if (destroyed.count(_selectedGameObject)) {
+        _selectedGameObject = nullptr;
     }
 
-    // Remove from parent
-    if (GameObject* parent = gameObject->GetParent()) {
-        gameObject->SetParent(nullptr);
+    // Remove from parent; children stay attached and go together with their parent
+    for (GameObject* gameObject : gameObjects) {
+        if (gameObject && gameObject->GetParent()) {
+            gameObject->SetParent(nullptr);
+        }
     }
 
     // Remove from scene's GameObject list
     _gameObjects.erase(
         std::remove_if(_gameObjects.begin(), _gameObjects.end(),
-            [gameObject](const auto& go) { return go.get() == gameObject; }),
+            [&destroyed](const auto& go) { return destroyed.count(go.get()) > 0; }),
         _gameObjects.end());
 }
 
+void Scene::Clear() {
+    // The hierarchy and the object list share ownership, so dropping both frees everything
+    // at once instead of searching the list for every object
+    _root->ClearChildren();
+    _gameObjects.clear();
+    _selectedGameObject = nullptr;
+}
+
 void Scene::DrawHierarchyNode(GameObject* node) {
     if (!node) return;
 
@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <span>
 #include <unordered_map>
 #include "RendererComponent.h"
 #include "Camera.h"
@@ -22,6 +23,9 @@ private:
 
     bool _showDebug = false;
 
+    // Dropped models become instances of one shared prefab instead of a full hierarchy each
+    bool _dropModelsAsPrefabs = true;
+
 public:
     Scene(const char* name = "New Scene");
     ~Scene();
@@ -38,11 +42,16 @@ public:
     void Pause(bool pause);
 
     void HandleFileDrop(const char* path);
+    void SetDropModelsAsPrefabs(bool enabled) { _dropModelsAsPrefabs = enabled; }
+    bool GetDropModelsAsPrefabs() const { return _dropModelsAsPrefabs; }
     void Render();
 
     // GameObject management
     GameObject* CreateGameObject(const char* name = "GameObject", GameObject* parent = nullptr);
     void DestroyGameObject(GameObject* gameObject);
+    void DestroyGameObjects(std::span<GameObject* const> gameObjects); // With their children, in one pass over the scene
+    void Clear(); // Destroys every GameObject but the root
+    void ReserveGameObjects(size_t count) { _gameObjects.reserve(_gameObjects.size() + count); }
 
     // Scene hierarchy
     GameObject* GetRoot() const { return _root; }
@@ -56,6 +65,7 @@ public:
     bool IsPlaying() const { return _isPlaying; }
     bool IsPaused() const { return _isPaused; }
     const std::string& GetName() const { return _name; }
+    void SetName(const std::string& name) { _name = name; }
 
 	void FocusOnGameObject(GameObject* gameObject);
 
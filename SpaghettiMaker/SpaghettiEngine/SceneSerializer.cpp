@@ -0,0 +1,751 @@
+#include "SceneSerializer.h"
+#include "Log.h"
+#include "Scene.h"
+#include "GameObject.h"
+#include "TransformComponent.h"
+#include "MeshComponent.h"
+#include "MaterialComponent.h"
+#include "PrefabInstanceComponent.h"
+#include "MeshManager.h"
+#include "MaterialManager.h"
+#include "ModelLoader.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+namespace {
+    uint64_t AlignOffset(uint64_t offset) {
+        return (offset + SceneFileAlignment - 1) & ~uint64_t(SceneFileAlignment - 1);
+    }
+
+    void PadTo(std::ofstream& out, uint64_t offset) {
+        static const char zeros[SceneFileAlignment] = {};
+        uint64_t position = static_cast<uint64_t>(out.tellp());
+        if (offset > position) {
+            out.write(zeros, static_cast<std::streamsize>(offset - position));
+        }
+    }
+
+    template <typename T>
+    void WriteTable(std::ofstream& out, uint64_t offset, const std::vector<T>& table) {
+        PadTo(out, offset);
+        out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(T));
+    }
+
+    SceneString AddString(std::string& blob, const std::string& value) {
+        SceneString entry = { static_cast<uint32_t>(blob.size()), static_cast<uint32_t>(value.size()) };
+        blob += value;
+        return entry;
+    }
+
+    void StoreVec3(double dest[3], const vec3& v) {
+        dest[0] = v.x;
+        dest[1] = v.y;
+        dest[2] = v.z;
+    }
+
+    vec3 LoadVec3(const double source[3]) {
+        return vec3(source[0], source[1], source[2]);
+    }
+
+    // Every table, blob and cross reference is checked up front, so loading can trust them
+    bool Validate(const MappedFile& file, const std::string& path) {
+        const size_t size = file.GetSize();
+        if (size < sizeof(SceneFileHeader)) return false;
+
+        const unsigned char* data = file.GetData();
+        const SceneFileHeader* header = reinterpret_cast<const SceneFileHeader*>(data);
+        if (header->magic != SceneFileMagic) {
+            LOG_ERROR(Scene, "Not a scene file: {}", path);
+            return false;
+        }
+        if (header->version != SceneFileVersion) {
+            LOG_ERROR(Scene, "Unsupported scene file version {}: {}", header->version, path);
+            return false;
+        }
+
+        auto inFile = [size](uint64_t offset, uint64_t length) {
+            return offset <= size && length <= size - offset;
+        };
+        if (!inFile(header->objectTableOffset, uint64_t(header->objectCount) * sizeof(SceneObject)) ||
+            !inFile(header->transformTableOffset, uint64_t(header->transformCount) * sizeof(SceneTransform)) ||
+            !inFile(header->meshComponentTableOffset, uint64_t(header->meshComponentCount) * sizeof(SceneMeshComponent)) ||
+            !inFile(header->materialComponentTableOffset, uint64_t(header->materialComponentCount) * sizeof(SceneMaterialComponent)) ||
+            !inFile(header->meshTableOffset, uint64_t(header->meshCount) * sizeof(SceneMesh)) ||
+            !inFile(header->materialTableOffset, uint64_t(header->materialCount) * sizeof(SceneMaterial)) ||
+            !inFile(header->prefabTableOffset, uint64_t(header->prefabCount) * sizeof(ScenePrefab)) ||
+            !inFile(header->prefabNodeTableOffset, uint64_t(header->prefabNodeCount) * sizeof(ScenePrefabNode)) ||
+            !inFile(header->prefabInstanceTableOffset, uint64_t(header->prefabInstanceCount) * sizeof(ScenePrefabInstance)) ||
+            !inFile(header->prefabOverrideTableOffset, uint64_t(header->prefabOverrideCount) * sizeof(ScenePrefabOverride)) ||
+            !inFile(header->vertexDataOffset, header->vertexDataSize) ||
+            !inFile(header->indexDataOffset, header->indexDataSize) ||
+            !inFile(header->stringDataOffset, header->stringDataSize)) {
+            LOG_ERROR(Scene, "Scene file is truncated: {}", path);
+            return false;
+        }
+
+        auto validString = [header](const SceneString& string) {
+            return uint64_t(string.offset) + string.length <= header->stringDataSize;
+        };
+        auto validIndex = [](uint32_t index, uint32_t count) {
+            return index == SceneFileNone || index < count;
+        };
+
+        // Parents must come first so the hierarchy can be built in one pass
+        const SceneObject* objects = reinterpret_cast<const SceneObject*>(data + header->objectTableOffset);
+        for (uint32_t i = 0; i < header->objectCount; ++i) {
+            const SceneObject& object = objects[i];
+            if (!validString(object.name) || !(object.parent == SceneFileNone || object.parent < i) ||
+                !validIndex(object.transform, header->transformCount) ||
+                !validIndex(object.meshComponent, header->meshComponentCount) ||
+                !validIndex(object.materialComponent, header->materialComponentCount) ||
+                !validIndex(object.prefabInstance, header->prefabInstanceCount)) {
+                LOG_ERROR(Scene, "Scene file has an invalid object table: {}", path);
+                return false;
+            }
+        }
+
+        const SceneMeshComponent* meshComponents = reinterpret_cast<const SceneMeshComponent*>(data + header->meshComponentTableOffset);
+        for (uint32_t i = 0; i < header->meshComponentCount; ++i) {
+            if (meshComponents[i].mesh >= header->meshCount) {
+                LOG_ERROR(Scene, "Scene file has an invalid mesh component: {}", path);
+                return false;
+            }
+        }
+
+        const SceneMaterialComponent* materialComponents = reinterpret_cast<const SceneMaterialComponent*>(data + header->materialComponentTableOffset);
+        for (uint32_t i = 0; i < header->materialComponentCount; ++i) {
+            if (materialComponents[i].material >= header->materialCount) {
+                LOG_ERROR(Scene, "Scene file has an invalid material component: {}", path);
+                return false;
+            }
+        }
+
+        const uint64_t vertexCount = header->vertexDataSize / sizeof(StandardVertex);
+        const uint64_t indexCount = header->indexDataSize / sizeof(unsigned int);
+        const SceneMesh* meshes = reinterpret_cast<const SceneMesh*>(data + header->meshTableOffset);
+        for (uint32_t i = 0; i < header->meshCount; ++i) {
+            const SceneMesh& mesh = meshes[i];
+            if (!validString(mesh.path) || !validString(mesh.name) ||
+                uint64_t(mesh.firstVertex) + mesh.vertexCount > vertexCount ||
+                uint64_t(mesh.firstIndex) + mesh.indexCount > indexCount) {
+                LOG_ERROR(Scene, "Scene file has an invalid mesh table: {}", path);
+                return false;
+            }
+        }
+
+        const SceneMaterial* materials = reinterpret_cast<const SceneMaterial*>(data + header->materialTableOffset);
+        for (uint32_t i = 0; i < header->materialCount; ++i) {
+            if (!validString(materials[i].texturePath) || !validString(materials[i].name)) {
+                LOG_ERROR(Scene, "Scene file has an invalid material table: {}", path);
+                return false;
+            }
+        }
+
+        const ScenePrefab* prefabs = reinterpret_cast<const ScenePrefab*>(data + header->prefabTableOffset);
+        for (uint32_t i = 0; i < header->prefabCount; ++i) {
+            const ScenePrefab& prefab = prefabs[i];
+            if (!validString(prefab.path) || !validString(prefab.texturePath) || !validString(prefab.name) ||
+                uint64_t(prefab.firstNode) + prefab.nodeCount > header->prefabNodeCount) {
+                LOG_ERROR(Scene, "Scene file has an invalid prefab table: {}", path);
+                return false;
+            }
+        }
+
+        // Stored prefabs are built as they are, so their nodes must already be in order
+        const ScenePrefabNode* prefabNodes = reinterpret_cast<const ScenePrefabNode*>(data + header->prefabNodeTableOffset);
+        for (uint32_t i = 0; i < header->prefabCount; ++i) {
+            for (uint32_t j = 0; j < prefabs[i].nodeCount; ++j) {
+                const ScenePrefabNode& node = prefabNodes[prefabs[i].firstNode + j];
+                if (!validString(node.name) || !(node.parent == SceneFileNone || node.parent < j) ||
+                    node.transform >= header->transformCount ||
+                    !validIndex(node.mesh, header->meshCount) ||
+                    !validIndex(node.material, header->materialCount)) {
+                    LOG_ERROR(Scene, "Scene file has an invalid prefab node: {}", path);
+                    return false;
+                }
+            }
+        }
+
+        const ScenePrefabInstance* instances = reinterpret_cast<const ScenePrefabInstance*>(data + header->prefabInstanceTableOffset);
+        for (uint32_t i = 0; i < header->prefabInstanceCount; ++i) {
+            const ScenePrefabInstance& instance = instances[i];
+            if (instance.prefab >= header->prefabCount ||
+                uint64_t(instance.firstOverride) + instance.overrideCount > header->prefabOverrideCount) {
+                LOG_ERROR(Scene, "Scene file has an invalid prefab instance: {}", path);
+                return false;
+            }
+        }
+
+        // Node indices are checked against the prefab once it is loaded, the source may have changed
+        const ScenePrefabOverride* overrides = reinterpret_cast<const ScenePrefabOverride*>(data + header->prefabOverrideTableOffset);
+        for (uint32_t i = 0; i < header->prefabOverrideCount; ++i) {
+            if (!validIndex(overrides[i].transform, header->transformCount) ||
+                !validIndex(overrides[i].material, header->materialCount)) {
+                LOG_ERROR(Scene, "Scene file has an invalid prefab override: {}", path);
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+bool SceneSerializer::Save(const Scene* scene, const std::string& path) {
+    std::vector<GameObject*> roots;
+    for (const auto& child : scene->GetRoot()->GetChildren()) {
+        roots.push_back(child.get());
+    }
+    return Save(roots, path);
+}
+
+bool SceneSerializer::Save(const std::vector<GameObject*>& roots, const std::string& path) {
+    std::vector<SceneObject> objects;
+    std::vector<SceneTransform> transforms;
+    std::vector<SceneMeshComponent> meshComponents;
+    std::vector<SceneMaterialComponent> materialComponents;
+    std::vector<SceneMesh> meshes;
+    std::vector<SceneMaterial> materials;
+    std::vector<ScenePrefab> prefabs;
+    std::vector<ScenePrefabNode> prefabNodes;
+    std::vector<ScenePrefabInstance> prefabInstances;
+    std::vector<ScenePrefabOverride> prefabOverrides;
+    std::vector<StandardVertex> vertices;
+    std::vector<unsigned int> indices;
+    std::string strings;
+
+    // Shared resources are written once and referenced by index
+    std::unordered_map<const Mesh*, uint32_t> meshIndices;
+    std::unordered_map<const Material*, uint32_t> materialIndices;
+    std::unordered_map<const Prefab*, uint32_t> prefabIndices;
+
+    auto addMesh = [&](const MeshPtr& mesh) {
+        auto it = meshIndices.find(mesh.get());
+        if (it != meshIndices.end()) return it->second;
+
+        SceneMesh entry = {};
+        entry.name = AddString(strings, mesh->GetName());
+        if (!mesh->GetSourcePath().empty() && mesh->GetSourceMeshIndex() >= 0) {
+            // Loaded again from the cooked model
+            const ResourceId id = ResourceId::FromPath(mesh->GetSourcePath());
+            entry.assetId = id.GetValue();
+            entry.path = AddString(strings, id.GetPath());
+            entry.meshIndex = static_cast<uint32_t>(mesh->GetSourceMeshIndex());
+        }
+        else if (mesh->HasCPUData()) {
+            // Procedural; nothing to reload it from, so the geometry goes into the file
+            entry.meshIndex = SceneFileNone;
+            entry.firstVertex = static_cast<uint32_t>(vertices.size());
+            entry.vertexCount = static_cast<uint32_t>(mesh->GetVertices().size());
+            entry.firstIndex = static_cast<uint32_t>(indices.size());
+            entry.indexCount = static_cast<uint32_t>(mesh->GetIndices().size());
+            vertices.insert(vertices.end(), mesh->GetVertices().begin(), mesh->GetVertices().end());
+            indices.insert(indices.end(), mesh->GetIndices().begin(), mesh->GetIndices().end());
+        }
+        else {
+            LOG_WARNING(Scene, "Mesh has no source asset and no CPU copy, not saved: {}", mesh->GetName());
+            meshIndices[mesh.get()] = SceneFileNone;
+            return SceneFileNone;
+        }
+
+        const uint32_t index = static_cast<uint32_t>(meshes.size());
+        meshes.push_back(entry);
+        meshIndices[mesh.get()] = index;
+        return index;
+    };
+
+    auto addMaterial = [&](const MaterialPtr& material) {
+        auto it = materialIndices.find(material.get());
+        if (it != materialIndices.end()) return it->second;
+
+        SceneMaterial entry = {};
+        entry.name = AddString(strings, material->GetName());
+        entry.flags = material->IsUsingCheckerTexture() ? static_cast<uint32_t>(SceneMaterial_Checker) : uint32_t(0);
+        if (!material->IsUsingCheckerTexture() && !material->GetTexturePath().empty()) {
+            const ResourceId id = ResourceId::FromPath(material->GetTexturePath());
+            entry.textureId = id.GetValue();
+            entry.texturePath = AddString(strings, id.GetPath());
+        }
+        StoreVec3(entry.ambient, material->GetAmbient());
+        StoreVec3(entry.diffuse, material->GetDiffuse());
+        StoreVec3(entry.specular, material->GetSpecular());
+        entry.shininess = material->GetShininess();
+
+        const uint32_t index = static_cast<uint32_t>(materials.size());
+        materials.push_back(entry);
+        materialIndices[material.get()] = index;
+        return index;
+    };
+
+    auto addTransform = [&](const vec3& position, const glm::dquat& rotation, const vec3& scale) {
+        SceneTransform entry = {};
+        StoreVec3(entry.position, position);
+        entry.rotation[0] = rotation.x;
+        entry.rotation[1] = rotation.y;
+        entry.rotation[2] = rotation.z;
+        entry.rotation[3] = rotation.w;
+        StoreVec3(entry.scale, scale);
+        transforms.push_back(entry);
+        return static_cast<uint32_t>(transforms.size() - 1);
+    };
+
+    // Prefabs from a model are stored as their source; prefabs packed in the editor have none
+    // to load them from, so their nodes are written once and shared by every instance
+    auto addPrefab = [&](const Prefab& prefab) {
+        auto it = prefabIndices.find(&prefab);
+        if (it != prefabIndices.end()) return it->second;
+
+        ScenePrefab entry = {};
+        entry.name = AddString(strings, prefab.GetName());
+        entry.firstNode = static_cast<uint32_t>(prefabNodes.size());
+        if (!prefab.GetSourcePath().empty()) {
+            const ResourceId id = ResourceId::FromPath(prefab.GetSourcePath());
+            entry.assetId = id.GetValue();
+            entry.path = AddString(strings, id.GetPath());
+            entry.texturePath = AddString(strings, prefab.GetTexturePath());
+        }
+        else {
+            for (const PrefabNode& node : prefab.GetNodes()) {
+                ScenePrefabNode nodeEntry = {};
+                nodeEntry.name = AddString(strings, node.name);
+                nodeEntry.parent = node.parent >= 0 ? static_cast<uint32_t>(node.parent) : SceneFileNone;
+                nodeEntry.transform = addTransform(node.position, node.rotation, node.scale);
+                nodeEntry.mesh = node.mesh ? addMesh(node.mesh) : SceneFileNone;
+                nodeEntry.material = node.material ? addMaterial(node.material) : SceneFileNone;
+                prefabNodes.push_back(nodeEntry);
+            }
+            entry.nodeCount = static_cast<uint32_t>(prefabNodes.size()) - entry.firstNode;
+        }
+
+        const uint32_t index = static_cast<uint32_t>(prefabs.size());
+        prefabs.push_back(entry);
+        prefabIndices[&prefab] = index;
+        return index;
+    };
+
+    // Instances store the prefab and the nodes they override
+    auto addPrefabInstance = [&](const PrefabInstanceComponent& instance) {
+        const PrefabPtr& prefab = instance.GetPrefab();
+
+        ScenePrefabInstance entry = {};
+        entry.prefab = addPrefab(*prefab);
+        entry.firstOverride = static_cast<uint32_t>(prefabOverrides.size());
+        for (uint32_t i = 0; i < prefab->GetNodeCount(); ++i) {
+            const PrefabInstanceComponent::NodeOverride* nodeOverride = instance.GetOverride(i);
+            if (!nodeOverride) continue;
+
+            ScenePrefabOverride overrideEntry = {};
+            overrideEntry.node = i;
+            overrideEntry.flags = nodeOverride->hidden ? static_cast<uint32_t>(ScenePrefabOverride_Hidden) : uint32_t(0);
+            overrideEntry.transform = nodeOverride->hasTransform ? addTransform(nodeOverride->position, nodeOverride->rotation, nodeOverride->scale) : SceneFileNone;
+            overrideEntry.material = nodeOverride->material ? addMaterial(nodeOverride->material) : SceneFileNone;
+            prefabOverrides.push_back(overrideEntry);
+        }
+        entry.overrideCount = static_cast<uint32_t>(prefabOverrides.size()) - entry.firstOverride;
+        prefabInstances.push_back(entry);
+        return static_cast<uint32_t>(prefabInstances.size() - 1);
+    };
+
+    // Depth first without recursion, so parents are always written before their children
+    std::vector<std::pair<GameObject*, uint32_t>> stack;
+    for (auto it = roots.rbegin(); it != roots.rend(); ++it) {
+        stack.emplace_back(*it, SceneFileNone);
+    }
+    while (!stack.empty()) {
+        auto [gameObject, parent] = stack.back();
+        stack.pop_back();
+
+        SceneObject object = {};
+        object.name = AddString(strings, gameObject->GetName());
+        object.parent = parent;
+        object.flags = gameObject->IsActive() ? static_cast<uint32_t>(SceneObject_Active) : uint32_t(0);
+        object.transform = SceneFileNone;
+        object.meshComponent = SceneFileNone;
+        object.materialComponent = SceneFileNone;
+        object.prefabInstance = SceneFileNone;
+
+        if (auto transform = gameObject->GetComponent<TransformComponent>()) {
+            object.transform = addTransform(transform->GetLocalPosition(), transform->GetLocalRotation(), transform->GetLocalScale());
+        }
+
+        auto meshComponent = gameObject->GetComponent<MeshComponent>();
+        if (meshComponent && meshComponent->GetMesh()) {
+            const uint32_t mesh = addMesh(meshComponent->GetMesh());
+            if (mesh != SceneFileNone) {
+                SceneMeshComponent entry = {};
+                entry.mesh = mesh;
+                entry.flags = meshComponent->GetShowNormals() ? static_cast<uint32_t>(SceneMeshComponent_ShowNormals) : uint32_t(0);
+                entry.normalLength = meshComponent->GetNormalLength();
+                object.meshComponent = static_cast<uint32_t>(meshComponents.size());
+                meshComponents.push_back(entry);
+            }
+        }
+
+        if (auto materialComponent = gameObject->GetComponent<MaterialComponent>()) {
+            SceneMaterialComponent entry = {};
+            entry.material = addMaterial(materialComponent->GetMaterial());
+            object.materialComponent = static_cast<uint32_t>(materialComponents.size());
+            materialComponents.push_back(entry);
+        }
+
+        auto prefab = gameObject->GetComponent<PrefabInstanceComponent>();
+        if (prefab && prefab->GetPrefab()) {
+            object.prefabInstance = addPrefabInstance(*prefab);
+        }
+
+        const uint32_t index = static_cast<uint32_t>(objects.size());
+        objects.push_back(object);
+
+        const auto& children = gameObject->GetChildren();
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            stack.emplace_back(it->get(), index);
+        }
+    }
+
+    SceneFileHeader header = {};
+    header.magic = SceneFileMagic;
+    header.version = SceneFileVersion;
+    header.objectCount = static_cast<uint32_t>(objects.size());
+    header.transformCount = static_cast<uint32_t>(transforms.size());
+    header.meshComponentCount = static_cast<uint32_t>(meshComponents.size());
+    header.materialComponentCount = static_cast<uint32_t>(materialComponents.size());
+    header.meshCount = static_cast<uint32_t>(meshes.size());
+    header.materialCount = static_cast<uint32_t>(materials.size());
+    header.prefabCount = static_cast<uint32_t>(prefabs.size());
+    header.prefabInstanceCount = static_cast<uint32_t>(prefabInstances.size());
+    header.prefabOverrideCount = static_cast<uint32_t>(prefabOverrides.size());
+    header.prefabNodeCount = static_cast<uint32_t>(prefabNodes.size());
+
+    // Lay out the file, every section aligned
+    header.objectTableOffset = AlignOffset(sizeof(SceneFileHeader));
+    header.transformTableOffset = AlignOffset(header.objectTableOffset + objects.size() * sizeof(SceneObject));
+    header.meshComponentTableOffset = AlignOffset(header.transformTableOffset + transforms.size() * sizeof(SceneTransform));
+    header.materialComponentTableOffset = AlignOffset(header.meshComponentTableOffset + meshComponents.size() * sizeof(SceneMeshComponent));
+    header.meshTableOffset = AlignOffset(header.materialComponentTableOffset + materialComponents.size() * sizeof(SceneMaterialComponent));
+    header.materialTableOffset = AlignOffset(header.meshTableOffset + meshes.size() * sizeof(SceneMesh));
+    header.prefabTableOffset = AlignOffset(header.materialTableOffset + materials.size() * sizeof(SceneMaterial));
+    header.prefabNodeTableOffset = AlignOffset(header.prefabTableOffset + prefabs.size() * sizeof(ScenePrefab));
+    header.prefabInstanceTableOffset = AlignOffset(header.prefabNodeTableOffset + prefabNodes.size() * sizeof(ScenePrefabNode));
+    header.prefabOverrideTableOffset = AlignOffset(header.prefabInstanceTableOffset + prefabInstances.size() * sizeof(ScenePrefabInstance));
+    header.vertexDataOffset = AlignOffset(header.prefabOverrideTableOffset + prefabOverrides.size() * sizeof(ScenePrefabOverride));
+    header.vertexDataSize = vertices.size() * sizeof(StandardVertex);
+    header.indexDataOffset = AlignOffset(header.vertexDataOffset + header.vertexDataSize);
+    header.indexDataSize = indices.size() * sizeof(unsigned int);
+    header.stringDataOffset = AlignOffset(header.indexDataOffset + header.indexDataSize);
+    header.stringDataSize = strings.size();
+
+    std::error_code error;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    // Write to a temporary file first so a failed save never replaces a good scene
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOG_ERROR(Scene, "Failed to open scene for writing: {}", tempPath);
+            return false;
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        WriteTable(out, header.objectTableOffset, objects);
+        WriteTable(out, header.transformTableOffset, transforms);
+        WriteTable(out, header.meshComponentTableOffset, meshComponents);
+        WriteTable(out, header.materialComponentTableOffset, materialComponents);
+        WriteTable(out, header.meshTableOffset, meshes);
+        WriteTable(out, header.materialTableOffset, materials);
+        WriteTable(out, header.prefabTableOffset, prefabs);
+        WriteTable(out, header.prefabNodeTableOffset, prefabNodes);
+        WriteTable(out, header.prefabInstanceTableOffset, prefabInstances);
+        WriteTable(out, header.prefabOverrideTableOffset, prefabOverrides);
+        WriteTable(out, header.vertexDataOffset, vertices);
+        WriteTable(out, header.indexDataOffset, indices);
+        PadTo(out, header.stringDataOffset);
+        out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+        if (!out) {
+            LOG_ERROR(Scene, "Failed to write scene: {}", tempPath);
+            out.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        LOG_ERROR(Scene, "Failed to replace scene {}: {}", path, error.message());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+
+    LOG_INFO(Scene, "Saved scene {}: {} objects, {} meshes, {} materials, {} prefabs", path, objects.size(), meshes.size(), materials.size(), prefabs.size());
+    return true;
+}
+
+bool SceneSerializer::Load(Scene* scene, const std::string& path) {
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    std::unique_ptr<PreparedScene> prepared = Prepare(path);
+    if (!prepared) return false;
+    ResolveResources(*prepared);
+
+    // Background loads parent their objects under ones the clear is about to drop; once
+    // cancelled they find their root gone and create nothing more
+    ModelLoader::CancelAllLoads();
+
+    scene->Clear();
+    scene->SetName(std::filesystem::path(path).stem().string());
+    scene->ReserveGameObjects(prepared->GetObjectCount());
+    while (!prepared->IsInstantiated()) {
+        InstantiateNext(scene, *prepared);
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    LOG_INFO(Scene, "Loaded scene {}: {} objects, {} meshes, {} materials in {:.1f} ms", path, prepared->_header->objectCount, prepared->_header->meshCount, prepared->_header->materialCount, seconds * 1000.0);
+    return true;
+}
+
+std::unique_ptr<PreparedScene> SceneSerializer::Prepare(const std::string& path) {
+    auto prepared = std::make_unique<PreparedScene>();
+    prepared->_path = path;
+    if (!prepared->_file.Open(path)) {
+        LOG_ERROR(Scene, "Failed to open scene: {}", path);
+        return nullptr;
+    }
+    if (!Validate(prepared->_file, path)) return nullptr;
+
+    const unsigned char* data = prepared->_file.GetData();
+    const SceneFileHeader* header = reinterpret_cast<const SceneFileHeader*>(data);
+    prepared->_header = header;
+    prepared->_objects = reinterpret_cast<const SceneObject*>(data + header->objectTableOffset);
+    prepared->_transforms = reinterpret_cast<const SceneTransform*>(data + header->transformTableOffset);
+    prepared->_meshComponents = reinterpret_cast<const SceneMeshComponent*>(data + header->meshComponentTableOffset);
+    prepared->_materialComponents = reinterpret_cast<const SceneMaterialComponent*>(data + header->materialComponentTableOffset);
+    prepared->_meshes = reinterpret_cast<const SceneMesh*>(data + header->meshTableOffset);
+    prepared->_materials = reinterpret_cast<const SceneMaterial*>(data + header->materialTableOffset);
+    prepared->_prefabs = reinterpret_cast<const ScenePrefab*>(data + header->prefabTableOffset);
+    prepared->_prefabNodes = reinterpret_cast<const ScenePrefabNode*>(data + header->prefabNodeTableOffset);
+    prepared->_prefabInstances = reinterpret_cast<const ScenePrefabInstance*>(data + header->prefabInstanceTableOffset);
+    prepared->_prefabOverrides = reinterpret_cast<const ScenePrefabOverride*>(data + header->prefabOverrideTableOffset);
+    prepared->_vertices = reinterpret_cast<const StandardVertex*>(data + header->vertexDataOffset);
+    prepared->_indices = reinterpret_cast<const unsigned int*>(data + header->indexDataOffset);
+    prepared->_strings = reinterpret_cast<const char*>(data + header->stringDataOffset);
+
+    // Every model and texture once. Whether they are resident already is only known on the
+    // main thread, so a texture that is gets decoded for nothing; the upload is still skipped.
+    std::vector<std::string> modelPaths;
+    std::vector<uint64_t> modelIds;
+    for (uint32_t i = 0; i < header->meshCount; ++i) {
+        const SceneMesh& mesh = prepared->_meshes[i];
+        if (mesh.assetId != 0 && prepared->_models.emplace(mesh.assetId, nullptr).second) {
+            modelIds.push_back(mesh.assetId);
+            modelPaths.push_back(prepared->GetString(mesh.path));
+        }
+    }
+    // Prefab sources are only cooked here; LoadPrefab builds them on the main thread
+    std::vector<std::string> prefabPaths;
+    for (uint32_t i = 0; i < header->prefabCount; ++i) {
+        const ScenePrefab& prefab = prepared->_prefabs[i];
+        if (prefab.assetId != 0 && !prepared->_models.contains(prefab.assetId)) {
+            prefabPaths.push_back(prepared->GetString(prefab.path));
+        }
+    }
+    for (uint32_t i = 0; i < header->materialCount; ++i) {
+        const SceneMaterial& material = prepared->_materials[i];
+        if (material.textureId == 0) continue;
+        const ResourceId id = ResourceId::FromCanonical(prepared->GetString(material.texturePath));
+        if (std::none_of(prepared->_textures.begin(), prepared->_textures.end(), [id](const auto& texture) { return texture.first == id; })) {
+            prepared->_textures.emplace_back(id, PreparedTexture());
+        }
+    }
+    prepared->_texturePrepared.assign(prepared->_textures.size(), 0);
+
+    // Models cook or open, textures decode, all on the workers
+    std::vector<std::unique_ptr<CookedMesh>> models(modelPaths.size());
+    const size_t modelJobs = modelPaths.size() + prefabPaths.size();
+    JOB_SYSTEM->ParallelFor(modelJobs + prepared->_textures.size(), [&](size_t i) {
+        if (i < modelPaths.size()) {
+            std::string cookedPath = ModelLoader::ImportModel(modelPaths[i]);
+            auto model = std::make_unique<CookedMesh>();
+            if (!cookedPath.empty() && model->Open(cookedPath)) {
+                models[i] = std::move(model);
+            }
+        }
+        else if (i < modelJobs) {
+            ModelLoader::ImportModel(prefabPaths[i - modelPaths.size()]);
+        }
+        else {
+            auto& [id, texture] = prepared->_textures[i - modelJobs];
+            prepared->_texturePrepared[i - modelJobs] = TEXTURE_MANAGER->PrepareTexture(id, texture);
+        }
+    });
+    for (size_t i = 0; i < models.size(); ++i) {
+        prepared->_models[modelIds[i]] = std::move(models[i]);
+    }
+
+    return prepared;
+}
+
+bool SceneSerializer::ResolveResources(PreparedScene& prepared, double budgetMs) {
+    if (prepared._resolved) return true;
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    auto outOfTime = [&]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() >= budgetMs;
+    };
+    const SceneFileHeader& header = *prepared._header;
+
+    // Textures, one upload at a time
+    while (prepared._resolvedTextures < prepared._textures.size()) {
+        if (outOfTime()) return false;
+
+        const size_t i = prepared._resolvedTextures++;
+        auto& [id, texture] = prepared._textures[i];
+        TexturePtr loaded = prepared._texturePrepared[i] ? TEXTURE_MANAGER->AddTexture(id, std::move(texture)) : TEXTURE_MANAGER->LoadTexture(id);
+        prepared._loadedTextures[id.GetValue()] = loaded;
+        texture = PreparedTexture(); // The decoded copy isn't needed anymore
+    }
+
+    // Meshes. Stored geometry uploads straight from the mapping; model meshes come from
+    // the cooked model unless an earlier load already made them resident.
+    prepared._loadedMeshes.resize(header.meshCount);
+    while (prepared._resolvedMeshes < header.meshCount) {
+        if (outOfTime()) return false;
+
+        const uint32_t i = prepared._resolvedMeshes++;
+        const SceneMesh& mesh = prepared._meshes[i];
+        if (mesh.assetId == 0) {
+            prepared._loadedMeshes[i] = MESH_MANAGER->AddMesh(std::span<const StandardVertex>(prepared._vertices + mesh.firstVertex, mesh.vertexCount),
+                std::span<const unsigned int>(prepared._indices + mesh.firstIndex, mesh.indexCount));
+            continue;
+        }
+
+        const std::string modelPath = prepared.GetString(mesh.path);
+        if ((prepared._loadedMeshes[i] = MESH_MANAGER->GetMesh(modelPath, mesh.meshIndex))) continue;
+
+        const std::unique_ptr<CookedMesh>& model = prepared._models[mesh.assetId];
+        if (model && mesh.meshIndex < model->GetSubmeshCount()) {
+            prepared._loadedMeshes[i] = MESH_MANAGER->AddMesh(modelPath, mesh.meshIndex, model->GetVertices(mesh.meshIndex),
+                model->GetIndices(mesh.meshIndex), prepared.GetString(mesh.name));
+        }
+        else {
+            LOG_WARNING(Scene, "Missing mesh {} of {}", mesh.meshIndex, modelPath);
+        }
+    }
+    prepared._models.clear();
+
+    // Materials are only interned, so they all go at once
+    if (prepared._loadedMaterials.size() != header.materialCount) {
+        prepared._loadedMaterials.resize(header.materialCount);
+        for (uint32_t i = 0; i < header.materialCount; ++i) {
+            const SceneMaterial& entry = prepared._materials[i];
+            Material parameters;
+            parameters.SetName(prepared.GetString(entry.name));
+            parameters.SetAmbient(LoadVec3(entry.ambient));
+            parameters.SetDiffuse(LoadVec3(entry.diffuse));
+            parameters.SetSpecular(LoadVec3(entry.specular));
+            parameters.SetShininess(entry.shininess);
+            if (entry.textureId != 0) {
+                const std::string texturePath = prepared.GetString(entry.texturePath);
+                parameters.SetDiffuseTexture(prepared._loadedTextures[ResourceId::FromCanonical(texturePath).GetValue()], texturePath);
+            }
+            parameters.SetUseCheckerTexture((entry.flags & SceneMaterial_Checker) != 0);
+            prepared._loadedMaterials[i] = MATERIAL_MANAGER->AddMaterial(parameters);
+        }
+        prepared._textures.clear();
+        prepared._texturePrepared.clear();
+        prepared._loadedTextures.clear();
+    }
+
+    // Prefabs, one at a time; instances of an already loaded prefab share it. Stored prefabs
+    // are rebuilt from their node table, model prefabs come from LoadPrefab.
+    prepared._loadedPrefabs.resize(header.prefabCount);
+    while (prepared._resolvedPrefabs < header.prefabCount) {
+        if (outOfTime()) return false;
+
+        const uint32_t i = prepared._resolvedPrefabs++;
+        const ScenePrefab& prefab = prepared._prefabs[i];
+        if (prefab.assetId != 0) {
+            prepared._loadedPrefabs[i] = ModelLoader::LoadPrefab(prepared.GetString(prefab.path), prepared.GetString(prefab.texturePath));
+            continue;
+        }
+
+        std::vector<PrefabNode> nodes(prefab.nodeCount);
+        for (uint32_t j = 0; j < prefab.nodeCount; ++j) {
+            const ScenePrefabNode& entry = prepared._prefabNodes[prefab.firstNode + j];
+            const SceneTransform& transform = prepared._transforms[entry.transform];
+            PrefabNode& node = nodes[j];
+            node.name = prepared.GetString(entry.name);
+            node.parent = entry.parent != SceneFileNone ? static_cast<int>(entry.parent) : -1;
+            node.position = LoadVec3(transform.position);
+            node.rotation = glm::dquat(transform.rotation[3], transform.rotation[0], transform.rotation[1], transform.rotation[2]);
+            node.scale = LoadVec3(transform.scale);
+            node.mesh = entry.mesh != SceneFileNone ? prepared._loadedMeshes[entry.mesh] : nullptr;
+            node.material = entry.material != SceneFileNone ? prepared._loadedMaterials[entry.material] : nullptr;
+        }
+        prepared._loadedPrefabs[i] = std::make_shared<const Prefab>(prepared.GetString(prefab.name), "", "", std::move(nodes));
+    }
+
+    prepared._resolved = true;
+    return true;
+}
+
+GameObject* SceneSerializer::InstantiateNext(Scene* scene, PreparedScene& prepared, GameObject* parent) {
+    // Objects are stored parents first, so every parent already exists
+    const uint32_t index = static_cast<uint32_t>(prepared._created.size());
+    const SceneObject& object = prepared._objects[index];
+    const std::string name = prepared.GetString(object.name);
+    GameObject* gameObject = scene->CreateGameObject(name.c_str(), object.parent == SceneFileNone ? parent : prepared._created[object.parent]);
+
+    if (object.transform != SceneFileNone) {
+        const SceneTransform& entry = prepared._transforms[object.transform];
+        const glm::dquat rotation(entry.rotation[3], entry.rotation[0], entry.rotation[1], entry.rotation[2]);
+        gameObject->AddComponent<TransformComponent>()->SetLocalTransform(LoadVec3(entry.position), rotation, LoadVec3(entry.scale));
+    }
+
+    if (object.meshComponent != SceneFileNone) {
+        const SceneMeshComponent& entry = prepared._meshComponents[object.meshComponent];
+        auto meshComponent = gameObject->AddComponent<MeshComponent>();
+        meshComponent->SetMesh(prepared._loadedMeshes[entry.mesh]);
+        meshComponent->SetShowNormals((entry.flags & SceneMeshComponent_ShowNormals) != 0);
+        meshComponent->SetNormalLength(entry.normalLength);
+    }
+
+    if (object.materialComponent != SceneFileNone) {
+        const SceneMaterialComponent& entry = prepared._materialComponents[object.materialComponent];
+        gameObject->AddComponent<MaterialComponent>()->SetMaterial(prepared._loadedMaterials[entry.material]);
+    }
+
+    if (object.prefabInstance != SceneFileNone) {
+        const ScenePrefabInstance& entry = prepared._prefabInstances[object.prefabInstance];
+        const PrefabPtr& prefab = prepared._loadedPrefabs[entry.prefab];
+        auto instance = gameObject->AddComponent<PrefabInstanceComponent>(prefab);
+        for (uint32_t i = 0; prefab && i < entry.overrideCount; ++i) {
+            const ScenePrefabOverride& nodeOverride = prepared._prefabOverrides[entry.firstOverride + i];
+            if (nodeOverride.node >= prefab->GetNodeCount()) continue; // The source lost this node
+
+            if (nodeOverride.transform != SceneFileNone) {
+                const SceneTransform& transform = prepared._transforms[nodeOverride.transform];
+                const glm::dquat rotation(transform.rotation[3], transform.rotation[0], transform.rotation[1], transform.rotation[2]);
+                instance->SetNodeTransform(nodeOverride.node, LoadVec3(transform.position), rotation, LoadVec3(transform.scale));
+            }
+            if (nodeOverride.material != SceneFileNone) {
+                instance->SetNodeMaterial(nodeOverride.node, prepared._loadedMaterials[nodeOverride.material]);
+            }
+            if (nodeOverride.flags & ScenePrefabOverride_Hidden) {
+                instance->SetNodeVisible(nodeOverride.node, false);
+            }
+        }
+    }
+
+    if (!(object.flags & SceneObject_Active)) {
+        gameObject->SetActive(false);
+    }
+    prepared._created.push_back(gameObject);
+    return gameObject;
+}
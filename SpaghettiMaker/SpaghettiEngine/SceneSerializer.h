@@ -0,0 +1,266 @@
+#pragma once
+#include "types.h"
+#include "MappedFile.h"
+#include "CookedMesh.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "TextureManager.h"
+#include "Prefab.h"
+#include "ResourceId.h"
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Scene;
+class GameObject;
+
+// On-disk layout of a saved scene (.sscene). Like a cooked model, every section is a flat
+// array of fixed-size records, aligned and little-endian, so loading maps the file and walks
+// the tables without parsing anything. Bump SceneFileVersion whenever a struct changes.
+//
+//   SceneFileHeader
+//   SceneObject[objectCount] (depth first, parents before children)
+//   SceneTransform[transformCount]
+//   SceneMeshComponent[meshComponentCount]
+//   SceneMaterialComponent[materialComponentCount]
+//   SceneMesh[meshCount] (model meshes by asset id, or geometry stored below)
+//   SceneMaterial[materialCount]
+//   ScenePrefab[prefabCount] (model prefabs loaded with ModelLoader::LoadPrefab, or stored below)
+//   ScenePrefabNode[prefabNodeCount] (nodes of prefabs packed in the editor)
+//   ScenePrefabInstance[prefabInstanceCount]
+//   ScenePrefabOverride[prefabOverrideCount]
+//   vertex blob (StandardVertex, for meshes that have no source asset)
+//   index blob (uint32)
+//   string blob (names and asset paths, not null terminated)
+
+const uint32_t SceneFileMagic = 0x4E435353; // "SSCN"
+const uint32_t SceneFileVersion = 3;
+const size_t SceneFileAlignment = 64;
+const uint32_t SceneFileNone = 0xFFFFFFFF; // Missing component or reference
+
+struct SceneFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t objectCount;
+    uint32_t transformCount;
+    uint32_t meshComponentCount;
+    uint32_t materialComponentCount;
+    uint32_t meshCount;
+    uint32_t materialCount;
+    uint32_t prefabCount;
+    uint32_t prefabInstanceCount;
+    uint32_t prefabOverrideCount;
+    uint32_t prefabNodeCount;
+    uint64_t objectTableOffset;
+    uint64_t transformTableOffset;
+    uint64_t meshComponentTableOffset;
+    uint64_t materialComponentTableOffset;
+    uint64_t meshTableOffset;
+    uint64_t materialTableOffset;
+    uint64_t prefabTableOffset;
+    uint64_t prefabNodeTableOffset;
+    uint64_t prefabInstanceTableOffset;
+    uint64_t prefabOverrideTableOffset;
+    uint64_t vertexDataOffset;
+    uint64_t vertexDataSize;
+    uint64_t indexDataOffset;
+    uint64_t indexDataSize;
+    uint64_t stringDataOffset;
+    uint64_t stringDataSize;
+};
+
+// A range of the string blob
+struct SceneString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+enum SceneObjectFlags : uint32_t {
+    SceneObject_Active = 1 << 0
+};
+
+struct SceneObject {
+    SceneString name;
+    uint32_t parent;            // Index of the parent object, SceneFileNone for the scene root
+    uint32_t flags;
+    uint32_t transform;         // Component indices, SceneFileNone when absent
+    uint32_t meshComponent;
+    uint32_t materialComponent;
+    uint32_t prefabInstance;
+};
+
+// Local transform, at the precision TransformComponent keeps it
+struct SceneTransform {
+    double position[3];
+    double rotation[4]; // x, y, z, w
+    double scale[3];
+};
+
+enum SceneMeshComponentFlags : uint32_t {
+    SceneMeshComponent_ShowNormals = 1 << 0
+};
+
+struct SceneMeshComponent {
+    uint32_t mesh; // Into the mesh table
+    uint32_t flags;
+    float normalLength;
+    uint32_t reserved;
+};
+
+struct SceneMaterialComponent {
+    uint32_t material; // Into the material table
+};
+
+// Shared geometry. Model meshes are stored as a reference to their source asset and are
+// uploaded from the cooked model; procedural meshes carry their data in the blobs.
+struct SceneMesh {
+    uint64_t assetId;   // ResourceId of the source model, 0 for stored geometry
+    SceneString path;   // Canonical source path
+    SceneString name;
+    uint32_t meshIndex; // Within the source model
+    uint32_t firstVertex;
+    uint32_t vertexCount;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    uint32_t reserved;
+};
+
+enum SceneMaterialFlags : uint32_t {
+    SceneMaterial_Checker = 1 << 0
+};
+
+struct SceneMaterial {
+    uint64_t textureId;  // ResourceId of the diffuse texture, 0 for none
+    SceneString texturePath;
+    SceneString name;
+    uint32_t flags;
+    uint32_t reserved;
+    double ambient[3];
+    double diffuse[3];
+    double specular[3];
+    double shininess;
+};
+
+// A prefab shared by its instances, which only store the nodes they override. Prefabs built
+// from a model reference their source, so they pick up changes to it when the scene loads
+// again; prefabs packed in the editor have no source and keep their nodes in the file.
+struct ScenePrefab {
+    uint64_t assetId;        // ResourceId of the source model, 0 for a stored prefab
+    SceneString path;        // Canonical source path
+    SceneString texturePath; // As given to ModelLoader::LoadPrefab, empty for the model's own
+    SceneString name;
+    uint32_t firstNode;      // Range of the prefab node table, for stored prefabs
+    uint32_t nodeCount;
+};
+
+// One node of a stored prefab, parents before children
+struct ScenePrefabNode {
+    SceneString name;
+    uint32_t parent;    // Index within the prefab, SceneFileNone for its root
+    uint32_t transform; // Into the transform table
+    uint32_t mesh;      // Into the mesh table, SceneFileNone for none
+    uint32_t material;  // Into the material table, SceneFileNone for the default
+};
+
+struct ScenePrefabInstance {
+    uint32_t prefab;        // Into the prefab table
+    uint32_t firstOverride; // Range of the override table
+    uint32_t overrideCount;
+    uint32_t reserved;
+};
+
+enum ScenePrefabOverrideFlags : uint32_t {
+    ScenePrefabOverride_Hidden = 1 << 0
+};
+
+// One node an instance changes; everything else is read from the prefab
+struct ScenePrefabOverride {
+    uint32_t node;      // Index within the prefab
+    uint32_t flags;
+    uint32_t transform; // Into the transform table, SceneFileNone to keep the prefab's
+    uint32_t material;  // Into the material table, SceneFileNone to keep the prefab's
+};
+
+static_assert(sizeof(SceneFileHeader) == 176, "SceneFileHeader layout changed, bump SceneFileVersion");
+static_assert(sizeof(SceneObject) == 32, "SceneObject layout changed, bump SceneFileVersion");
+static_assert(sizeof(SceneTransform) == 80, "SceneTransform layout changed, bump SceneFileVersion");
+static_assert(sizeof(SceneMeshComponent) == 16, "SceneMeshComponent layout changed, bump SceneFileVersion");
+static_assert(sizeof(SceneMaterialComponent) == 4, "SceneMaterialComponent layout changed, bump SceneFileVersion");
+static_assert(sizeof(SceneMesh) == 48, "SceneMesh layout changed, bump SceneFileVersion");
+static_assert(sizeof(SceneMaterial) == 112, "SceneMaterial layout changed, bump SceneFileVersion");
+static_assert(sizeof(ScenePrefab) == 40, "ScenePrefab layout changed, bump SceneFileVersion");
+static_assert(sizeof(ScenePrefabNode) == 24, "ScenePrefabNode layout changed, bump SceneFileVersion");
+static_assert(sizeof(ScenePrefabInstance) == 16, "ScenePrefabInstance layout changed, bump SceneFileVersion");
+static_assert(sizeof(ScenePrefabOverride) == 16, "ScenePrefabOverride layout changed, bump SceneFileVersion");
+
+// A scene file read on a worker thread: mapped, validated, with its models cooked and its
+// textures decoded. SceneSerializer turns it into GameObjects on the main thread, either all
+// at once or a slice per frame. The tables point into the mapping and live as long as this.
+class PreparedScene {
+private:
+    friend class SceneSerializer;
+
+    std::string _path;
+    MappedFile _file;
+    const SceneFileHeader* _header = nullptr;
+    const SceneObject* _objects = nullptr;
+    const SceneTransform* _transforms = nullptr;
+    const SceneMeshComponent* _meshComponents = nullptr;
+    const SceneMaterialComponent* _materialComponents = nullptr;
+    const SceneMesh* _meshes = nullptr;
+    const SceneMaterial* _materials = nullptr;
+    const ScenePrefab* _prefabs = nullptr;
+    const ScenePrefabNode* _prefabNodes = nullptr;
+    const ScenePrefabInstance* _prefabInstances = nullptr;
+    const ScenePrefabOverride* _prefabOverrides = nullptr;
+    const StandardVertex* _vertices = nullptr;
+    const unsigned int* _indices = nullptr;
+    const char* _strings = nullptr;
+
+    // Filled on the worker
+    std::unordered_map<uint64_t, std::unique_ptr<CookedMesh>> _models; // By asset id; nullptr if the import failed
+    std::vector<std::pair<ResourceId, PreparedTexture>> _textures;
+    std::vector<char> _texturePrepared;
+
+    // Resolved on the main thread, in this order
+    size_t _resolvedTextures = 0;
+    uint32_t _resolvedMeshes = 0;
+    uint32_t _resolvedPrefabs = 0;
+    bool _resolved = false;
+    std::unordered_map<uint64_t, TexturePtr> _loadedTextures;
+    std::vector<MeshPtr> _loadedMeshes;
+    std::vector<MaterialPtr> _loadedMaterials;
+    std::vector<PrefabPtr> _loadedPrefabs;
+    std::vector<GameObject*> _created;
+
+    std::string GetString(const SceneString& string) const { return std::string(_strings + string.offset, string.length); }
+
+public:
+    const std::string& GetPath() const { return _path; }
+    uint32_t GetObjectCount() const { return _header->objectCount; }
+    uint32_t GetInstantiatedCount() const { return static_cast<uint32_t>(_created.size()); }
+    bool IsResolved() const { return _resolved; }
+    bool IsInstantiated() const { return _created.size() == _header->objectCount; }
+};
+
+// Saves and loads a Scene's hierarchy with its transforms, meshes, materials and prefab instances.
+class SceneSerializer {
+public:
+    // Main thread
+    static bool Save(const Scene* scene, const std::string& path);
+    static bool Save(const std::vector<GameObject*>& roots, const std::string& path); // These objects and their children
+    static bool Load(Scene* scene, const std::string& path); // Replaces the scene's contents
+
+    // Loading in steps. Prepare runs on any thread; the rest on the main thread, in order.
+    static std::unique_ptr<PreparedScene> Prepare(const std::string& path); // nullptr if missing or invalid
+    // Uploads textures and meshes until the budget runs out; true once everything is resolved
+    static bool ResolveResources(PreparedScene& prepared, double budgetMs = std::numeric_limits<double>::infinity());
+    // Creates the next object; top-level objects go under parent, or the scene root if null
+    static GameObject* InstantiateNext(Scene* scene, PreparedScene& prepared, GameObject* parent = nullptr);
+
+    static const char* GetExtension() { return ".sscene"; }
+};
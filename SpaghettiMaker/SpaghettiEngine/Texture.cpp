@@ -1,31 +1,129 @@
 #include "Texture.h"
+#include "DDSFile.h"
+#include "MipGenerator.h"
+#include "MappedFile.h"
+#include "Log.h"
+#include "Renderer.h"
+#include "TextureManager.h"
 #include <GL/glew.h>
 #include <IL/il.h>
 #include <IL/ilu.h>
 #include <IL/ilut.h>
 #include <vector>
-#include <iostream>
-#include <filesystem>
-#include <fstream>
+#include <mutex>
+#include <cstring>
 
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
 
 
+
+namespace {
+    // DevIL keeps its bound image in global state, so every decode is serialized
+    std::mutex s_devilMutex;
+}
+
+namespace {
+    // Image containers told apart by their first bytes
+    enum class ImageFileType {
+        Unknown, // TGA has no signature, so it ends up here too
+        DDS,
+        PNG,
+        JPEG,
+        BMP,
+        GIF,
+        PSD,
+        HDR,
+        TIFF
+    };
+
+    bool StartsWith(const unsigned char* data, size_t size, const char* magic, size_t length) {
+        return size >= length && std::memcmp(data, magic, length) == 0;
+    }
+
+    ImageFileType DetectImageFileType(const unsigned char* data, size_t size) {
+        if (StartsWith(data, size, "DDS ", 4)) return ImageFileType::DDS;
+        if (StartsWith(data, size, "\x89PNG\r\n\x1A\n", 8)) return ImageFileType::PNG;
+        if (StartsWith(data, size, "\xFF\xD8\xFF", 3)) return ImageFileType::JPEG;
+        if (StartsWith(data, size, "BM", 2)) return ImageFileType::BMP;
+        if (StartsWith(data, size, "GIF8", 4)) return ImageFileType::GIF;
+        if (StartsWith(data, size, "8BPS", 4)) return ImageFileType::PSD;
+        if (StartsWith(data, size, "#?RADIANCE", 10) || StartsWith(data, size, "#?RGBE", 6)) return ImageFileType::HDR;
+        if (StartsWith(data, size, "II*\0", 4) || StartsWith(data, size, "MM\0*", 4)) return ImageFileType::TIFF;
+        return ImageFileType::Unknown;
+    }
+
+    // stb_image is the faster decoder and thread-safe; unknown files get a try too, for TGA
+    bool IsDecodedByStb(ImageFileType type) {
+        return type != ImageFileType::TIFF;
+    }
+
+    ILenum GetDevILType(ImageFileType type) {
+        switch (type) {
+        case ImageFileType::PNG: return IL_PNG;
+        case ImageFileType::JPEG: return IL_JPG;
+        case ImageFileType::BMP: return IL_BMP;
+        case ImageFileType::GIF: return IL_GIF;
+        case ImageFileType::PSD: return IL_PSD;
+        case ImageFileType::HDR: return IL_HDR;
+        case ImageFileType::TIFF: return IL_TIF;
+        default: return IL_TYPE_UNKNOWN;
+        }
+    }
+}
+
+uint64_t Texture::s_currentFrame = 0;
+
 bool Texture::LoadFromFile(const std::string& path) {
-    Cleanup();
-    _path = path;
+    ImageData image;
+    if (!DecodeFile(path, image)) {
+        Cleanup();
+        _path = path;
+        return false;
+    }
+    return LoadFromImage(image, path);
+}
 
-    // Convert to absolute path and clean it up
-    std::filesystem::path fsPath = std::filesystem::absolute(std::filesystem::path(path)).lexically_normal();
-    
-    // Check file existence
-    if (!std::filesystem::exists(fsPath)) {
-        std::cerr << "File does not exist: " << fsPath << std::endl;
+bool Texture::DecodeFile(const std::string& path, ImageData& image) {
+    // Mapped rather than read, so the decoders work on the page cache without a copy
+    MappedFile file;
+    if (!file.Open(path)) {
+        LOG_ERROR(Texture, "Failed to open image file: {}", path);
         return false;
     }
+    const unsigned char* data = file.GetData();
+    const size_t size = file.GetSize();
+
+    // The contents decide the decoder, whatever the extension says
+    const ImageFileType type = DetectImageFileType(data, size);
+    if (type == ImageFileType::DDS) {
+        // Already in its GPU format, DevIL would only decompress it
+        return DDSFile::Read(data, size, image);
+    }
 
-    auto fileSize = std::filesystem::file_size(fsPath);
-    std::cout << "Found file at: " << fsPath << std::endl;
-    std::cout << "File size: " << fileSize << " bytes" << std::endl;
+    // stb_image keeps no shared state, so any number of workers can decode at once.
+    // Rows are flipped to match DevIL's IL_ORIGIN_LOWER_LEFT, which everything else expects.
+    int width = 0, height = 0, channels = 0;
+    stbi_set_flip_vertically_on_load_thread(1);
+    unsigned char* pixels = nullptr;
+    if (IsDecodedByStb(type) && size <= static_cast<size_t>(INT_MAX)) {
+        pixels = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &channels, 4);
+    }
+    if (pixels) {
+        image.width = width;
+        image.height = height;
+        image.channels = channels;
+        image.format = TextureFormat::RGBA8;
+        image.levels.clear();
+        image.pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+        stbi_image_free(pixels);
+
+        LOG_DEBUG(Texture, "Image loaded: {}x{} channels: {}", image.width, image.height, image.channels);
+        return true;
+    }
+
+    // Formats stb doesn't read (and files it rejected) go through DevIL, one image at a time
+    std::lock_guard<std::mutex> lock(s_devilMutex);
 
     // Reset DevIL error state
 	while (ilGetError() != IL_NO_ERROR) {}
@@ -33,113 +131,154 @@ bool Texture::LoadFromFile(const std::string& path) {
     ILuint imageID = 0;
     ilGenImages(1, &imageID);
     if (ilGetError() != IL_NO_ERROR) {
-        std::cerr << "Failed to generate IL image" << std::endl;
+        LOG_ERROR(Texture, "Failed to generate IL image");
         return false;
     }
 
     ilBindImage(imageID);
     if (ilGetError() != IL_NO_ERROR) {
-        std::cerr << "Failed to bind IL image" << std::endl;
+        LOG_ERROR(Texture, "Failed to bind IL image");
         return false;
     }
 
-
-    // Read file into memory first
-    std::ifstream file(fsPath, std::ios::binary);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file: " << fsPath << std::endl;
+    // Straight from the mapping; DevIL only reads the lump
+    if (!ilLoadL(GetDevILType(type), const_cast<unsigned char*>(data), static_cast<ILuint>(size))) {
+        ILenum error = ilGetError();
+        LOG_ERROR(Texture, "DevIL failed to load image from memory. Error: {}", error);
         ilDeleteImages(1, &imageID);
         return false;
     }
 
-    // Get file size and read data
-    file.seekg(0, std::ios::end);
-    size_t size = file.tellg();
-    file.seekg(0, std::ios::beg);
+    // Get image info
+    image.width = ilGetInteger(IL_IMAGE_WIDTH);
+    image.height = ilGetInteger(IL_IMAGE_HEIGHT);
+    image.channels = ilGetInteger(IL_IMAGE_CHANNELS);
+
+    LOG_DEBUG(Texture, "Image loaded: {}x{} channels: {}", image.width, image.height, image.channels);
 
-    std::vector<char> buffer(size);
-    file.read(buffer.data(), size);
-    file.close();
+    // Convert to RGBA format
+    if (!ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE)) {
+        LOG_ERROR(Texture, "Failed to convert image format");
+        ilDeleteImages(1, &imageID);
+        return false;
+    }
 
-    // Load from memory instead of file
-    if (!ilLoadL(IL_PNG, buffer.data(), static_cast<ILuint>(size))) {
-        ILenum error = ilGetError();
-        std::cerr << "DevIL failed to load image from memory. Error: " << error << std::endl;
+    // Get the image data
+    ILubyte* decoded = ilGetData();
+    if (!decoded) {
+        LOG_ERROR(Texture, "Failed to get image data");
         ilDeleteImages(1, &imageID);
         return false;
     }
 
-    // Get image info
-    _width = ilGetInteger(IL_IMAGE_WIDTH);
-    _height = ilGetInteger(IL_IMAGE_HEIGHT);
-    _channels = ilGetInteger(IL_IMAGE_CHANNELS);
+    image.pixels.assign(decoded, decoded + static_cast<size_t>(image.width) * image.height * 4);
+
+    // Cleanup DevIL
+    ilDeleteImages(1, &imageID);
+    return true;
+}
 
-    std::cout << "Image loaded: " << _width << "x" << _height << " channels: " << _channels << std::endl;
+bool Texture::LoadFromImage(const ImageData& image, const std::string& path) {
+    const bool compressed = TextureCompressor::IsCompressed(image.format);
 
-    // Convert to RGBA format
-    if (!ilConvertImage(IL_RGBA, IL_UNSIGNED_BYTE)) {
-        std::cerr << "Failed to convert image format" << std::endl;
-        ilDeleteImages(1, &imageID);
+    // Images that didn't come through the importer get their mips here, on the CPU
+    if (!compressed && image.levels.empty()) {
+        ImageData chain;
+        if (MipGenerator::Generate(image, chain, MipFilter::Box)) {
+            return LoadFromImage(chain, path);
+        }
+    }
+
+    Cleanup();
+    _path = path;
+
+    if (compressed && !TextureCompressor::IsSupported(image.format)) {
+        LOG_ERROR(Texture, "GPU does not support {} textures: {}", TextureCompressor::GetFormatName(image.format), path);
         return false;
     }
 
+    _width = image.width;
+    _height = image.height;
+    _channels = image.channels;
+    _format = image.format;
+    _mipCount = image.firstLevel + std::max(static_cast<int>(image.levels.size()), 1);
+    _residentMip = image.firstLevel;
+
     // Create OpenGL texture
     glGenTextures(1, &_textureID);
     glBindTexture(GL_TEXTURE_2D, _textureID);
 
     // Set base texture parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, image.levels.size() > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-
-    // Get the image data
-    ILubyte* data = ilGetData();
-    if (!data) {
-        std::cerr << "Failed to get image data" << std::endl;
-        ilDeleteImages(1, &imageID);
-        return false;
-    }
-
     // Upload to OpenGL
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, _width, _height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    if (image.levels.empty()) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, _width, _height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels.data());
+        _gpuBytes = TextureCompressor::GetImageSize(_format, _width, _height);
+        RENDERER->CountBufferUpload(_gpuBytes);
+    }
+    else {
+        // Level by level, no GPU-side generation; compressed levels go up as they are.
+        // Staged levels are read from the upload ring by the GPU, without a driver-side copy.
+        const StagingBuffer* staging = image.staging.get();
+        if (staging) {
+            TEXTURE_UPLOAD_RING->Bind();
+        }
+        _gpuBytes = 0;
+        for (size_t i = 0; i < image.levels.size(); i++) {
+            const ImageLevel& level = image.levels[i];
+            const GLint index = image.firstLevel + static_cast<GLint>(i);
+            const unsigned char* source = staging ? staging->GetGLPointer(level.offset) : image.pixels.data() + level.offset;
+            if (compressed) {
+                glCompressedTexImage2D(GL_TEXTURE_2D, index, TextureCompressor::GetGLFormat(_format), level.width, level.height, 0,
+                    static_cast<GLsizei>(level.size), source);
+            }
+            else {
+                glTexImage2D(GL_TEXTURE_2D, index, GL_RGBA, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, source);
+            }
+            _gpuBytes += level.size;
+            RENDERER->CountBufferUpload(level.size);
+        }
+        if (staging) {
+            TEXTURE_UPLOAD_RING->Unbind();
+            TEXTURE_UPLOAD_RING->Submit(*staging);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, _residentMip);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, _mipCount - 1);
+    }
 
     // Check for OpenGL errors
     GLenum glError = glGetError();
     if (glError != GL_NO_ERROR) {
-        std::cerr << "OpenGL error: " << glError << std::endl;
+        LOG_ERROR(Texture, "OpenGL error: {}", glError);
     }
 
-    // Cleanup DevIL
-    ilDeleteImages(1, &imageID);
-
     _isLoaded = true;
-    std::cout << "Texture loaded successfully. ID: " << _textureID << std::endl;
+    LOG_DEBUG(Texture, "Texture loaded successfully. ID: {} ({}, {} KB)", _textureID, TextureCompressor::GetFormatName(_format), _gpuBytes / 1024);
     return true;
 }
 
 bool Texture::LoadFromMemory(unsigned char* data, int width, int height, int channels) {
-    Cleanup();
-
-    _width = width;
-    _height = height;
-    _channels = channels;
-
-    glGenTextures(1, &_textureID);
-    glBindTexture(GL_TEXTURE_2D, _textureID);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _minFilter);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _magFilter);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _wrapS);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, _wrapT);
-
-    GLenum format = (channels == 4) ? GL_RGBA : GL_RGB;
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    GenerateMipmaps();
+    ImageData image;
+    image.width = width;
+    image.height = height;
+    image.channels = channels;
+    image.pixels.resize(static_cast<size_t>(width) * height * 4);
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+        image.pixels[i * 4 + 0] = data[i * channels + 0];
+        image.pixels[i * 4 + 1] = data[i * channels + 1];
+        image.pixels[i * 4 + 2] = data[i * channels + 2];
+        image.pixels[i * 4 + 3] = (channels == 4) ? data[i * channels + 3] : 255;
+    }
 
-    _isLoaded = true;
+    if (!LoadFromImage(image, _path)) {
+        return false;
+    }
+    SetFiltering(_minFilter, _magFilter);
+    SetWrapping(_wrapS, _wrapT);
     return true;
 }
 
@@ -163,9 +302,32 @@ std::shared_ptr<Texture> Texture::CreateCheckerboard(int width, int height) {
     return texture;
 }
 
+unsigned int Texture::GetBindID() const {
+    if (_evicted) {
+        const TexturePtr& placeholder = TEXTURE_MANAGER->GetDefaultTexture();
+        return placeholder ? placeholder->GetID() : 0;
+    }
+    return GetID();
+}
+
 void Texture::Bind(unsigned int slot) const {
+    _lastUsedFrame = s_currentFrame;
+    if (_atlasPage) {
+        _atlasPage->_lastUsedFrame = s_currentFrame;
+    }
+
     glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(GL_TEXTURE_2D, _textureID);
+    glBindTexture(GL_TEXTURE_2D, GetBindID());
+    RENDERER->CountTextureBind();
+
+    // The texture matrix belongs to the active unit, so it is reset for every other texture
+    glMatrixMode(GL_TEXTURE);
+    glLoadIdentity();
+    if (_atlasPage) {
+        glTranslatef(_uvOffset.x, _uvOffset.y, 0.0f);
+        glScalef(_uvScale.x, _uvScale.y, 1.0f);
+    }
+    glMatrixMode(GL_MODELVIEW);
 }
 
 void Texture::Unbind() const {
@@ -177,7 +339,79 @@ void Texture::Cleanup() {
         glDeleteTextures(1, &_textureID);
         _textureID = 0;
     }
+    _gpuBytes = 0;
+    _mipCount = 1;
+    _residentMip = 0;
     _isLoaded = false;
+    _evicted = false;
+    _atlasPage = nullptr;
+    _uvOffset = fvec2(0.0f);
+    _uvScale = fvec2(1.0f);
+}
+
+void Texture::EvictToPlaceholder() {
+    if (!_textureID) return;
+
+    glDeleteTextures(1, &_textureID);
+    _textureID = 0;
+    _gpuBytes = 0;
+    _residentMip = _mipCount;
+    _evicted = true;
+}
+
+std::shared_ptr<Texture> Texture::CreateAtlasView(const std::shared_ptr<Texture>& page, const std::string& path, int x, int y, int width, int height) {
+    // Size and path of the source, so materials and the editor show the texture it stands for
+    auto view = std::make_shared<Texture>();
+    view->_width = width;
+    view->_height = height;
+    view->_path = path;
+    view->_format = page->GetFormat();
+    view->_atlasPage = page;
+    view->_uvOffset = fvec2(static_cast<float>(x) / page->GetWidth(), static_cast<float>(y) / page->GetHeight());
+    view->_uvScale = fvec2(static_cast<float>(width) / page->GetWidth(), static_cast<float>(height) / page->GetHeight());
+    view->_isLoaded = true;
+    return view;
+}
+
+size_t Texture::GetMipSize(int level) const {
+    return TextureCompressor::GetImageSize(_format, std::max(_width >> level, 1), std::max(_height >> level, 1));
+}
+
+bool Texture::UploadMip(int level, const unsigned char* data, size_t size) {
+    // Levels arrive coarse to fine, so the resident range stays contiguous
+    if (!_textureID || level != _residentMip - 1 || size != GetMipSize(level)) {
+        return false;
+    }
+
+    const int width = std::max(_width >> level, 1);
+    const int height = std::max(_height >> level, 1);
+    glBindTexture(GL_TEXTURE_2D, _textureID);
+    if (TextureCompressor::IsCompressed(_format)) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, TextureCompressor::GetGLFormat(_format), width, height, 0, static_cast<GLsizei>(size), data);
+    }
+    else {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+    RENDERER->CountBufferUpload(size);
+
+    _residentMip = level;
+    _gpuBytes += size;
+    return true;
+}
+
+void Texture::EvictMips(int level) {
+    level = std::min(level, _mipCount - 1);
+    if (!_textureID || level <= _residentMip) return;
+
+    // Sampling stops at the new base first; the dropped levels are then redefined as empty
+    glBindTexture(GL_TEXTURE_2D, _textureID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+    for (int i = _residentMip; i < level; i++) {
+        glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        _gpuBytes -= GetMipSize(i);
+    }
+    _residentMip = level;
 }
 
 void Texture::SetFiltering(GLint minFilter, GLint magFilter) {
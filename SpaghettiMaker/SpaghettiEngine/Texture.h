@@ -4,6 +4,35 @@
 #include <memory>
 #include <IL/il.h>
 #include <IL/ilu.h>
+#include "TextureCompressor.h"
+#include "TextureUploadRing.h"
+#include "types.h"
+
+#include <vector>
+#include <climits>
+#include <algorithm>
+
+// One mip level inside ImageData::pixels
+struct ImageLevel {
+    int width = 0;
+    int height = 0;
+    size_t offset = 0;
+    size_t size = 0;
+};
+
+// Decoded pixels, produced off the main thread and uploaded later. Decoded files are RGBA8;
+// imported DDS files hold block-compressed data with their whole mip chain. Level offsets
+// index pixels, or the staging buffer once the levels were copied into the upload ring.
+struct ImageData {
+    int width = 0;
+    int height = 0;
+    int channels = 0; // Channels in the source file
+    TextureFormat format = TextureFormat::RGBA8;
+    std::vector<unsigned char> pixels; // Every level back to back
+    std::vector<ImageLevel> levels;    // Empty for a single RGBA8 level
+    int firstLevel = 0;                // Mip index of levels[0]; streamed textures start with the coarse end
+    StagingBufferPtr staging;          // When set, the levels sit in the upload ring and pixels is empty
+};
 
 class Texture {
 private:
@@ -11,9 +40,26 @@ private:
     int _width = 0;
     int _height = 0;
     int _channels = 0;
+    TextureFormat _format = TextureFormat::RGBA8;
+    size_t _gpuBytes = 0; // Video memory used by all levels
+
+    // Mip streaming: levels finer than _residentMip aren't in video memory yet (or any more)
+    int _mipCount = 1;
+    int _residentMip = 0;
+    int _requestedMip = INT_MAX; // Finest level drawn since the streaming update last looked
+
+    // Memory budget: when the texture was last bound, and whether it was evicted to the placeholder
+    mutable uint64_t _lastUsedFrame = 0;
+    bool _evicted = false;
+    static uint64_t s_currentFrame;
     std::string _path;
     bool _isLoaded = false;
 
+    // Set when the texels live in a shared atlas page instead of _textureID
+    std::shared_ptr<Texture> _atlasPage;
+    fvec2 _uvOffset = fvec2(0.0f);
+    fvec2 _uvScale = fvec2(1.0f);
+
     // Texture parameters
     GLint _minFilter = GL_LINEAR_MIPMAP_LINEAR;
     GLint _magFilter = GL_LINEAR;
@@ -25,9 +71,13 @@ public:
     ~Texture() { Cleanup(); }
 
     bool LoadFromFile(const std::string& path);
+    bool LoadFromImage(const ImageData& image, const std::string& path); // GL upload only, main thread
+    static bool DecodeFile(const std::string& path, ImageData& image);   // Safe to call from any thread
     bool LoadFromMemory(unsigned char* data, int width, int height, int channels);
     static std::shared_ptr<Texture> CreateCheckerboard(int width = 64, int height = 64);
 
+    // Also loads the texture matrix that maps 0-1 UVs onto the atlas region, if any, and stamps
+    // the texture as used this frame. Evicted textures bind the default texture until they are reloaded.
     void Bind(unsigned int slot = 0) const;
     void Unbind() const;
     void Cleanup();
@@ -38,9 +88,36 @@ public:
     void GenerateMipmaps();
 
     // Getters
-    unsigned int GetID() const { return _textureID; }
+    unsigned int GetID() const { return _atlasPage ? _atlasPage->GetID() : _textureID; }
+    unsigned int GetBindID() const; // What Bind() binds: GetID(), or the default texture's while evicted
     int GetWidth() const { return _width; }
     int GetHeight() const { return _height; }
+    TextureFormat GetFormat() const { return _format; }
+    size_t GetGPUBytes() const { return _gpuBytes; }
+
+    // Mip streaming, driven by the TextureManager (main thread)
+    int GetMipCount() const { return _mipCount; }
+    int GetResidentMip() const { return _residentMip; }
+    size_t GetMipSize(int level) const;
+    void RequestMip(int level) { _requestedMip = std::min(_requestedMip, level); }
+    int TakeRequestedMip() { int level = _requestedMip; _requestedMip = INT_MAX; return level; }
+    bool UploadMip(int level, const unsigned char* data, size_t size); // Only the next finer level
+    void EvictMips(int level); // Frees every level finer than the given one
+
+    // Memory budget, driven by the TextureManager (main thread)
+    static void SetCurrentFrame(uint64_t frame) { s_currentFrame = frame; }
+    uint64_t GetLastUsedFrame() const { return _lastUsedFrame; }
+    void EvictToPlaceholder(); // Frees every level but keeps size and path for the reload
+    bool IsEvicted() const { return _evicted; }
+
+    // Atlasing, driven by the TextureManager: a view of one region of a shared page. Views are
+    // separate objects; the standalone texture of the same file stays as it is.
+    static std::shared_ptr<Texture> CreateAtlasView(const std::shared_ptr<Texture>& page, const std::string& path, int x, int y, int width, int height);
+    const std::shared_ptr<Texture>& GetAtlasPage() const { return _atlasPage; }
+    bool IsInAtlas() const { return _atlasPage != nullptr; }
+    const fvec2& GetUVOffset() const { return _uvOffset; } // Region of the bound texture covered by this one
+    const fvec2& GetUVScale() const { return _uvScale; }
+
     const std::string& GetPath() const { return _path; }
     bool IsLoaded() const { return _isLoaded; }
 };
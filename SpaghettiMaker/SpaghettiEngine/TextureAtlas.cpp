@@ -0,0 +1,207 @@
+#include "TextureAtlas.h"
+#include "TextureImporter.h"
+#include "MipGenerator.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
+#include "Log.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <thread>
+
+namespace {
+    int AlignUp(int value, int alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    int NextPowerOfTwo(int value) {
+        int result = 1;
+        while (result < value) result *= 2;
+        return result;
+    }
+
+    struct Page {
+        int shelfY = 0;      // Top of the open shelf
+        int shelfHeight = 0;
+        int cursorX = 0;     // Next free column on the open shelf
+        int usedWidth = 0;
+        int usedHeight = 0;
+    };
+}
+
+bool TextureAtlas::CanPack(const ImageData& image) {
+    return image.format == TextureFormat::RGBA8 && image.levels.empty() && image.width > 0 && image.height > 0 &&
+        image.width <= MaxTextureSize && image.height <= MaxTextureSize;
+}
+
+std::vector<AtlasRegion> TextureAtlas::Pack(const std::vector<const ImageData*>& images, std::vector<ImageData>& pages) {
+    std::vector<AtlasRegion> regions(images.size());
+    pages.clear();
+
+    // Shelf packing, tallest cells first so each shelf wastes little height
+    std::vector<size_t> order(images.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return images[a]->height > images[b]->height;
+    });
+
+    std::vector<Page> layout;
+    std::vector<int> cellX(images.size());
+    std::vector<int> cellY(images.size());
+    for (size_t index : order) {
+        const ImageData& image = *images[index];
+        if (!CanPack(image)) continue;
+
+        const int cellWidth = AlignUp(image.width + 2 * Gutter, CellAlignment);
+        const int cellHeight = AlignUp(image.height + 2 * Gutter, CellAlignment);
+
+        // Open shelf of the last page, a new shelf below it, or a new page
+        if (layout.empty()) layout.emplace_back();
+        Page* page = &layout.back();
+        if (page->cursorX + cellWidth > MaxPageSize) {
+            page->shelfY += page->shelfHeight;
+            page->shelfHeight = 0;
+            page->cursorX = 0;
+        }
+        if (page->shelfY + cellHeight > MaxPageSize) {
+            layout.emplace_back();
+            page = &layout.back();
+        }
+
+        regions[index].page = static_cast<int>(layout.size() - 1);
+        regions[index].x = page->cursorX + Gutter;
+        regions[index].y = page->shelfY + Gutter;
+        regions[index].width = image.width;
+        regions[index].height = image.height;
+        cellX[index] = page->cursorX;
+        cellY[index] = page->shelfY;
+
+        page->cursorX += cellWidth;
+        page->shelfHeight = std::max(page->shelfHeight, cellHeight);
+        page->usedWidth = std::max(page->usedWidth, page->cursorX);
+        page->usedHeight = std::max(page->usedHeight, page->shelfY + page->shelfHeight);
+    }
+
+    // Pages only as large as their contents; the unused part is opaque so it doesn't force BC3
+    std::vector<ImageData> chains(layout.size());
+    for (size_t p = 0; p < layout.size(); p++) {
+        ImageData& page = chains[p];
+        page.width = NextPowerOfTwo(layout[p].usedWidth);
+        page.height = NextPowerOfTwo(layout[p].usedHeight);
+        page.channels = 4;
+        page.pixels.assign(static_cast<size_t>(page.width) * page.height * 4, 0);
+        for (size_t i = 3; i < page.pixels.size(); i += 4) {
+            page.pixels[i] = 255;
+        }
+    }
+
+    // Copy each texture into its cell, clamping into the gutter
+    JOB_SYSTEM->ParallelFor(images.size(), [&](size_t index) {
+        const AtlasRegion& region = regions[index];
+        if (region.page < 0) return;
+
+        const ImageData& image = *images[index];
+        ImageData& page = chains[region.page];
+        const int cellWidth = AlignUp(image.width + 2 * Gutter, CellAlignment);
+        const int cellHeight = AlignUp(image.height + 2 * Gutter, CellAlignment);
+        for (int y = 0; y < cellHeight; y++) {
+            const int sourceY = std::clamp(y - Gutter, 0, image.height - 1);
+            unsigned char* row = page.pixels.data() + (static_cast<size_t>(cellY[index] + y) * page.width + cellX[index]) * 4;
+            for (int x = 0; x < cellWidth; x++) {
+                const int sourceX = std::clamp(x - Gutter, 0, image.width - 1);
+                std::copy_n(image.pixels.data() + (static_cast<size_t>(sourceY) * image.width + sourceX) * 4, 4, row + x * 4);
+            }
+        }
+    });
+
+    // Box filtered mips, cut off before a level could average two cells, then the usual encoder
+    for (ImageData& page : chains) {
+        ImageData chain;
+        if (!MipGenerator::Generate(page, chain, MipFilter::Box)) {
+            pages.clear();
+            return std::vector<AtlasRegion>(images.size());
+        }
+        if (chain.levels.size() > static_cast<size_t>(MipCount)) {
+            chain.levels.resize(MipCount);
+            chain.pixels.resize(chain.levels.back().offset + chain.levels.back().size);
+        }
+
+        const TextureFormat format = TextureImporter::ChooseFormat(page);
+        ImageData cooked;
+        if (!TextureCompressor::IsCompressed(format)) {
+            pages.push_back(std::move(chain));
+        }
+        else if (TextureImporter::CompressChain(chain, format, cooked)) {
+            pages.push_back(std::move(cooked));
+        }
+        else {
+            pages.clear();
+            return std::vector<AtlasRegion>(images.size());
+        }
+    }
+    return regions;
+}
+
+bool TextureAtlas::WriteFile(const std::string& path, const std::vector<AtlasRegion>& regions, size_t pageCount) {
+    AtlasFileHeader header;
+    header.regionCount = static_cast<uint32_t>(regions.size());
+    header.pageCount = static_cast<uint32_t>(pageCount);
+
+    // Written beside the final file and renamed into place, like the other cooked outputs
+    std::string tempPath = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOG_ERROR(Texture, "Failed to open atlas for writing: {}", tempPath);
+            return false;
+        }
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(regions.data()), regions.size() * sizeof(AtlasRegion));
+        if (!out) {
+            LOG_ERROR(Texture, "Failed to write atlas: {}", tempPath);
+            out.close();
+            std::filesystem::remove(tempPath);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        LOG_ERROR(Texture, "Failed to replace atlas {}: {}", path, error.message());
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool TextureAtlas::ReadFile(const std::string& path, std::vector<AtlasRegion>& regions, size_t& pageCount) {
+    MappedFile file;
+    if (!file.Open(path)) return false;
+
+    AtlasFileHeader header;
+    if (file.GetSize() < sizeof(header)) return false;
+    std::memcpy(&header, file.GetData(), sizeof(header));
+    if (header.magic != AtlasFileMagic || header.version != AtlasFileVersion ||
+        file.GetSize() != sizeof(header) + static_cast<size_t>(header.regionCount) * sizeof(AtlasRegion)) {
+        LOG_WARNING(Texture, "Atlas is damaged or out of date: {}", path);
+        return false;
+    }
+
+    regions.resize(header.regionCount);
+    std::memcpy(regions.data(), file.GetData() + sizeof(header), regions.size() * sizeof(AtlasRegion));
+    for (const AtlasRegion& region : regions) {
+        if (region.page >= static_cast<int>(header.pageCount)) return false;
+    }
+    pageCount = header.pageCount;
+    return true;
+}
+
+std::string TextureAtlas::GetPagePath(const std::string& atlasPath, size_t page) {
+    std::filesystem::path path(atlasPath);
+    path.replace_extension();
+    return path.string() + "_" + std::to_string(page) + ".dds";
+}
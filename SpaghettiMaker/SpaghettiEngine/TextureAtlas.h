@@ -0,0 +1,52 @@
+#pragma once
+#include "Texture.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Where one texture ended up in an atlas page
+struct AtlasRegion {
+    int page = -1; // -1 if the texture wasn't packed
+    int x = 0;     // First texel of the texture in the page
+    int y = 0;
+    int width = 0;
+    int height = 0;
+};
+
+// Cooked atlas (.satlas) in the asset library: this header, then one AtlasRegion per member texture
+// in the order they were cooked. Page N is written next to it as a .dds (see GetPagePath).
+const uint32_t AtlasFileMagic = 0x534C5441; // "ATLS"
+const uint32_t AtlasFileVersion = 1;
+
+struct AtlasFileHeader {
+    uint32_t magic = AtlasFileMagic;
+    uint32_t version = AtlasFileVersion;
+    uint32_t regionCount = 0;
+    uint32_t pageCount = 0;
+};
+static_assert(sizeof(AtlasFileHeader) == 16, "AtlasFileHeader layout changed");
+static_assert(sizeof(AtlasRegion) == 20, "AtlasRegion layout changed");
+
+// Packs small textures into shared pages, so objects that only differ by texture draw
+// from the same GL texture. Each texture sits in a cell with a gutter of repeated edge
+// texels; cells start and end on multiples of CellAlignment and the mips are box filtered,
+// so the first MipCount levels never blend two textures together.
+class TextureAtlas {
+public:
+    static const int MaxTextureSize = 256; // Larger textures keep their own GL texture
+    static const int MaxPageSize = 2048;
+    static const int Gutter = 16;
+    static const int CellAlignment = 16;
+    static const int MipCount = 5;         // log2(CellAlignment) + 1
+
+    static bool CanPack(const ImageData& image);
+
+    // Places single level RGBA8 images on as few pages as possible and returns one region per
+    // image. Pages come back with their mip chain, block compressed per the import settings.
+    static std::vector<AtlasRegion> Pack(const std::vector<const ImageData*>& images, std::vector<ImageData>& pages);
+
+    // Region table of a cooked atlas. Safe to call from worker threads.
+    static bool WriteFile(const std::string& path, const std::vector<AtlasRegion>& regions, size_t pageCount);
+    static bool ReadFile(const std::string& path, std::vector<AtlasRegion>& regions, size_t& pageCount);
+    static std::string GetPagePath(const std::string& atlasPath, size_t page);
+};
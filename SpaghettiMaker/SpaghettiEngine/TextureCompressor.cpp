@@ -0,0 +1,420 @@
+#include "TextureCompressor.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TEXTURE_COMPRESSOR_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // Interpolation weights of BC7's 4-bit indices, out of 64
+    const int BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // Picks the palette entry closest to each of the 16 pixels (RGBA8, squared distance).
+    // Channels that shouldn't count must be equal in the pixels and the palette.
+    void FindClosest(const unsigned char* pixels, const unsigned char* palette, int paletteSize, unsigned char* indices) {
+#ifdef TEXTURE_COMPRESSOR_SSE2
+        // Two palette entries per register as 16-bit lanes; madd gives the squared
+        // distance to both as pairs of partial sums
+        const __m128i zero = _mm_setzero_si128();
+        __m128i entries[8];
+        for (int j = 0; j < paletteSize; j += 2) {
+            entries[j / 2] = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(palette + j * 4)), zero);
+        }
+
+        for (int i = 0; i < 16; i++) {
+            int value;
+            std::memcpy(&value, pixels + i * 4, 4);
+            __m128i pixel = _mm_unpacklo_epi8(_mm_cvtsi32_si128(value), zero);
+            pixel = _mm_unpacklo_epi64(pixel, pixel);
+
+            int bestError = 0x7FFFFFFF;
+            int best = 0;
+            for (int j = 0; j < paletteSize; j += 2) {
+                __m128i difference = _mm_sub_epi16(pixel, entries[j / 2]);
+                __m128i squares = _mm_madd_epi16(difference, difference);
+                __m128i sums = _mm_add_epi32(squares, _mm_shuffle_epi32(squares, _MM_SHUFFLE(2, 3, 0, 1)));
+
+                int first = _mm_cvtsi128_si32(sums);
+                int second = _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+                if (first < bestError) { bestError = first; best = j; }
+                if (second < bestError) { bestError = second; best = j + 1; }
+            }
+            indices[i] = static_cast<unsigned char>(best);
+        }
+#else
+        for (int i = 0; i < 16; i++) {
+            int bestError = 0x7FFFFFFF;
+            int best = 0;
+            for (int j = 0; j < paletteSize; j++) {
+                int error = 0;
+                for (int c = 0; c < 4; c++) {
+                    int difference = pixels[i * 4 + c] - palette[j * 4 + c];
+                    error += difference * difference;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    best = j;
+                }
+            }
+            indices[i] = static_cast<unsigned char>(best);
+        }
+#endif
+    }
+
+    // Endpoints along the principal axis of the block's colors: the extremes of the pixels'
+    // projection onto it. Only the first `channels` channels are fitted.
+    void FitEndpoints(const unsigned char* block, int channels, float low[4], float high[4]) {
+        float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (int i = 0; i < 16; i++) {
+            for (int c = 0; c < channels; c++) {
+                mean[c] += block[i * 4 + c];
+            }
+        }
+        for (int c = 0; c < channels; c++) {
+            mean[c] /= 16.0f;
+        }
+
+        float covariance[4][4] = {};
+        for (int i = 0; i < 16; i++) {
+            float d[4];
+            for (int c = 0; c < channels; c++) {
+                d[c] = block[i * 4 + c] - mean[c];
+            }
+            for (int a = 0; a < channels; a++) {
+                for (int b = 0; b < channels; b++) {
+                    covariance[a][b] += d[a] * d[b];
+                }
+            }
+        }
+
+        // Power iteration, starting from the channel with the most variance
+        int widest = 0;
+        for (int c = 1; c < channels; c++) {
+            if (covariance[c][c] > covariance[widest][widest]) widest = c;
+        }
+        float axis[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (int c = 0; c < channels; c++) {
+            axis[c] = covariance[widest][c];
+        }
+        for (int iteration = 0; iteration < 8; iteration++) {
+            float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            float largest = 0.0f;
+            for (int a = 0; a < channels; a++) {
+                for (int b = 0; b < channels; b++) {
+                    next[a] += covariance[a][b] * axis[b];
+                }
+                largest = std::max(largest, std::abs(next[a]));
+            }
+            if (largest <= 0.0f) break;
+            for (int c = 0; c < channels; c++) {
+                axis[c] = next[c] / largest;
+            }
+        }
+
+        float length = 0.0f;
+        for (int c = 0; c < channels; c++) {
+            length += axis[c] * axis[c];
+        }
+        length = std::sqrt(length);
+
+        float minProjection = 0.0f;
+        float maxProjection = 0.0f;
+        if (length > 0.0f) {
+            for (int c = 0; c < channels; c++) {
+                axis[c] /= length;
+            }
+            for (int i = 0; i < 16; i++) {
+                float projection = 0.0f;
+                for (int c = 0; c < channels; c++) {
+                    projection += (block[i * 4 + c] - mean[c]) * axis[c];
+                }
+                minProjection = std::min(minProjection, projection);
+                maxProjection = std::max(maxProjection, projection);
+            }
+        }
+
+        for (int c = 0; c < 4; c++) {
+            low[c] = (c < channels) ? std::clamp(mean[c] + minProjection * axis[c], 0.0f, 255.0f) : 0.0f;
+            high[c] = (c < channels) ? std::clamp(mean[c] + maxProjection * axis[c], 0.0f, 255.0f) : 0.0f;
+        }
+    }
+
+    uint16_t Pack565(const float color[4]) {
+        int r = std::clamp(static_cast<int>(color[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+        int g = std::clamp(static_cast<int>(color[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+        int b = std::clamp(static_cast<int>(color[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    void Unpack565(uint16_t color, unsigned char* rgba) {
+        int r = (color >> 11) & 31;
+        int g = (color >> 5) & 63;
+        int b = color & 31;
+        rgba[0] = static_cast<unsigned char>((r << 3) | (r >> 2));
+        rgba[1] = static_cast<unsigned char>((g << 2) | (g >> 4));
+        rgba[2] = static_cast<unsigned char>((b << 3) | (b >> 2));
+        rgba[3] = 0;
+    }
+
+    // 8 byte BC4 block for one channel of the pixels, as used by BC3 alpha and BC5
+    void EncodeChannelBC4(const unsigned char* block, int channel, unsigned char* output) {
+        unsigned char low = 255;
+        unsigned char high = 0;
+        for (int i = 0; i < 16; i++) {
+            low = std::min(low, block[i * 4 + channel]);
+            high = std::max(high, block[i * 4 + channel]);
+        }
+
+        std::memset(output, 0, 8);
+        output[0] = high;
+        output[1] = low;
+        if (high == low) return;
+
+        // high > low selects the eight value palette
+        int palette[8] = { high, low };
+        for (int i = 2; i < 8; i++) {
+            palette[i] = ((8 - i) * high + (i - 1) * low + 3) / 7;
+        }
+
+        uint64_t bits = 0;
+        for (int i = 0; i < 16; i++) {
+            int value = block[i * 4 + channel];
+            int best = 0;
+            for (int j = 1; j < 8; j++) {
+                if (std::abs(palette[j] - value) < std::abs(palette[best] - value)) best = j;
+            }
+            bits |= static_cast<uint64_t>(best) << (3 * i);
+        }
+        for (int i = 0; i < 6; i++) {
+            output[2 + i] = static_cast<unsigned char>(bits >> (8 * i));
+        }
+    }
+
+    // Rounds an endpoint to BC7 mode 6 precision: 7 bits per channel plus a shared low bit
+    void QuantizeEndpointBC7(const float value[4], unsigned char quantized[4], int& pBit) {
+        float bestError = -1.0f;
+        for (int p = 0; p < 2; p++) {
+            unsigned char candidate[4];
+            float error = 0.0f;
+            for (int c = 0; c < 4; c++) {
+                candidate[c] = static_cast<unsigned char>(std::clamp(static_cast<int>((value[c] - p) / 2.0f + 0.5f), 0, 127));
+                float difference = static_cast<float>((candidate[c] << 1) | p) - value[c];
+                error += difference * difference;
+            }
+            if (bestError < 0.0f || error < bestError) {
+                bestError = error;
+                pBit = p;
+                std::memcpy(quantized, candidate, 4);
+            }
+        }
+    }
+
+    // Appends fields to a block, least significant bit first
+    struct BlockWriter {
+        unsigned char* output;
+        int bit = 0;
+
+        void Write(uint32_t value, int count) {
+            for (int i = 0; i < count; i++, bit++) {
+                if ((value >> i) & 1) {
+                    output[bit >> 3] |= static_cast<unsigned char>(1 << (bit & 7));
+                }
+            }
+        }
+    };
+}
+
+void TextureCompressor::EncodeBlockBC1(const unsigned char* block, unsigned char* output) {
+    float low[4], high[4];
+    FitEndpoints(block, 3, low, high);
+
+    // Pull the endpoints in a little: the extremes rarely deserve a palette entry of their own
+    for (int c = 0; c < 3; c++) {
+        float inset = (high[c] - low[c]) / 16.0f;
+        low[c] += inset;
+        high[c] -= inset;
+    }
+
+    uint16_t color0 = Pack565(high);
+    uint16_t color1 = Pack565(low);
+    if (color0 < color1) {
+        std::swap(color0, color1); // color0 > color1 selects the four color palette
+    }
+
+    unsigned char indices[16] = {};
+    if (color0 != color1) {
+        unsigned char palette[16];
+        Unpack565(color0, palette);
+        Unpack565(color1, palette + 4);
+        for (int c = 0; c < 3; c++) {
+            palette[8 + c] = static_cast<unsigned char>((2 * palette[c] + palette[4 + c]) / 3);
+            palette[12 + c] = static_cast<unsigned char>((palette[c] + 2 * palette[4 + c]) / 3);
+        }
+        palette[11] = palette[15] = 0;
+
+        // Alpha doesn't take part in BC1's color match
+        unsigned char colors[64];
+        std::memcpy(colors, block, sizeof(colors));
+        for (int i = 0; i < 16; i++) {
+            colors[i * 4 + 3] = 0;
+        }
+        FindClosest(colors, palette, 4, indices);
+    }
+
+    uint32_t bits = 0;
+    for (int i = 0; i < 16; i++) {
+        bits |= static_cast<uint32_t>(indices[i]) << (2 * i);
+    }
+
+    output[0] = static_cast<unsigned char>(color0);
+    output[1] = static_cast<unsigned char>(color0 >> 8);
+    output[2] = static_cast<unsigned char>(color1);
+    output[3] = static_cast<unsigned char>(color1 >> 8);
+    for (int i = 0; i < 4; i++) {
+        output[4 + i] = static_cast<unsigned char>(bits >> (8 * i));
+    }
+}
+
+void TextureCompressor::EncodeBlockBC3(const unsigned char* block, unsigned char* output) {
+    EncodeChannelBC4(block, 3, output);
+    EncodeBlockBC1(block, output + 8);
+}
+
+void TextureCompressor::EncodeBlockBC5(const unsigned char* block, unsigned char* output) {
+    EncodeChannelBC4(block, 0, output);
+    EncodeChannelBC4(block, 1, output + 8);
+}
+
+void TextureCompressor::EncodeBlockBC7(const unsigned char* block, unsigned char* output) {
+    // Mode 6 only: one RGBA line with 16 steps. It covers most blocks well and keeps the
+    // encoder simple; the partitioned modes are what a full BC7 encoder would add.
+    float low[4], high[4];
+    FitEndpoints(block, 4, low, high);
+
+    unsigned char endpoints[2][4];
+    int pBits[2];
+    QuantizeEndpointBC7(low, endpoints[0], pBits[0]);
+    QuantizeEndpointBC7(high, endpoints[1], pBits[1]);
+
+    unsigned char palette[64];
+    for (int c = 0; c < 4; c++) {
+        int from = (endpoints[0][c] << 1) | pBits[0];
+        int to = (endpoints[1][c] << 1) | pBits[1];
+        for (int j = 0; j < 16; j++) {
+            palette[j * 4 + c] = static_cast<unsigned char>(((64 - BC7Weights[j]) * from + BC7Weights[j] * to + 32) >> 6);
+        }
+    }
+
+    unsigned char indices[16];
+    FindClosest(block, palette, 16, indices);
+
+    // The first index is stored without its top bit; swapping the endpoints mirrors the palette
+    if (indices[0] & 8) {
+        std::swap(endpoints[0], endpoints[1]);
+        std::swap(pBits[0], pBits[1]);
+        for (int i = 0; i < 16; i++) {
+            indices[i] = static_cast<unsigned char>(15 - indices[i]);
+        }
+    }
+
+    std::memset(output, 0, 16);
+    BlockWriter writer{ output };
+    writer.Write(1 << 6, 7); // Mode 6
+    for (int c = 0; c < 4; c++) {
+        writer.Write(endpoints[0][c], 7);
+        writer.Write(endpoints[1][c], 7);
+    }
+    writer.Write(pBits[0], 1);
+    writer.Write(pBits[1], 1);
+    writer.Write(indices[0], 3);
+    for (int i = 1; i < 16; i++) {
+        writer.Write(indices[i], 4);
+    }
+}
+
+bool TextureCompressor::Compress(const unsigned char* rgba, int width, int height, TextureFormat format, std::vector<unsigned char>& output) {
+    const size_t blockSize = GetBlockSize(format);
+    if (!rgba || width <= 0 || height <= 0 || blockSize == 0) {
+        return false;
+    }
+
+    void (*encode)(const unsigned char*, unsigned char*) = nullptr;
+    switch (format) {
+    case TextureFormat::BC1: encode = EncodeBlockBC1; break;
+    case TextureFormat::BC3: encode = EncodeBlockBC3; break;
+    case TextureFormat::BC5: encode = EncodeBlockBC5; break;
+    case TextureFormat::BC7: encode = EncodeBlockBC7; break;
+    default: return false;
+    }
+
+    const int blocksX = (width + 3) / 4;
+    const int blocksY = (height + 3) / 4;
+    output.assign(static_cast<size_t>(blocksX) * blocksY * blockSize, 0);
+
+    JOB_SYSTEM->ParallelFor(static_cast<size_t>(blocksY), [&](size_t blockY) {
+        unsigned char block[64];
+        for (int blockX = 0; blockX < blocksX; blockX++) {
+            for (int y = 0; y < 4; y++) {
+                const int sourceY = std::min(static_cast<int>(blockY) * 4 + y, height - 1);
+                for (int x = 0; x < 4; x++) {
+                    const int sourceX = std::min(blockX * 4 + x, width - 1);
+                    std::memcpy(block + (y * 4 + x) * 4, rgba + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+                }
+            }
+            encode(block, output.data() + (blockY * blocksX + blockX) * blockSize);
+        }
+    });
+    return true;
+}
+
+size_t TextureCompressor::GetBlockSize(TextureFormat format) {
+    switch (format) {
+    case TextureFormat::BC1: return 8;
+    case TextureFormat::BC3:
+    case TextureFormat::BC5:
+    case TextureFormat::BC7: return 16;
+    default: return 0;
+    }
+}
+
+size_t TextureCompressor::GetImageSize(TextureFormat format, int width, int height) {
+    if (!IsCompressed(format)) {
+        return static_cast<size_t>(width) * height * 4;
+    }
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+}
+
+GLenum TextureCompressor::GetGLFormat(TextureFormat format) {
+    switch (format) {
+    case TextureFormat::BC1: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    case TextureFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    case TextureFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+    case TextureFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+    default: return GL_RGBA8;
+    }
+}
+
+bool TextureCompressor::IsSupported(TextureFormat format) {
+    switch (format) {
+    case TextureFormat::BC1:
+    case TextureFormat::BC3: return GLEW_EXT_texture_compression_s3tc;
+    case TextureFormat::BC5: return GLEW_VERSION_3_0 || GLEW_ARB_texture_compression_rgtc;
+    case TextureFormat::BC7: return GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc;
+    default: return true;
+    }
+}
+
+const char* TextureCompressor::GetFormatName(TextureFormat format) {
+    switch (format) {
+    case TextureFormat::BC1: return "BC1";
+    case TextureFormat::BC3: return "BC3";
+    case TextureFormat::BC5: return "BC5";
+    case TextureFormat::BC7: return "BC7";
+    default: return "RGBA8";
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// GPU layout of texture data. The BC formats store every 4x4 pixel block in a fixed
+// number of bytes, so they stay compressed in video memory and are sampled directly.
+enum class TextureFormat : uint32_t {
+    RGBA8, // 4 bytes per pixel
+    BC1,   // 8 bytes per block, opaque RGB (DXT1)
+    BC3,   // 16 bytes per block, RGB plus smooth alpha (DXT5)
+    BC5,   // 16 bytes per block, two independent channels (normal maps)
+    BC7    // 16 bytes per block, high quality RGBA
+};
+
+// CPU block-compression encoder used when textures are imported. Blocks are independent,
+// so images are encoded in parallel rows on the JobSystem; the per-block palette search
+// uses SSE2 where the target has it.
+class TextureCompressor {
+public:
+    // Encodes RGBA8 pixels into the given block format. Edge blocks of sizes that aren't
+    // a multiple of 4 repeat the last row/column.
+    static bool Compress(const unsigned char* rgba, int width, int height, TextureFormat format, std::vector<unsigned char>& output);
+
+    // Single 4x4 block encoders; block holds 16 RGBA8 pixels in row order
+    static void EncodeBlockBC1(const unsigned char* block, unsigned char* output);
+    static void EncodeBlockBC3(const unsigned char* block, unsigned char* output);
+    static void EncodeBlockBC5(const unsigned char* block, unsigned char* output); // Red and green only
+    static void EncodeBlockBC7(const unsigned char* block, unsigned char* output);
+
+    // Format queries
+    static bool IsCompressed(TextureFormat format) { return format != TextureFormat::RGBA8; }
+    static size_t GetBlockSize(TextureFormat format); // Bytes per 4x4 block, 0 for RGBA8
+    static size_t GetImageSize(TextureFormat format, int width, int height);
+    static GLenum GetGLFormat(TextureFormat format);
+    static bool IsSupported(TextureFormat format); // Needs a GL context
+    static const char* GetFormatName(TextureFormat format);
+};
@@ -0,0 +1,188 @@
+#include "TextureImporter.h"
+#include "Log.h"
+#include "DDSFile.h"
+#include "AssetDatabase.h"
+#include "MipGenerator.h"
+#include "TextureAtlas.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
+TextureCompression TextureImporter::s_compression = TextureCompression::Standard;
+MipFilter TextureImporter::s_mipFilter = MipFilter::Kaiser;
+
+namespace {
+    // Bump whenever the encoder or the mip generation changes the cooked output
+    const uint32_t TextureCookVersion = 2;
+
+    // Bump whenever packing changes the cooked atlas
+    const uint32_t AtlasCookVersion = 1;
+}
+
+uint64_t TextureImporter::GetImportSettingsHash() {
+    // Anything that changes the cooked output must be part of this hash
+    const uint64_t settings[] = { TextureCookVersion, static_cast<uint64_t>(s_compression), static_cast<uint64_t>(s_mipFilter) };
+    return AssetDatabase::HashBytes(settings, sizeof(settings));
+}
+
+TextureFormat TextureImporter::ChooseFormat(const ImageData& image) {
+    switch (s_compression) {
+    case TextureCompression::None: return TextureFormat::RGBA8;
+    case TextureCompression::HighQuality: return TextureFormat::BC7;
+    default: break;
+    }
+
+    // BC1 has no real alpha, so anything that isn't fully opaque needs BC3
+    for (size_t i = 3; i < image.pixels.size(); i += 4) {
+        if (image.pixels[i] != 255) {
+            return TextureFormat::BC3;
+        }
+    }
+    return TextureFormat::BC1;
+}
+
+bool TextureImporter::CookTexture(const ImageData& source, TextureFormat format, ImageData& cooked) {
+    if (source.format != TextureFormat::RGBA8 || !source.levels.empty() || source.width <= 0 || source.height <= 0) {
+        LOG_ERROR(Texture, "Texture cook needs a single level RGBA8 image");
+        return false;
+    }
+
+    // Filter the whole chain first (each level from the one above), then encode level by level
+    ImageData chain;
+    if (!MipGenerator::Generate(source, chain, s_mipFilter)) {
+        return false;
+    }
+    if (!TextureCompressor::IsCompressed(format)) {
+        cooked = std::move(chain);
+        return true;
+    }
+    return CompressChain(chain, format, cooked);
+}
+
+bool TextureImporter::CompressChain(const ImageData& chain, TextureFormat format, ImageData& cooked) {
+    cooked.width = chain.width;
+    cooked.height = chain.height;
+    cooked.channels = chain.channels;
+    cooked.format = format;
+    cooked.firstLevel = 0;
+    cooked.pixels.clear();
+    cooked.levels.clear();
+
+    std::vector<unsigned char> encoded;
+    for (const ImageLevel& level : chain.levels) {
+        if (!TextureCompressor::Compress(chain.pixels.data() + level.offset, level.width, level.height, format, encoded)) {
+            return false;
+        }
+        cooked.levels.push_back({ level.width, level.height, cooked.pixels.size(), encoded.size() });
+        cooked.pixels.insert(cooked.pixels.end(), encoded.begin(), encoded.end());
+    }
+    return true;
+}
+
+std::string TextureImporter::ImportTexture(const std::string& path) {
+    const uint64_t settingsHash = GetImportSettingsHash();
+    return ASSET_DATABASE->ImportOnce(path, settingsHash, [&path, settingsHash]() { return CookFile(path, settingsHash); });
+}
+
+std::string TextureImporter::CookFile(const std::string& path, uint64_t settingsHash) {
+    // DDS files are already in their final form
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == ".dds") {
+        ASSET_DATABASE->MarkImported(path, "", settingsHash);
+        return path;
+    }
+
+    LOG_DEBUG(Texture, "Importing texture: {}", path);
+    auto start = std::chrono::steady_clock::now();
+
+    ImageData image;
+    if (!Texture::DecodeFile(path, image)) {
+        return "";
+    }
+
+    ImageData cooked;
+    if (!CookTexture(image, ChooseFormat(image), cooked)) {
+        LOG_ERROR(Texture, "Failed to compress texture: {}", path);
+        return "";
+    }
+
+    std::string cookedPath = ASSET_DATABASE->GetCookedPath(path, ".dds");
+    if (!DDSFile::Write(cookedPath, cooked)) {
+        return "";
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    LOG_INFO(Texture, "Compressed {} to {}: {} KB -> {} KB in {} ms", path, TextureCompressor::GetFormatName(cooked.format), image.pixels.size() * 4 / 3 / 1024, cooked.pixels.size() / 1024, elapsed.count());
+
+    ASSET_DATABASE->MarkImported(path, cookedPath, settingsHash);
+    return cookedPath;
+}
+
+std::string TextureImporter::ImportAtlas(const std::vector<ResourceId>& textures) {
+    // Named after its members, so the same set of textures always finds the same cooked atlas
+    std::string members;
+    for (ResourceId id : textures) {
+        members += id.GetPath();
+        members += '\n';
+    }
+    char name[40];
+    std::snprintf(name, sizeof(name), "atlas_%016llx.satlas", static_cast<unsigned long long>(AssetDatabase::HashBytes(members.data(), members.size())));
+    const std::string atlasPath = (std::filesystem::path(ASSET_DATABASE->GetLibraryPath()) / name).string();
+
+    // The atlas has no source file of its own; the member contents stand in for it
+    const uint64_t settings[] = { AtlasCookVersion, GetImportSettingsHash(), TextureAtlas::MaxTextureSize, TextureAtlas::MaxPageSize,
+        TextureAtlas::Gutter, TextureAtlas::CellAlignment, TextureAtlas::MipCount };
+    uint64_t settingsHash = AssetDatabase::HashBytes(settings, sizeof(settings));
+    for (ResourceId id : textures) {
+        AssetRecord record;
+        if (!ImportTexture(id.GetPath()).empty()) {
+            ASSET_DATABASE->GetRecord(id, record);
+        }
+        settingsHash = AssetDatabase::HashBytes(&record.contentHash, sizeof(record.contentHash), settingsHash);
+    }
+
+    return ASSET_DATABASE->ImportOnce(atlasPath, settingsHash,
+        [&textures, &atlasPath, settingsHash]() { return CookAtlas(textures, atlasPath, settingsHash); });
+}
+
+std::string TextureImporter::CookAtlas(const std::vector<ResourceId>& textures, const std::string& atlasPath, uint64_t settingsHash) {
+    auto start = std::chrono::steady_clock::now();
+
+    // The cooked members are block compressed, so the sources are decoded again
+    std::vector<ImageData> images(textures.size());
+    JOB_SYSTEM->ParallelFor(textures.size(), [&](size_t i) {
+        if (!Texture::DecodeFile(textures[i].GetPath(), images[i])) {
+            images[i] = ImageData();
+        }
+    });
+
+    // A page holding a single texture saves no binds; the table is still written so the decision is cached
+    std::vector<AtlasRegion> regions(textures.size());
+    std::vector<ImageData> pages;
+    if (std::count_if(images.begin(), images.end(), TextureAtlas::CanPack) >= 2) {
+        std::vector<const ImageData*> sources;
+        for (const ImageData& image : images) {
+            sources.push_back(&image);
+        }
+        regions = TextureAtlas::Pack(sources, pages);
+    }
+
+    for (size_t page = 0; page < pages.size(); page++) {
+        if (!DDSFile::Write(TextureAtlas::GetPagePath(atlasPath, page), pages[page])) {
+            return "";
+        }
+    }
+    if (!TextureAtlas::WriteFile(atlasPath, regions, pages.size())) {
+        return "";
+    }
+
+    const size_t packed = std::count_if(regions.begin(), regions.end(), [](const AtlasRegion& region) { return region.page >= 0; });
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    LOG_INFO(Texture, "Cooked atlas {}: {} of {} textures on {} pages in {} ms", atlasPath, packed, textures.size(), pages.size(), elapsed.count());
+
+    ASSET_DATABASE->MarkImported(atlasPath, atlasPath, settingsHash);
+    return atlasPath;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Texture.h"
+#include "MipGenerator.h"
+#include "ResourceId.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// How imported textures are stored in the library
+enum class TextureCompression {
+    None,       // RGBA8, still cooked for the mip chain
+    Standard,   // BC1 for opaque images, BC3 when they use alpha (4 to 8 times smaller)
+    HighQuality // BC7 for everything (4 times smaller, fewer artifacts)
+};
+
+// Cooks source images (.png, .tga) into block-compressed .dds files with a full mip chain
+// built on the CPU, so loading them is a file read and a glCompressedTexImage2D per level.
+class TextureImporter {
+private:
+    static TextureCompression s_compression;
+    static MipFilter s_mipFilter;
+
+    static std::string CookFile(const std::string& path, uint64_t settingsHash); // Cooks unconditionally
+    static std::string CookAtlas(const std::vector<ResourceId>& textures, const std::string& atlasPath, uint64_t settingsHash);
+
+public:
+    // Brings the cooked texture up to date. Returns the file to load: the cooked .dds,
+    // the source when it needs no cooking, or an empty string if the import failed.
+    // Safe to call from worker threads.
+    static std::string ImportTexture(const std::string& path);
+    static uint64_t GetImportSettingsHash();
+
+    // Packs textures into atlas pages in the library (see TextureAtlas), recooked when a member or
+    // the import settings change. Members are sorted by path without duplicates, so a set of
+    // textures always maps to one atlas; its regions follow that order. Returns the region
+    // table (.satlas), or an empty string if the cook failed. Safe to call from worker threads.
+    static std::string ImportAtlas(const std::vector<ResourceId>& textures);
+
+    // Decoded RGBA8 image in, mip chain in the chosen format out
+    static bool CookTexture(const ImageData& source, TextureFormat format, ImageData& cooked);
+    static bool CompressChain(const ImageData& chain, TextureFormat format, ImageData& cooked); // RGBA8 levels in, one encoded level per level out
+    static TextureFormat ChooseFormat(const ImageData& image);
+
+    static void SetCompression(TextureCompression compression) { s_compression = compression; }
+    static TextureCompression GetCompression() { return s_compression; }
+    static void SetMipFilter(MipFilter filter) { s_mipFilter = filter; }
+    static MipFilter GetMipFilter() { return s_mipFilter; }
+};
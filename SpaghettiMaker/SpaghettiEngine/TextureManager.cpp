@@ -1,95 +1,631 @@
 #include "TextureManager.h"
+#include "Log.h"
+#include "AssetDatabase.h"
+#include "TextureImporter.h"
+#include "DDSFile.h"
+#include "JobSystem.h"
+#include "UploadQueue.h"
+#include "TextureAtlas.h"
+#include "Profiler.h"
 #include "imgui.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <filesystem>
-#include <iostream>
 
 TextureManager* TextureManager::s_instance = nullptr;
 
+namespace {
+    // Streamed textures load whole up to this size, and never drop below it
+    const int StreamingFloorSize = 64;
+
+    // Frames a texture can go undrawn before its fine levels become evictable
+    const uint64_t StreamingIdleFrames = 120;
+
+    // Copies the levels into the upload ring, so the upload on the main thread reads them from there.
+    // Returns false when the ring is unavailable or full; the pixels then stay where they are.
+    bool StageLevels(ImageData& image, const unsigned char* source, size_t size) {
+        if (image.levels.empty()) return false;
+
+        StagingBufferPtr staging = TEXTURE_UPLOAD_RING->Allocate(size);
+        if (!staging) return false;
+
+        std::memcpy(staging->GetData(), source, size);
+        image.staging = std::move(staging);
+        image.pixels.clear();
+        image.pixels.shrink_to_fit();
+        return true;
+    }
+}
+
 void TextureManager::Initialize() {
+    TEXTURE_UPLOAD_RING->Initialize();
+
     // Create default checker texture
     _defaultTexture = Texture::CreateCheckerboard(64, 64);
 
     // Add it to cache
-    _textureCache["__default"] = _defaultTexture;
+    _textureCache[GetDefaultTextureId()] = _defaultTexture;
 }
 
 void TextureManager::Cleanup() {
+    _streamedTextures.clear();
+    _atlasPages.clear();
+    _atlasViews.clear();
+    _pendingReloads.clear();
+    TEXTURE_UPLOAD_RING->Cleanup();
     _textureCache.clear();
     _defaultTexture = nullptr;
 }
 
+ResourceId TextureManager::GetDefaultTextureId() {
+    static const ResourceId id = ResourceId::FromCanonical("__default");
+    return id;
+}
+
 TexturePtr TextureManager::LoadTexture(const std::string& path) {
-    // Normalize path
-    std::filesystem::path fsPath(path);
-    std::string normalizedPath = fsPath.string();
+    return LoadTexture(ResourceId::FromPath(path));
+}
 
+TexturePtr TextureManager::LoadTexture(ResourceId id) {
+    PROFILE_SCOPE("TextureManager::LoadTexture");
     // Check if texture is already loaded
-    auto it = _textureCache.find(normalizedPath);
+    auto it = _textureCache.find(id);
     if (it != _textureCache.end()) {
         return it->second;
     }
 
     // Check file extension
-    std::string ext = fsPath.extension().string();
+    std::string ext = std::filesystem::path(id.GetPath()).extension().string();
     std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
 
-    // Try loading the texture
-    auto texture = std::make_shared<Texture>();
-
     // If it's a PNG, ensure DevIL can handle PNG
     if (ext == ".png") {
         ilEnable(IL_PNG_ALPHA_INDEX);
     }
 
-    if (texture->LoadFromFile(normalizedPath)) {
-        _textureCache[normalizedPath] = texture;
+    PreparedTexture prepared;
+    if (PrepareTexture(id, prepared)) {
+        return AddTexture(id, std::move(prepared));
+    }
+
+    LOG_WARNING(Texture, "Failed to load texture, using default: {}", id.GetPath());
+    return _defaultTexture;
+}
+
+std::vector<TexturePtr> TextureManager::LoadTextures(const std::vector<std::string>& paths) {
+    PROFILE_SCOPE("TextureManager::LoadTextures");
+    // Everything not cached yet, once
+    std::vector<ResourceId> ids;
+    std::vector<ResourceId> missing;
+    for (const std::string& path : paths) {
+        const ResourceId id = ResourceId::FromPath(path);
+        ids.push_back(id);
+        if (!_textureCache.count(id) && std::find(missing.begin(), missing.end(), id) == missing.end()) {
+            missing.push_back(id);
+        }
+    }
+
+    // Import and decode on the workers; only the uploads need the GL thread
+    std::vector<PreparedTexture> prepared(missing.size());
+    std::vector<char> succeeded(missing.size(), 0);
+    JOB_SYSTEM->ParallelFor(missing.size(), [&](size_t i) {
+        succeeded[i] = PrepareTexture(missing[i], prepared[i]);
+    });
+
+    for (size_t i = 0; i < missing.size(); i++) {
+        if (succeeded[i]) {
+            AddTexture(missing[i], std::move(prepared[i]));
+        }
+        else {
+            LOG_WARNING(Texture, "Failed to load texture, using default: {}", missing[i].GetPath());
+        }
+    }
+
+    std::vector<TexturePtr> textures;
+    textures.reserve(ids.size());
+    for (ResourceId id : ids) {
+        auto it = _textureCache.find(id);
+        textures.push_back(it != _textureCache.end() ? it->second : _defaultTexture);
+    }
+    return textures;
+}
+
+bool TextureManager::PrepareTexture(const std::string& path, PreparedTexture& prepared) const {
+    return PrepareTexture(ResourceId::FromPath(path), prepared);
+}
+
+bool TextureManager::PrepareTexture(ResourceId id, PreparedTexture& prepared) const {
+    PROFILE_SCOPE("TextureManager::PrepareTexture");
+    // Load the compressed version from the library, cooking it first if the source changed
+    const std::string& path = id.GetPath();
+    std::string importedPath = TextureImporter::ImportTexture(path);
+    if (importedPath.empty()) {
+        importedPath = path;
+    }
+
+    if (_streamingEnabled && PrepareStreamed(importedPath, prepared)) {
+        return true;
+    }
+    if (Texture::DecodeFile(importedPath, prepared.image) || (importedPath != path && Texture::DecodeFile(path, prepared.image))) {
+        StageLevels(prepared.image, prepared.image.pixels.data(), prepared.image.pixels.size());
+        return true;
+    }
+    return false;
+}
+
+bool TextureManager::PrepareStreamed(const std::string& cookedPath, PreparedTexture& prepared) const {
+    std::string extension = std::filesystem::path(cookedPath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension != ".dds") return false;
+
+    auto file = std::make_shared<MappedFile>();
+    ImageData header;
+    size_t dataOffset = 0;
+    if (!file->Open(cookedPath) || !DDSFile::ReadHeader(file->GetData(), file->GetSize(), header, dataOffset)) {
+        return false;
+    }
+    if (!TextureCompressor::IsCompressed(header.format) || header.levels.size() < 2) {
+        return false;
+    }
+
+    // Start with the first level that fits the floor size; textures already that small load whole
+    int firstLevel = 0;
+    while (firstLevel + 1 < static_cast<int>(header.levels.size()) &&
+        std::max(header.levels[firstLevel].width, header.levels[firstLevel].height) > StreamingFloorSize) {
+        ++firstLevel;
+    }
+    if (firstLevel == 0) return false;
+
+    ImageData& image = prepared.image;
+    image.width = header.width;
+    image.height = header.height;
+    image.channels = header.channels;
+    image.format = header.format;
+    image.firstLevel = firstLevel;
+
+    const size_t begin = header.levels[firstLevel].offset;
+    const size_t end = header.levels.back().offset + header.levels.back().size;
+    for (size_t i = firstLevel; i < header.levels.size(); i++) {
+        ImageLevel level = header.levels[i];
+        level.offset -= begin;
+        image.levels.push_back(level);
+    }
+
+    // Straight from the mapping into the upload ring when there is room
+    const unsigned char* source = file->GetData() + dataOffset + begin;
+    if (!StageLevels(image, source, end - begin)) {
+        image.pixels.assign(source, source + (end - begin));
+    }
+
+    prepared.streamFile = file;
+    prepared.streamDataOffset = dataOffset;
+    prepared.streamLevels = std::move(header.levels);
+    return true;
+}
+
+TexturePtr TextureManager::AddTexture(const std::string& path, PreparedTexture&& prepared) {
+    return AddTexture(ResourceId::FromPath(path), std::move(prepared));
+}
+
+TexturePtr TextureManager::AddTexture(ResourceId id, PreparedTexture&& prepared) {
+    PROFILE_SCOPE("TextureManager::AddTexture");
+    // Another load may have brought it in while this one was decoding
+    auto it = _textureCache.find(id);
+    if (it != _textureCache.end()) {
+        return it->second;
+    }
+
+    auto texture = std::make_shared<Texture>();
+    if (texture->LoadFromImage(prepared.image, id.GetPath())) {
+        _textureCache[id] = texture;
+        RegisterStream(id, prepared);
+        return texture;
+    }
+
+    // The GPU may lack the compressed format; the source always works
+    if (texture->LoadFromFile(id.GetPath())) {
+        _textureCache[id] = texture;
         return texture;
     }
 
-    std::cerr << "Failed to load texture, using default: " << normalizedPath << std::endl;
     return _defaultTexture;
 }
 
+void TextureManager::RegisterStream(ResourceId id, PreparedTexture& prepared) {
+    if (!prepared.streamFile) return;
+
+    StreamedTexture& stream = _streamedTextures[id];
+    stream.file = std::move(prepared.streamFile);
+    stream.dataOffset = prepared.streamDataOffset;
+    stream.levels = std::move(prepared.streamLevels);
+    stream.floorMip = stream.wantedMip = prepared.image.firstLevel;
+    stream.lastDrawnFrame = _frame;
+}
+
+void TextureManager::UpdateStreaming() {
+    PROFILE_SCOPE("TextureManager::UpdateStreaming");
+    ++_frame;
+    Texture::SetCurrentFrame(_frame);
+    TEXTURE_UPLOAD_RING->Update();
+
+    // Collect what the last frame drew; textures off screen for a while fall back to their floor
+    size_t neededBytes = 0;
+    std::vector<std::pair<StreamedTexture*, Texture*>> streams;
+    for (auto& [path, stream] : _streamedTextures) {
+        auto it = _textureCache.find(path);
+        if (it == _textureCache.end()) continue;
+
+        Texture* texture = it->second.get();
+        int requested = texture->TakeRequestedMip();
+        if (requested != INT_MAX) {
+            stream.wantedMip = std::clamp(requested, 0, stream.floorMip);
+            stream.lastDrawnFrame = _frame;
+        }
+        else if (_frame - stream.lastDrawnFrame > StreamingIdleFrames) {
+            stream.wantedMip = stream.floorMip;
+        }
+
+        if (!stream.loading && stream.wantedMip < texture->GetResidentMip()) {
+            neededBytes += texture->GetMipSize(texture->GetResidentMip() - 1);
+        }
+        streams.emplace_back(&stream, texture);
+    }
+
+    // Every texture counts against the budget, atlas pages included
+    size_t residentBytes = GetGPUBytes();
+
+    // Under pressure, drop the levels nobody needs any more, least recently drawn first
+    if (residentBytes + neededBytes > _memoryBudget) {
+        std::sort(streams.begin(), streams.end(), [](const auto& a, const auto& b) {
+            return a.first->lastDrawnFrame < b.first->lastDrawnFrame;
+        });
+        for (auto& [stream, texture] : streams) {
+            if (residentBytes + neededBytes <= _memoryBudget) break;
+            if (stream->loading || texture->GetResidentMip() >= stream->wantedMip) continue;
+
+            size_t before = texture->GetGPUBytes();
+            texture->EvictMips(stream->wantedMip);
+            residentBytes -= before - texture->GetGPUBytes();
+        }
+    }
+    if (residentBytes + neededBytes > _memoryBudget) {
+        EvictIdleTextures(residentBytes, neededBytes);
+    }
+    ReloadEvictedTextures();
+
+    // Stream in one level per texture, coarse to fine, as long as it fits the budget
+    for (auto& [path, stream] : _streamedTextures) {
+        auto it = _textureCache.find(path);
+        if (it == _textureCache.end() || stream.loading) continue;
+
+        const TexturePtr& texture = it->second;
+        const int level = texture->GetResidentMip() - 1;
+        if (level < stream.wantedMip || level >= static_cast<int>(stream.levels.size())) continue;
+
+        const ImageLevel& source = stream.levels[level];
+        if (residentBytes + source.size > _memoryBudget) continue;
+        residentBytes += source.size;
+        stream.loading = true;
+
+        // The copy out of the mapping is where the disk read happens, so it runs on a worker,
+        // into the upload ring if it has room and into a plain buffer otherwise
+        std::weak_ptr<Texture> weakTexture = texture;
+        std::shared_ptr<MappedFile> file = stream.file;
+        const size_t offset = stream.dataOffset + source.offset;
+        const size_t size = source.size;
+        StagingBufferPtr staging = TEXTURE_UPLOAD_RING->Allocate(size);
+        const ResourceId key = path;
+        JOB_SYSTEM->Schedule([key, weakTexture, file, offset, size, level, staging]() {
+            auto data = std::make_shared<std::vector<unsigned char>>();
+            if (staging) {
+                std::memcpy(staging->GetData(), file->GetData() + offset, size);
+            }
+            else {
+                data->assign(file->GetData() + offset, file->GetData() + offset + size);
+            }
+            UPLOAD_QUEUE->Enqueue([key, weakTexture, data, staging, level]() {
+                TEXTURE_MANAGER->FinishStreamedMip(key, weakTexture, level, *data, staging);
+            });
+        });
+    }
+}
+
+void TextureManager::EvictIdleTextures(size_t& residentBytes, size_t neededBytes) {
+    // Whole textures nobody bound for a while, least recently used first
+    std::vector<std::pair<ResourceId, Texture*>> idle;
+    for (const auto& [path, texture] : _textureCache) {
+        if (texture == _defaultTexture || texture->IsInAtlas() || texture->IsEvicted() || !texture->IsLoaded()) continue;
+        if (_frame - texture->GetLastUsedFrame() <= StreamingIdleFrames) continue;
+        idle.emplace_back(path, texture.get());
+    }
+    std::sort(idle.begin(), idle.end(), [](const auto& a, const auto& b) {
+        return a.second->GetLastUsedFrame() < b.second->GetLastUsedFrame();
+    });
+
+    for (auto& [path, texture] : idle) {
+        if (residentBytes + neededBytes <= _memoryBudget) break;
+        const size_t before = texture->GetGPUBytes();
+
+        // Down to the small mips if the cooked file can bring the rest back, else to the placeholder
+        auto stream = _streamedTextures.find(path);
+        if (stream == _streamedTextures.end()) {
+            if (StartStreaming(path, *texture)) {
+                residentBytes -= before - texture->GetGPUBytes();
+                continue;
+            }
+        }
+        else if (stream->second.loading) {
+            continue;
+        }
+        else if (texture->GetResidentMip() < stream->second.floorMip) {
+            texture->EvictMips(stream->second.floorMip);
+            residentBytes -= before - texture->GetGPUBytes();
+            continue;
+        }
+
+        _streamedTextures.erase(path);
+        texture->EvictToPlaceholder();
+        residentBytes -= before;
+    }
+}
+
+bool TextureManager::StartStreaming(ResourceId id, Texture& texture) {
+    PreparedTexture prepared;
+    if (!PrepareStreamed(ASSET_DATABASE->Resolve(id.GetPath()), prepared)) return false;
+
+    // Only if the file holds the levels this texture was loaded with
+    if (prepared.image.format != texture.GetFormat() || static_cast<int>(prepared.streamLevels.size()) != texture.GetMipCount() ||
+        texture.GetResidentMip() != 0) {
+        return false;
+    }
+
+    const int floorMip = prepared.image.firstLevel;
+    RegisterStream(id, prepared);
+    texture.EvictMips(floorMip);
+    return true;
+}
+
+void TextureManager::ReloadEvictedTextures() {
+    // Placeholders bound since the last update come back through the workers, like a fresh load
+    for (const auto& [path, texture] : _textureCache) {
+        if (!texture->IsEvicted() || texture->GetLastUsedFrame() + 1 < _frame || _pendingReloads.count(path)) continue;
+        _pendingReloads.insert(path);
+
+        std::weak_ptr<Texture> weakTexture = texture;
+        const ResourceId key = path;
+        JOB_SYSTEM->Schedule([key, weakTexture]() {
+            auto prepared = std::make_shared<PreparedTexture>();
+            if (!TEXTURE_MANAGER->PrepareTexture(key, *prepared)) {
+                prepared = nullptr;
+            }
+            UPLOAD_QUEUE->Enqueue([key, weakTexture, prepared]() {
+                TEXTURE_MANAGER->FinishReload(key, weakTexture, prepared);
+            });
+        });
+    }
+}
+
+void TextureManager::FinishStreamedMip(ResourceId id, const std::weak_ptr<Texture>& texture, int level, const std::vector<unsigned char>& data,
+    const StagingBufferPtr& staging) {
+    auto it = _streamedTextures.find(id);
+    if (it != _streamedTextures.end()) {
+        it->second.loading = false;
+    }
+
+    // The texture may have been unloaded, or evicted past this level, while the read was in flight
+    TexturePtr loaded = texture.lock();
+    if (!loaded) return;
+
+    if (staging) {
+        TEXTURE_UPLOAD_RING->Bind();
+        loaded->UploadMip(level, staging->GetGLPointer(), staging->GetSize());
+        TEXTURE_UPLOAD_RING->Unbind();
+        TEXTURE_UPLOAD_RING->Submit(*staging);
+    }
+    else {
+        loaded->UploadMip(level, data.data(), data.size());
+    }
+}
+
+void TextureManager::PackIntoAtlas(const std::vector<std::string>& paths) {
+    PROFILE_SCOPE("TextureManager::PackIntoAtlas");
+    // Packed by an earlier load; the pages are still up
+    if (std::all_of(paths.begin(), paths.end(), [this](const std::string& path) { return GetAtlasTexture(path) != nullptr; })) return;
+
+    PreparedAtlas atlas;
+    if (PrepareAtlas(paths, atlas)) {
+        AddAtlas(std::move(atlas));
+    }
+}
+
+bool TextureManager::PrepareAtlas(const std::vector<std::string>& paths, PreparedAtlas& atlas) const {
+    PROFILE_SCOPE("TextureManager::PrepareAtlas");
+    if (!_atlasingEnabled) return false;
+
+    // Sorted by path, as the cooked atlas lists them
+    PreparedAtlas prepared;
+    for (const std::string& path : paths) {
+        prepared.textures.push_back(ResourceId::FromPath(path));
+    }
+    std::sort(prepared.textures.begin(), prepared.textures.end(), [](ResourceId a, ResourceId b) { return a.GetPath() < b.GetPath(); });
+    prepared.textures.erase(std::unique(prepared.textures.begin(), prepared.textures.end()), prepared.textures.end());
+
+    // A page holding a single texture saves no binds
+    if (prepared.textures.size() < 2) return false;
+
+    // Packing and compression happen in the import, once; loading is a table and a few .dds reads
+    const std::string atlasPath = TextureImporter::ImportAtlas(prepared.textures);
+    size_t pageCount = 0;
+    if (atlasPath.empty() || !TextureAtlas::ReadFile(atlasPath, prepared.regions, pageCount) ||
+        prepared.regions.size() != prepared.textures.size() || pageCount == 0) {
+        return false;
+    }
+
+    prepared.pages.resize(pageCount);
+    for (size_t page = 0; page < pageCount; page++) {
+        ImageData& image = prepared.pages[page];
+        if (!Texture::DecodeFile(TextureAtlas::GetPagePath(atlasPath, page), image)) {
+            return false;
+        }
+        StageLevels(image, image.pixels.data(), image.pixels.size());
+    }
+
+    atlas = std::move(prepared);
+    return true;
+}
+
+void TextureManager::AddAtlas(PreparedAtlas&& atlas) {
+    PROFILE_SCOPE("TextureManager::AddAtlas");
+    std::erase_if(_atlasPages, [](const std::weak_ptr<Texture>& page) { return page.expired(); });
+    if (atlas.pages.empty() || atlas.regions.size() != atlas.textures.size()) return;
+
+    // Another load of the same textures may have brought the pages up already
+    bool viewed = true;
+    for (size_t i = 0; viewed && i < atlas.textures.size(); i++) {
+        viewed = atlas.regions[i].page < 0 || GetAtlasTexture(atlas.textures[i].GetPath());
+    }
+    if (viewed) return;
+
+    std::vector<TexturePtr> pages;
+    for (const ImageData& pageImage : atlas.pages) {
+        auto page = std::make_shared<Texture>();
+        if (page->LoadFromImage(pageImage, "__atlas" + std::to_string(_atlasPages.size()))) {
+            _atlasPages.push_back(page);
+            pages.push_back(page);
+        }
+        else {
+            pages.push_back(nullptr);
+        }
+    }
+
+    size_t packed = 0;
+    for (size_t i = 0; i < atlas.textures.size(); i++) {
+        const AtlasRegion& region = atlas.regions[i];
+        if (region.page < 0 || !pages[region.page]) continue;
+
+        _atlasViews[atlas.textures[i]] = Texture::CreateAtlasView(pages[region.page], atlas.textures[i].GetPath(), region.x, region.y, region.width, region.height);
+        ++packed;
+    }
+    LOG_DEBUG(Texture, "Uploaded {} atlas pages for {} textures", pages.size(), packed);
+}
+
+TexturePtr TextureManager::GetAtlasTexture(const std::string& path) const {
+    auto it = _atlasViews.find(ResourceId::FromPath(path));
+    return (it != _atlasViews.end()) ? it->second.lock() : nullptr;
+}
+
+size_t TextureManager::GetAtlasPageCount() const {
+    return std::count_if(_atlasPages.begin(), _atlasPages.end(), [](const std::weak_ptr<Texture>& page) { return !page.expired(); });
+}
+
+void TextureManager::FinishReload(ResourceId id, const std::weak_ptr<Texture>& texture, const std::shared_ptr<PreparedTexture>& prepared) {
+    _pendingReloads.erase(id);
+
+    // Unloaded, or replaced by another load, while the read was in flight
+    TexturePtr loaded = texture.lock();
+    auto it = _textureCache.find(id);
+    if (!loaded || !loaded->IsEvicted() || it == _textureCache.end() || it->second != loaded) return;
+
+    if (prepared && loaded->LoadFromImage(prepared->image, id.GetPath())) {
+        RegisterStream(id, *prepared);
+    }
+    else {
+        loaded->LoadFromFile(id.GetPath());
+    }
+}
+
+size_t TextureManager::GetEvictedTextureCount() const {
+    return std::count_if(_textureCache.begin(), _textureCache.end(), [](const auto& entry) { return entry.second->IsEvicted(); });
+}
+
 TexturePtr TextureManager::GetTexture(const std::string& path) const {
-    std::filesystem::path fsPath(path);
-    std::string normalizedPath = fsPath.lexically_normal().string();
+    return GetTexture(ResourceId::FromPath(path));
+}
 
-    auto it = _textureCache.find(normalizedPath);
+TexturePtr TextureManager::GetTexture(ResourceId id) const {
+    auto it = _textureCache.find(id);
     return (it != _textureCache.end()) ? it->second : _defaultTexture;
 }
 
 void TextureManager::UnloadTexture(const std::string& path) {
-    std::filesystem::path fsPath(path);
-    std::string normalizedPath = fsPath.lexically_normal().string();
+    UnloadTexture(ResourceId::FromPath(path));
+}
 
-    auto it = _textureCache.find(normalizedPath);
-    if (it != _textureCache.end()) {
-        _textureCache.erase(it);
+void TextureManager::UnloadTexture(ResourceId id) {
+    if (_textureCache.erase(id)) {
+        _streamedTextures.erase(id);
     }
 }
 
 void TextureManager::UnloadUnusedTextures() {
+    PROFILE_SCOPE("TextureManager::UnloadUnusedTextures");
     for (auto it = _textureCache.begin(); it != _textureCache.end();) {
         // Don't unload default texture
-        if (it->first == "__default") {
+        if (it->first == GetDefaultTextureId()) {
             ++it;
             continue;
         }
 
         // Check if texture is only referenced by the cache
         if (it->second.use_count() == 1) {
+            _streamedTextures.erase(it->first);
             it = _textureCache.erase(it);
         }
         else {
             ++it;
         }
     }
+
+    // Views go with the last material using them, and pages with their last view
+    for (auto it = _atlasViews.begin(); it != _atlasViews.end();) {
+        it = it->second.expired() ? _atlasViews.erase(it) : std::next(it);
+    }
+    std::erase_if(_atlasPages, [](const std::weak_ptr<Texture>& page) { return page.expired(); });
+}
+
+size_t TextureManager::GetGPUBytes() const {
+    size_t bytes = 0;
+    for (const auto& [path, texture] : _textureCache) {
+        bytes += texture->GetGPUBytes();
+    }
+    for (const auto& page : _atlasPages) {
+        if (TexturePtr locked = page.lock()) {
+            bytes += locked->GetGPUBytes();
+        }
+    }
+    return bytes;
 }
 
 void TextureManager::OnImGuiRender() {
     if (ImGui::Begin("Texture Manager")) {
         ImGui::Text("Loaded Textures: %zu", _textureCache.size());
 
+        // Memory use against the budget
+        const double usedMB = GetGPUBytes() / (1024.0 * 1024.0);
+        const double budgetMB = _memoryBudget / (1024.0 * 1024.0);
+        char overlay[64];
+        snprintf(overlay, sizeof(overlay), "%.1f / %.0f MB", usedMB, budgetMB);
+        ImGui::ProgressBar(static_cast<float>(std::min(usedMB / budgetMB, 1.0)), ImVec2(-1.0f, 0.0f), overlay);
+        int budget = static_cast<int>(_memoryBudget / (1024 * 1024));
+        if (ImGui::SliderInt("Memory Budget (MB)", &budget, 16, 2048)) {
+            _memoryBudget = static_cast<size_t>(budget) * 1024 * 1024;
+        }
+
+        if (TEXTURE_UPLOAD_RING->IsAvailable()) {
+            ImGui::Text("Upload Ring: %.1f / %.0f MB in flight (%zu times full)", TEXTURE_UPLOAD_RING->GetUsedBytes() / (1024.0 * 1024.0),
+                TEXTURE_UPLOAD_RING->GetCapacity() / (1024.0 * 1024.0), TEXTURE_UPLOAD_RING->GetFailedAllocations());
+        }
+        else {
+            ImGui::Text("Upload Ring: unavailable, uploading from client memory");
+        }
+
+        ImGui::Checkbox("Stream Mips", &_streamingEnabled);
+        ImGui::Text("Streamed Textures: %zu", _streamedTextures.size());
+        ImGui::Text("Evicted Textures: %zu (%zu reloading)", GetEvictedTextureCount(), _pendingReloads.size());
+        ImGui::Checkbox("Atlas Small Textures", &_atlasingEnabled);
+        ImGui::Text("Atlas Pages: %zu", GetAtlasPageCount());
+
         if (ImGui::Button("Unload Unused")) {
             UnloadUnusedTextures();
         }
@@ -97,22 +633,38 @@ void TextureManager::OnImGuiRender() {
         ImGui::Separator();
 
         for (const auto& [path, texture] : _textureCache) {
-            ImGui::PushID(path.c_str());
+            ImGui::PushID(static_cast<int>(path.GetValue()));
 
-            bool isDefault = (path == "__default");
-            std::string displayName = isDefault ? "Default (Checker)" : std::filesystem::path(path).filename().string();
+            bool isDefault = (path == GetDefaultTextureId());
+            std::string displayName = isDefault ? "Default (Checker)" : std::filesystem::path(path.GetPath()).filename().string();
 
             if (ImGui::TreeNode(displayName.c_str())) {
-                ImGui::Text("Path: %s", path.c_str());
+                ImGui::Text("Path: %s", path.GetPath().c_str());
                 ImGui::Text("Size: %dx%d", texture->GetWidth(), texture->GetHeight());
+                ImGui::Text("Format: %s, %zu KB", TextureCompressor::GetFormatName(texture->GetFormat()), texture->GetGPUBytes() / 1024);
+                if (texture->IsEvicted()) {
+                    ImGui::Text("Evicted, reloads when used");
+                }
+                else if (!isDefault) {
+                    ImGui::Text("Last used: %llu frames ago", static_cast<unsigned long long>(_frame - std::min(_frame, texture->GetLastUsedFrame())));
+                }
+                if (TexturePtr view = GetAtlasTexture(path.GetPath())) {
+                    const TexturePtr& page = view->GetAtlasPage();
+                    ImGui::Text("Also in atlas: %dx%d page, %zu KB", page->GetWidth(), page->GetHeight(), page->GetGPUBytes() / 1024);
+                }
+                if (_streamedTextures.count(path)) {
+                    ImGui::Text("Streamed: mip %d of %d resident", texture->GetResidentMip(), texture->GetMipCount());
+                }
 
                 // Fixed: Get use_count from the shared_ptr in the cache
-                auto refCount = _textureCache[path].use_count();
+                auto refCount = texture.use_count();
                 ImGui::Text("References: %d", static_cast<int>(refCount));
 
                 // Preview texture
                 ImTextureID texId = reinterpret_cast<ImTextureID>(static_cast<uintptr_t>(texture->GetID()));
-                ImGui::Image(texId, ImVec2(100, 100));
+                const fvec2 uv0 = texture->GetUVOffset();
+                const fvec2 uv1 = uv0 + texture->GetUVScale();
+                ImGui::Image(texId, ImVec2(100, 100), ImVec2(uv0.x, uv0.y), ImVec2(uv1.x, uv1.y));
 
                 ImGui::TreePop();
             }
@@ -1,15 +1,71 @@
 #pragma once
 #include "Texture.h"
-#include <unordered_map>
+#include "TextureAtlas.h"
+#include "MappedFile.h"
+#include "ResourceId.h"
+#include "FlatHashMap.h"
+#include <unordered_set>
 #include <memory>
 #include <string>
+#include <cstdint>
 
+// Everything the first upload of a texture needs, read off the main thread
+struct PreparedTexture {
+    ImageData image;                        // Uploaded right away
+    std::shared_ptr<MappedFile> streamFile; // Cooked file the finer mips stream from, if streamed
+    size_t streamDataOffset = 0;
+    std::vector<ImageLevel> streamLevels;   // Every level in the file, offsets relative to streamDataOffset
+};
+
+// A cooked atlas read off the main thread, one region per member texture
+struct PreparedAtlas {
+    std::vector<ResourceId> textures;
+    std::vector<AtlasRegion> regions;
+    std::vector<ImageData> pages;
+};
+
+// Streamed textures start with their small mips and load finer ones as objects using them
+// get bigger on screen. Every texture counts against one memory budget: when it is exceeded,
+// streamed levels nobody needs go first, then textures that haven't been bound for a while,
+// least recently used first, down to their small mips or to a placeholder that reloads on use.
 class TextureManager {
 private:
+    struct StreamedTexture {
+        std::shared_ptr<MappedFile> file;
+        size_t dataOffset = 0;
+        std::vector<ImageLevel> levels;
+        int floorMip = 0;          // Coarsest resident level; never evicted
+        int wantedMip = 0;         // Finest level the last frames drew
+        uint64_t lastDrawnFrame = 0;
+        bool loading = false;      // A level is on its way
+    };
+
     static TextureManager* s_instance;
-    std::unordered_map<std::string, TexturePtr> _textureCache;
+    FlatHashMap<ResourceId, TexturePtr, ResourceIdHash> _textureCache;
+    FlatHashMap<ResourceId, StreamedTexture, ResourceIdHash> _streamedTextures;
     TexturePtr _defaultTexture; // Checker texture
 
+    // Atlasing; pages are owned by the views into them, and the views by the materials using them.
+    // Views are kept apart from the cache, which always hands out the standalone texture.
+    bool _atlasingEnabled = true;
+    std::vector<std::weak_ptr<Texture>> _atlasPages;
+    FlatHashMap<ResourceId, std::weak_ptr<Texture>, ResourceIdHash> _atlasViews; // By source texture
+
+    // Streaming and budget settings
+    bool _streamingEnabled = true;
+    size_t _memoryBudget = 256ull * 1024 * 1024;
+    uint64_t _frame = 0;
+    std::unordered_set<ResourceId, ResourceIdHash> _pendingReloads; // Evicted textures on their way back
+
+    bool PrepareStreamed(const std::string& cookedPath, PreparedTexture& prepared) const;
+    void RegisterStream(ResourceId id, PreparedTexture& prepared);
+    bool StartStreaming(ResourceId id, Texture& texture); // Evicts to the floor a texture loaded whole
+    void EvictIdleTextures(size_t& residentBytes, size_t neededBytes);
+    void ReloadEvictedTextures();
+    void FinishReload(ResourceId id, const std::weak_ptr<Texture>& texture, const std::shared_ptr<PreparedTexture>& prepared);
+    void FinishStreamedMip(ResourceId id, const std::weak_ptr<Texture>& texture, int level, const std::vector<unsigned char>& data,
+        const StagingBufferPtr& staging);
+
     // Private constructor for singleton
     TextureManager() = default;
 
@@ -30,18 +86,48 @@ public:
     void Initialize();
     void Cleanup();
 
-    // Resource management
+    // Resource management. The string overloads hash the path; hot paths keep the ResourceId instead.
     TexturePtr LoadTexture(const std::string& path);
+    TexturePtr LoadTexture(ResourceId id);
+    std::vector<TexturePtr> LoadTextures(const std::vector<std::string>& paths); // Decodes in parallel, then uploads
+    bool PrepareTexture(const std::string& path, PreparedTexture& prepared) const; // Imports and reads; safe on worker threads
+    bool PrepareTexture(ResourceId id, PreparedTexture& prepared) const;
+    TexturePtr AddTexture(const std::string& path, PreparedTexture&& prepared);    // Uploads a prepared texture
+    TexturePtr AddTexture(ResourceId id, PreparedTexture&& prepared);
     TexturePtr GetTexture(const std::string& path) const;
+    TexturePtr GetTexture(ResourceId id) const;
     void UnloadTexture(const std::string& path);
+    void UnloadTexture(ResourceId id);
+    static ResourceId GetDefaultTextureId(); // Cache key of the checker texture
     void UnloadUnusedTextures(); // Removes textures with only one reference (the cache)
 
+    // Mip streaming and the memory budget; call once per frame on the main thread, after the previous frame's draws
+    void UpdateStreaming();
+    void SetStreamingEnabled(bool enabled) { _streamingEnabled = enabled; } // Applies to textures loaded afterwards
+    bool IsStreamingEnabled() const { return _streamingEnabled; }
+    void SetMemoryBudget(size_t bytes) { _memoryBudget = bytes; }
+    size_t GetMemoryBudget() const { return _memoryBudget; }
+    size_t GetEvictedTextureCount() const;
+    size_t GetStreamedTextureCount() const { return _streamedTextures.size(); }
+
+    // Atlasing: small textures whose meshes keep their UVs inside 0-1 share pages. Only materials
+    // that ask for the atlas view sample the page; anything using repeating UVs keeps loading
+    // the standalone texture. Pages are cooked into the library by TextureImporter::ImportAtlas.
+    void PackIntoAtlas(const std::vector<std::string>& paths); // PrepareAtlas and AddAtlas in one go
+    bool PrepareAtlas(const std::vector<std::string>& paths, PreparedAtlas& atlas) const; // Imports and reads; safe on worker threads
+    void AddAtlas(PreparedAtlas&& atlas); // Uploads the pages, unless every member already has a view
+    TexturePtr GetAtlasTexture(const std::string& path) const; // The texture's view into a page, nullptr if it isn't packed
+    void SetAtlasingEnabled(bool enabled) { _atlasingEnabled = enabled; } // Applies to textures packed afterwards
+    bool IsAtlasingEnabled() const { return _atlasingEnabled; }
+    size_t GetAtlasPageCount() const;
+
     // Default texture access
     TexturePtr GetDefaultTexture() const { return _defaultTexture; }
 
     // Debug/Editor functions
     void OnImGuiRender(); // Display loaded textures in editor
     size_t GetLoadedTextureCount() const { return _textureCache.size(); }
+    size_t GetGPUBytes() const; // Video memory used by every cached texture
 };
 
 #define TEXTURE_MANAGER TextureManager::GetInstance()
\ No newline at end of file
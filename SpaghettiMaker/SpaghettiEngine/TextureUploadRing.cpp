@@ -0,0 +1,175 @@
+#include "TextureUploadRing.h"
+#include "Log.h"
+
+TextureUploadRing* TextureUploadRing::s_instance = nullptr;
+
+namespace {
+    // Offsets handed to GL stay aligned for every pixel and block format
+    const size_t StagingAlignment = 256;
+}
+
+StagingBuffer::~StagingBuffer() {
+    if (_ring) {
+        _ring->Release(_id);
+    }
+}
+
+bool TextureUploadRing::Initialize(size_t capacity) {
+    if (_mapped) return true;
+    if (!GLEW_ARB_buffer_storage) {
+        LOG_INFO(Texture, "Persistent buffer mapping not supported, textures upload from client memory");
+        return false;
+    }
+
+    // Coherent, so worker writes need no explicit flush before the main thread's upload
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenBuffers(1, &_buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _buffer);
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(capacity), nullptr, flags);
+    _mapped = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(capacity), flags));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (!_mapped) {
+        LOG_ERROR(Texture, "Failed to map the texture upload ring");
+        glDeleteBuffers(1, &_buffer);
+        _buffer = 0;
+        return false;
+    }
+
+    _capacity = capacity;
+    _head = 0;
+    LOG_INFO(Texture, "Texture upload ring: {} MB", capacity / (1024 * 1024));
+    return true;
+}
+
+void TextureUploadRing::Cleanup() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (Block& block : _blocks) {
+        if (block.fence) {
+            glClientWaitSync(block.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            glDeleteSync(block.fence);
+        }
+    }
+    _blocks.clear();
+
+    if (_buffer) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _buffer);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glDeleteBuffers(1, &_buffer);
+        _buffer = 0;
+    }
+    _mapped = nullptr;
+    _capacity = 0;
+    _head = 0;
+    _usedBytes = 0;
+}
+
+StagingBufferPtr TextureUploadRing::Allocate(size_t size) {
+    if (!_mapped || size == 0) return nullptr;
+    const size_t alignedSize = (size + StagingAlignment - 1) / StagingAlignment * StagingAlignment;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_blocks.empty()) {
+        _head = 0;
+    }
+
+    // Free space is [head, end) plus [0, tail) once the ring has wrapped, or [head, tail) before.
+    // The head never catches up with the tail, so head == tail always means empty.
+    const size_t tail = _blocks.empty() ? _capacity : _blocks.front().offset;
+    size_t offset = SIZE_MAX;
+    if (_blocks.empty() || _head > tail) {
+        if (_capacity - _head >= alignedSize) {
+            offset = _head;
+        }
+        else if (alignedSize < tail) {
+            offset = 0;
+        }
+    }
+    else if (tail - _head > alignedSize) {
+        offset = _head;
+    }
+
+    if (offset == SIZE_MAX) {
+        ++_failedAllocations;
+        return nullptr;
+    }
+
+    Block block;
+    block.id = _nextId++;
+    block.offset = offset;
+    block.size = alignedSize;
+    _blocks.push_back(block);
+    _head = offset + alignedSize;
+    _usedBytes += alignedSize;
+
+    auto staging = std::make_shared<StagingBuffer>();
+    staging->_ring = this;
+    staging->_id = block.id;
+    staging->_offset = offset;
+    staging->_size = size;
+    staging->_data = _mapped + offset;
+    return staging;
+}
+
+void TextureUploadRing::Release(uint64_t id) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (Block& block : _blocks) {
+        if (block.id == id) {
+            block.released = true;
+            return;
+        }
+    }
+}
+
+void TextureUploadRing::Bind() const {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _buffer);
+}
+
+void TextureUploadRing::Unbind() const {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void TextureUploadRing::Submit(const StagingBuffer& staging) {
+    // One fence covers every GL call issued so far, including the ones reading this range
+    GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (Block& block : _blocks) {
+        if (block.id == staging._id && !block.fence) {
+            block.fence = fence;
+            return;
+        }
+    }
+    glDeleteSync(fence);
+}
+
+void TextureUploadRing::Update() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Ranges retire in order; a range still being written or read holds back the ones after it
+    while (!_blocks.empty()) {
+        Block& block = _blocks.front();
+        if (block.fence) {
+            GLenum status = glClientWaitSync(block.fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+            glDeleteSync(block.fence);
+        }
+        else if (!block.released) {
+            break;
+        }
+
+        _usedBytes -= block.size;
+        _blocks.pop_front();
+    }
+}
+
+size_t TextureUploadRing::GetUsedBytes() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _usedBytes;
+}
+
+size_t TextureUploadRing::GetFailedAllocations() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _failedAllocations;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <GL/glew.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+class TextureUploadRing;
+
+// A range of the upload ring. Filled by one thread, then read by GL calls on the main thread
+// while the ring is bound, followed by Submit(). The range is reused once the GPU is done
+// with it, or as soon as the last reference goes away if it was never submitted.
+class StagingBuffer {
+private:
+    friend class TextureUploadRing;
+    TextureUploadRing* _ring = nullptr;
+    uint64_t _id = 0;
+    size_t _offset = 0;
+    size_t _size = 0;
+    unsigned char* _data = nullptr;
+
+public:
+    StagingBuffer() = default;
+    ~StagingBuffer();
+    StagingBuffer(const StagingBuffer&) = delete;
+    StagingBuffer& operator=(const StagingBuffer&) = delete;
+
+    unsigned char* GetData() const { return _data; } // Writable from any thread until submitted
+    size_t GetSize() const { return _size; }
+
+    // What GL calls take as their pixel pointer while the ring is bound
+    const unsigned char* GetGLPointer(size_t offset = 0) const { return reinterpret_cast<const unsigned char*>(_offset + offset); }
+};
+
+using StagingBufferPtr = std::shared_ptr<StagingBuffer>;
+
+// Persistently mapped GL_PIXEL_UNPACK_BUFFER that worker threads copy texels into, so the main
+// thread's texture uploads read from GPU-visible memory instead of making the driver copy
+// client memory. Ranges are handed out in ring order and fenced when GL starts reading them.
+// Needs ARB_buffer_storage; without it IsAvailable() is false and uploads use client memory.
+class TextureUploadRing {
+private:
+    struct Block {
+        uint64_t id = 0;
+        size_t offset = 0;
+        size_t size = 0;
+        GLsync fence = nullptr; // Set by Submit()
+        bool released = false;  // Dropped without being submitted
+    };
+
+    static TextureUploadRing* s_instance;
+    GLuint _buffer = 0;
+    unsigned char* _mapped = nullptr;
+    size_t _capacity = 0;
+
+    std::mutex _mutex; // Guards everything below; Allocate and Release come from any thread
+    std::deque<Block> _blocks; // Allocation order, oldest first
+    size_t _head = 0;          // Next free byte
+    uint64_t _nextId = 1;
+    size_t _usedBytes = 0;
+    size_t _failedAllocations = 0;
+
+    // Private constructor for singleton
+    TextureUploadRing() = default;
+
+    void Release(uint64_t id);
+    friend class StagingBuffer;
+
+public:
+    static TextureUploadRing* GetInstance() {
+        if (!s_instance) {
+            s_instance = new TextureUploadRing();
+        }
+        return s_instance;
+    }
+
+    static void Destroy() {
+        delete s_instance;
+        s_instance = nullptr;
+    }
+
+    // Main thread, with the GL context current
+    bool Initialize(size_t capacity = 64ull * 1024 * 1024);
+    void Cleanup(); // Waits for the GPU to finish reading, then unmaps
+    bool IsAvailable() const { return _mapped != nullptr; }
+
+    // Any thread. nullptr when the ring is unavailable or too full right now
+    StagingBufferPtr Allocate(size_t size);
+
+    // Main thread. Bind around the GL calls that read staged data, then Submit each buffer they read.
+    void Bind() const;
+    void Unbind() const;
+    void Submit(const StagingBuffer& staging);
+
+    // Main thread, once per frame: reclaims ranges the GPU has finished reading
+    void Update();
+
+    size_t GetCapacity() const { return _capacity; }
+    size_t GetUsedBytes();
+    size_t GetFailedAllocations();
+};
+
+#define TEXTURE_UPLOAD_RING TextureUploadRing::GetInstance()
@@ -36,6 +36,13 @@ void TransformComponent::SetLocalEulerAngles(const vec3& eulerAngles) {
     MarkDirty();
 }
 
+void TransformComponent::SetLocalTransform(const vec3& position, const glm::dquat& rotation, const vec3& scale) {
+    _localPosition = position;
+    _localRotation = rotation;
+    _localScale = scale;
+    MarkDirty();
+}
+
 vec3 TransformComponent::GetWorldPosition() const {
     return vec3(_worldMatrix[3]);
 }
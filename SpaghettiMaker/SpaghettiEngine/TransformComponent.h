@@ -30,6 +30,7 @@ public:
     void SetLocalRotation(const glm::dquat& rotation);
     void SetLocalScale(const vec3& scale);
     void SetLocalEulerAngles(const vec3& eulerAngles);
+    void SetLocalTransform(const vec3& position, const glm::dquat& rotation, const vec3& scale);
 
     // World space transformations
     vec3 GetWorldPosition() const;
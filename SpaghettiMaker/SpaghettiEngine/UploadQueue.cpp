@@ -0,0 +1,60 @@
+#include "UploadQueue.h"
+#include "Profiler.h"
+#include <chrono>
+
+UploadQueue* UploadQueue::s_instance = nullptr;
+
+bool UploadQueue::Enqueue(std::function<void()> upload, const std::atomic<bool>* cancel) {
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    // Wake up periodically so a cancelled load doesn't wait for the queue to drain
+    while (_uploads.size() >= _capacity && !_shutdown) {
+        if (cancel && cancel->load()) return false;
+        _notFull.wait_for(lock, std::chrono::milliseconds(10));
+    }
+
+    if (_shutdown || (cancel && cancel->load())) return false;
+
+    _uploads.push_back(std::move(upload));
+    return true;
+}
+
+size_t UploadQueue::Drain(double budgetMs, size_t maxUploads) {
+    PROFILE_SCOPE("UploadQueue::Drain");
+    using clock = std::chrono::high_resolution_clock;
+    const auto start = clock::now();
+
+    size_t executed = 0;
+    while (executed < maxUploads) {
+        std::function<void()> upload;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_uploads.empty()) break;
+            upload = std::move(_uploads.front());
+            _uploads.pop_front();
+        }
+        _notFull.notify_one();
+
+        upload();
+        ++executed;
+
+        std::chrono::duration<double, std::milli> elapsed = clock::now() - start;
+        if (elapsed.count() >= budgetMs) break;
+    }
+
+    return executed;
+}
+
+void UploadQueue::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _shutdown = true;
+        _uploads.clear();
+    }
+    _notFull.notify_all();
+}
+
+size_t UploadQueue::GetPendingCount() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _uploads.size();
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+
+// Bounded queue of GPU work produced by worker threads and executed on the main
+// thread, where the GL context lives. Producers block while the queue is full, so
+// a large import can never run far ahead of what the main thread uploads.
+class UploadQueue {
+private:
+    static UploadQueue* s_instance;
+    std::deque<std::function<void()>> _uploads;
+    std::mutex _mutex;
+    std::condition_variable _notFull;
+    size_t _capacity = 64;
+    bool _shutdown = false;
+
+    // Private constructor for singleton
+    UploadQueue() = default;
+
+public:
+    static UploadQueue* GetInstance() {
+        if (!s_instance) {
+            s_instance = new UploadQueue();
+        }
+        return s_instance;
+    }
+
+    static void Destroy() {
+        delete s_instance;
+        s_instance = nullptr;
+    }
+
+    // Called from worker threads. Waits for space; returns false if the queue shut
+    // down or the optional cancel flag was raised while waiting.
+    bool Enqueue(std::function<void()> upload, const std::atomic<bool>* cancel = nullptr);
+
+    // Called once per frame on the main thread. Runs uploads until the time budget
+    // or the count limit is reached, whichever comes first. Returns how many ran.
+    size_t Drain(double budgetMs = 4.0, size_t maxUploads = 32);
+
+    // Wakes blocked producers and drops pending uploads
+    void Shutdown();
+
+    void SetCapacity(size_t capacity) { _capacity = capacity; }
+    size_t GetPendingCount();
+};
+
+#define UPLOAD_QUEUE UploadQueue::GetInstance()
@@ -0,0 +1,83 @@
+#include "VertexFormat.h"
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const float QuantizationRange = 32767.0f;
+}
+
+VertexLayout VertexLayout::Get(VertexFormat format) {
+    VertexLayout layout;
+    if (format == VertexFormat::Compact) {
+        layout.stride = sizeof(CompactVertex);
+        // Positions stay unnormalized integers; the draw call applies the dequantization transform
+        layout.position = { 3, GL_SHORT, GL_FALSE, offsetof(CompactVertex, position) };
+        layout.normal = { 3, GL_BYTE, GL_TRUE, offsetof(CompactVertex, normal) };
+        layout.texCoords = { 2, GL_HALF_FLOAT, GL_FALSE, offsetof(CompactVertex, texCoords) };
+    }
+    else {
+        layout.stride = sizeof(StandardVertex);
+        layout.position = { 3, GL_FLOAT, GL_FALSE, offsetof(StandardVertex, position) };
+        layout.normal = { 3, GL_FLOAT, GL_FALSE, offsetof(StandardVertex, normal) };
+        layout.texCoords = { 2, GL_FLOAT, GL_FALSE, offsetof(StandardVertex, texCoords) };
+    }
+    return layout;
+}
+
+QuantizationInfo VertexPacking::ComputeQuantization(const fvec3& boundsMin, const fvec3& boundsMax) {
+    QuantizationInfo info;
+    info.offset = (boundsMin + boundsMax) * 0.5f;
+
+    fvec3 extent = (boundsMax - boundsMin) * 0.5f;
+    float maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+    info.scale = (maxExtent > 0.0f) ? maxExtent / QuantizationRange : 1.0f;
+    return info;
+}
+
+void VertexPacking::QuantizePosition(const fvec3& position, const QuantizationInfo& quantization, int16_t out[4]) {
+    fvec3 local = (position - quantization.offset) / quantization.scale;
+    for (int i = 0; i < 3; ++i) {
+        float value = std::round(std::clamp(local[i], -QuantizationRange, QuantizationRange));
+        out[i] = static_cast<int16_t>(value);
+    }
+    out[3] = 0;
+}
+
+void VertexPacking::PackNormal(const fvec3& normal, int8_t out[4]) {
+    for (int i = 0; i < 3; ++i) {
+        float value = std::round(std::clamp(normal[i], -1.0f, 1.0f) * 127.0f);
+        out[i] = static_cast<int8_t>(value);
+    }
+    out[3] = 0;
+}
+
+uint16_t VertexPacking::PackHalf(float value) {
+    return glm::packHalf1x16(value);
+}
+
+void VertexPacking::PackStandard(const fvec3& position, const fvec3& normal, const fvec2& texCoords, StandardVertex& out) {
+    out.position[0] = position.x;
+    out.position[1] = position.y;
+    out.position[2] = position.z;
+    out.normal[0] = normal.x;
+    out.normal[1] = normal.y;
+    out.normal[2] = normal.z;
+    out.texCoords[0] = texCoords.x;
+    out.texCoords[1] = texCoords.y;
+}
+
+void VertexPacking::PackCompact(const fvec3& position, const fvec3& normal, const fvec2& texCoords, const QuantizationInfo& quantization, CompactVertex& out) {
+    QuantizePosition(position, quantization, out.position);
+    PackNormal(normal, out.normal);
+    out.texCoords[0] = PackHalf(texCoords.x);
+    out.texCoords[1] = PackHalf(texCoords.y);
+}
+
+size_t VertexPacking::GetVertexSize(VertexFormat format) {
+    return (format == VertexFormat::Compact) ? sizeof(CompactVertex) : sizeof(StandardVertex);
+}
+
+const char* VertexPacking::GetFormatName(VertexFormat format) {
+    return (format == VertexFormat::Compact) ? "Compact (16 B)" : "Standard (32 B)";
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "types.h"
+#include <GL/glew.h>
+#include <cstdint>
+#include <cstddef>
+
+// GPU-side vertex layouts a mesh can be uploaded with
+enum class VertexFormat {
+    Standard, // 32 bytes: float position, normal and UV
+    Compact   // 16 bytes: quantized position, 8-bit normal, half-float UV
+};
+
+struct StandardVertex {
+    float position[3];
+    float normal[3];
+    float texCoords[2];
+};
+
+struct CompactVertex {
+    int16_t position[4];   // Quantized to the mesh bounds (w is padding)
+    int8_t normal[4];      // Signed normalized (w is padding)
+    uint16_t texCoords[2]; // Half floats
+};
+
+inline fvec3 GetVertexPosition(const StandardVertex& vertex) {
+    return fvec3(vertex.position[0], vertex.position[1], vertex.position[2]);
+}
+
+static_assert(sizeof(StandardVertex) == 32, "StandardVertex must match the 8-float GL layout");
+static_assert(sizeof(CompactVertex) == 16, "CompactVertex must stay 16 bytes");
+
+// One attribute of an interleaved vertex buffer
+struct VertexAttribute {
+    GLint size;
+    GLenum type;
+    GLboolean normalized;
+    size_t offset;
+};
+
+struct VertexLayout {
+    GLsizei stride;
+    VertexAttribute position;
+    VertexAttribute normal;
+    VertexAttribute texCoords;
+
+    static VertexLayout Get(VertexFormat format);
+};
+
+// Dequantization transform for compact positions: position = offset + quantized * scale.
+// The scale is uniform so that fixed-function normal transformation stays correct.
+struct QuantizationInfo {
+    fvec3 offset = fvec3(0.0f);
+    float scale = 1.0f;
+};
+
+class VertexPacking {
+public:
+    static QuantizationInfo ComputeQuantization(const fvec3& boundsMin, const fvec3& boundsMax);
+    static void QuantizePosition(const fvec3& position, const QuantizationInfo& quantization, int16_t out[4]);
+    static void PackNormal(const fvec3& normal, int8_t out[4]);
+    static uint16_t PackHalf(float value);
+
+    static void PackStandard(const fvec3& position, const fvec3& normal, const fvec2& texCoords, StandardVertex& out);
+    static void PackCompact(const fvec3& position, const fvec3& normal, const fvec2& texCoords, const QuantizationInfo& quantization, CompactVertex& out);
+
+    static size_t GetVertexSize(VertexFormat format);
+    static const char* GetFormatName(VertexFormat format);
+};
@@ -0,0 +1,294 @@
+#include "WorldStreamer.h"
+#include "Log.h"
+#include "Scene.h"
+#include "GameObject.h"
+#include "TransformComponent.h"
+#include "JobSystem.h"
+#include "UploadQueue.h"
+#include "MeshManager.h"
+#include "MaterialManager.h"
+#include "TextureManager.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <vector>
+
+WorldStreamer* WorldStreamer::s_instance = nullptr;
+
+namespace {
+    using Clock = std::chrono::high_resolution_clock;
+
+    double ElapsedMs(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::string GetCellFileName(int x, int z) {
+        return "cell_" + std::to_string(x) + "_" + std::to_string(z) + SceneSerializer::GetExtension();
+    }
+}
+
+uint64_t WorldStreamer::MakeCellKey(int x, int z) {
+    return (uint64_t(uint32_t(x)) << 32) | uint32_t(z);
+}
+
+double WorldStreamer::GetDistance(const Cell& cell, const vec3& position) const {
+    // To the nearest point of the cell's square, so a viewer inside it is at distance 0
+    const double minX = cell.x * _cellSize;
+    const double minZ = cell.z * _cellSize;
+    const double dx = std::max({ minX - position.x, 0.0, position.x - (minX + _cellSize) });
+    const double dz = std::max({ minZ - position.z, 0.0, position.z - (minZ + _cellSize) });
+    return std::sqrt(dx * dx + dz * dz);
+}
+
+bool WorldStreamer::Open(Scene* scene, const std::string& directory, double cellSize) {
+    Close();
+
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error)) {
+        LOG_ERROR(Scene, "World directory not found: {}", directory);
+        return false;
+    }
+
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (!entry.is_regular_file() || entry.path().extension() != SceneSerializer::GetExtension()) continue;
+
+        int x = 0;
+        int z = 0;
+        char extra = 0;
+        if (std::sscanf(entry.path().stem().string().c_str(), "cell_%d_%d%c", &x, &z, &extra) != 2) continue;
+
+        Cell& cell = _cells[MakeCellKey(x, z)];
+        cell.x = x;
+        cell.z = z;
+        cell.path = entry.path().string();
+    }
+
+    _scene = scene;
+    _directory = directory;
+    _cellSize = cellSize;
+    LOG_INFO(Scene, "Streaming world {}: {} cells of {} units", directory, _cells.size(), cellSize);
+    return true;
+}
+
+void WorldStreamer::Close() {
+    // Reads still in flight find their cell gone and drop the result
+    if (_scene) {
+        for (auto& [key, cell] : _cells) {
+            if (cell.root) {
+                _scene->DestroyGameObject(cell.root);
+            }
+        }
+    }
+    _cells.clear();
+    _scene = nullptr;
+    _directory.clear();
+}
+
+void WorldStreamer::SetRadii(double loadRadius, double unloadRadius) {
+    _loadRadius = loadRadius;
+    _unloadRadius = std::max(unloadRadius, loadRadius); // Never unload what would load again right away
+}
+
+void WorldStreamer::Update(const vec3& viewerPosition) {
+    if (!_scene) return;
+    PROFILE_SCOPE("WorldStreamer::Update");
+
+    std::vector<std::pair<uint64_t, Cell*>> toRead;
+    std::vector<Cell*> busy;
+    for (auto& [key, cell] : _cells) {
+        cell.distance = GetDistance(cell, viewerPosition);
+        const bool wanted = cell.distance <= _loadRadius;
+        const bool unwanted = cell.distance > _unloadRadius;
+
+        switch (cell.state) {
+        case CellState::Unloaded:
+            if (wanted) toRead.emplace_back(key, &cell);
+            break;
+        case CellState::Reading:
+            if (unwanted) {
+                cell.state = CellState::Unloaded; // The read finishes on its own and is dropped
+            }
+            break;
+        case CellState::Instantiating:
+        case CellState::Loaded:
+            if (unwanted) {
+                cell.prepared.reset();
+                cell.state = CellState::Unloading;
+            }
+            break;
+        default:
+            break;
+        }
+
+        if (cell.state == CellState::Instantiating || cell.state == CellState::Unloading) {
+            busy.push_back(&cell);
+        }
+    }
+
+    // Nearest first: those are the cells the viewer reaches soonest
+    std::sort(toRead.begin(), toRead.end(), [](const auto& a, const auto& b) { return a.second->distance < b.second->distance; });
+    // Dropped reads still hold a slot until they finish, so a viewer moving back and forth
+    // cannot pile up reads of the same cells
+    for (size_t i = 0; i < toRead.size() && _readsInFlight < _maxReads; ++i) {
+        StartRead(toRead[i].first, *toRead[i].second);
+    }
+
+    // One time slice for all cells, instantiating before unloading
+    std::sort(busy.begin(), busy.end(), [](const Cell* a, const Cell* b) {
+        const bool aLoading = a->state == CellState::Instantiating;
+        const bool bLoading = b->state == CellState::Instantiating;
+        return aLoading != bLoading ? aLoading : a->distance < b->distance;
+    });
+    const auto start = Clock::now();
+    for (Cell* cell : busy) {
+        const double remaining = _frameBudgetMs - ElapsedMs(start);
+        if (remaining <= 0.0) break;
+
+        if (cell->state == CellState::Instantiating) {
+            StepInstantiate(*cell, remaining);
+        }
+        else {
+            StepUnload(*cell, remaining);
+        }
+    }
+
+    // Let go of whatever no remaining cell or object uses; materials first, they hold the textures
+    if (_unloadedCells) {
+        _unloadedCells = false;
+        MATERIAL_MANAGER->UnloadUnusedMaterials();
+        MESH_MANAGER->UnloadUnusedMeshes();
+        TEXTURE_MANAGER->UnloadUnusedTextures();
+    }
+}
+
+void WorldStreamer::StartRead(uint64_t key, Cell& cell) {
+    cell.state = CellState::Reading;
+    cell.generation = _nextGeneration++;
+    ++_readsInFlight;
+
+    const uint64_t generation = cell.generation;
+    const std::string path = cell.path;
+    JOB_SYSTEM->Schedule([this, key, generation, path]() {
+        std::shared_ptr<PreparedScene> prepared = SceneSerializer::Prepare(path);
+        UPLOAD_QUEUE->Enqueue([this, key, generation, prepared]() {
+            FinishRead(key, generation, prepared);
+        });
+    });
+}
+
+void WorldStreamer::FinishRead(uint64_t key, uint64_t generation, const std::shared_ptr<PreparedScene>& prepared) {
+    --_readsInFlight;
+
+    // The viewer left before the read finished, or the world was closed
+    auto it = _cells.find(key);
+    if (it == _cells.end() || it->second.state != CellState::Reading || it->second.generation != generation) return;
+
+    Cell& cell = it->second;
+    if (!prepared) {
+        LOG_ERROR(Scene, "Failed to read world cell: {}", cell.path);
+        cell.state = CellState::Failed;
+        return;
+    }
+
+    const std::string name = "Cell " + std::to_string(cell.x) + ", " + std::to_string(cell.z);
+    cell.root = _scene->CreateGameObject(name.c_str());
+    cell.prepared = prepared;
+    cell.state = CellState::Instantiating;
+    _scene->ReserveGameObjects(prepared->GetObjectCount());
+}
+
+void WorldStreamer::StepInstantiate(Cell& cell, double budgetMs) {
+    const auto start = Clock::now();
+    if (!SceneSerializer::ResolveResources(*cell.prepared, budgetMs)) return;
+
+    while (!cell.prepared->IsInstantiated()) {
+        if (ElapsedMs(start) >= budgetMs) return;
+        SceneSerializer::InstantiateNext(_scene, *cell.prepared, cell.root);
+    }
+
+    cell.prepared.reset();
+    cell.state = CellState::Loaded;
+}
+
+void WorldStreamer::StepUnload(Cell& cell, double budgetMs) {
+    const auto start = Clock::now();
+    if (cell.root) {
+        // A batch of top-level objects at a time, each batch with its children in one pass over the scene
+        std::vector<GameObject*> batch;
+        while (!cell.root->GetChildren().empty()) {
+            if (ElapsedMs(start) >= budgetMs) return;
+
+            const auto& children = cell.root->GetChildren();
+            const size_t count = std::min(children.size(), _destroyBatchSize);
+            batch.clear();
+            for (size_t i = children.size() - count; i < children.size(); ++i) {
+                batch.push_back(children[i].get());
+            }
+            _scene->DestroyGameObjects(batch);
+        }
+
+        _scene->DestroyGameObject(cell.root);
+        cell.root = nullptr;
+    }
+    cell.state = CellState::Unloaded;
+    _unloadedCells = true;
+}
+
+size_t WorldStreamer::GetLoadedCellCount() const {
+    return std::count_if(_cells.begin(), _cells.end(), [](const auto& entry) { return entry.second.state == CellState::Loaded; });
+}
+
+size_t WorldStreamer::GetBusyCellCount() const {
+    return std::count_if(_cells.begin(), _cells.end(), [](const auto& entry) {
+        const CellState state = entry.second.state;
+        return state == CellState::Reading || state == CellState::Instantiating || state == CellState::Unloading;
+    });
+}
+
+bool WorldStreamer::BuildCells(const Scene* scene, const std::string& directory, double cellSize) {
+    // Assign objects to cells; std::map keeps the output order stable
+    std::map<std::pair<int, int>, std::vector<GameObject*>> cells;
+    std::vector<GameObject*> pending;
+    for (const auto& child : scene->GetRoot()->GetChildren()) {
+        pending.push_back(child.get());
+    }
+    for (size_t i = 0; i < pending.size(); ++i) {
+        GameObject* gameObject = pending[i];
+
+        auto transform = gameObject->GetComponent<TransformComponent>();
+        if (!transform) {
+            for (const auto& child : gameObject->GetChildren()) {
+                pending.push_back(child.get());
+            }
+            continue;
+        }
+
+        const vec3 position = vec3(transform->GetWorldMatrix()[3]);
+        const int x = static_cast<int>(std::floor(position.x / cellSize));
+        const int z = static_cast<int>(std::floor(position.z / cellSize));
+        cells[{ x, z }].push_back(gameObject);
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    // Old cells would otherwise stream in next to the new ones
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (entry.path().extension() == SceneSerializer::GetExtension() && entry.path().stem().string().rfind("cell_", 0) == 0) {
+            std::filesystem::remove(entry.path(), error);
+        }
+    }
+
+    bool success = true;
+    for (const auto& [coordinates, roots] : cells) {
+        const std::string path = (std::filesystem::path(directory) / GetCellFileName(coordinates.first, coordinates.second)).string();
+        success = SceneSerializer::Save(roots, path) && success;
+    }
+
+    LOG_INFO(Scene, "Built {} world cells of {} units in {}", cells.size(), cellSize, directory);
+    return success;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "SceneSerializer.h"
+#include "types.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+class Scene;
+class GameObject;
+
+// Streams a world split into square cells on the XZ plane, one scene file per cell
+// (cell_<x>_<z>.sscene). Cells that come within the load radius of the viewer are read on the
+// job system, then resolved and instantiated a time slice per frame under a root object of
+// their own; cells past the unload radius are destroyed the same way. The gap between the
+// two radii keeps a viewer moving along a border from loading the same cells over and over.
+// Main thread only. Close the world before clearing the scene it streams into.
+class WorldStreamer {
+private:
+    enum class CellState {
+        Unloaded,
+        Reading,       // Prepare() running on a worker
+        Instantiating, // Uploading and creating objects, a slice per frame
+        Loaded,
+        Unloading,     // Destroying objects, a slice per frame
+        Failed         // Unreadable; not retried until the world is opened again
+    };
+
+    struct Cell {
+        int x = 0;
+        int z = 0;
+        std::string path;
+        CellState state = CellState::Unloaded;
+        uint64_t generation = 0; // Identifies the read in flight; results of older reads are dropped
+        std::shared_ptr<PreparedScene> prepared;
+        GameObject* root = nullptr; // Parent of everything in the cell
+        double distance = 0.0;      // From the viewer, as of the last Update()
+    };
+
+    static WorldStreamer* s_instance;
+    Scene* _scene = nullptr;
+    std::string _directory;
+    std::unordered_map<uint64_t, Cell> _cells; // Every cell file of the world, by MakeCellKey
+    uint64_t _nextGeneration = 1;
+    size_t _readsInFlight = 0;   // Including reads whose cell is no longer wanted; FinishRead() counts them down
+    bool _unloadedCells = false; // Some cell unloaded this Update(); unused resources are released once at its end
+
+    // Settings
+    double _cellSize = DefaultCellSize;
+    double _loadRadius = 96.0;
+    double _unloadRadius = 160.0;
+    double _frameBudgetMs = 2.0;  // Main thread time spent instantiating and destroying per frame
+    size_t _maxReads = 4;         // Cells read at the same time
+    size_t _destroyBatchSize = 64; // Top-level objects destroyed per scene pass
+
+    // Private constructor for singleton
+    WorldStreamer() = default;
+
+    static uint64_t MakeCellKey(int x, int z);
+    double GetDistance(const Cell& cell, const vec3& position) const;
+    void StartRead(uint64_t key, Cell& cell);
+    void FinishRead(uint64_t key, uint64_t generation, const std::shared_ptr<PreparedScene>& prepared);
+    void StepInstantiate(Cell& cell, double budgetMs);
+    void StepUnload(Cell& cell, double budgetMs);
+
+public:
+    static constexpr double DefaultCellSize = 64.0;
+
+    static WorldStreamer* GetInstance() {
+        if (!s_instance) {
+            s_instance = new WorldStreamer();
+        }
+        return s_instance;
+    }
+
+    static void Destroy() {
+        delete s_instance;
+        s_instance = nullptr;
+    }
+
+    // Finds the cell files in directory; nothing loads until Update()
+    bool Open(Scene* scene, const std::string& directory, double cellSize = DefaultCellSize);
+    void Close(); // Destroys every streamed object at once
+    bool IsOpen() const { return _scene != nullptr; }
+
+    // Once per frame
+    void Update(const vec3& viewerPosition);
+
+    // Splits the scene's top-level objects into cells by world position and writes one file per
+    // cell, replacing the cells already in directory. Objects without a transform only group
+    // others, so their children are placed one by one.
+    static bool BuildCells(const Scene* scene, const std::string& directory, double cellSize = DefaultCellSize);
+
+    void SetRadii(double loadRadius, double unloadRadius);
+    void SetFrameBudget(double budgetMs) { _frameBudgetMs = budgetMs; }
+    double GetLoadRadius() const { return _loadRadius; }
+    double GetUnloadRadius() const { return _unloadRadius; }
+
+    size_t GetCellCount() const { return _cells.size(); }
+    size_t GetLoadedCellCount() const;
+    size_t GetBusyCellCount() const; // Reading, instantiating or unloading
+};
+
+#define WORLD_STREAMER WorldStreamer::GetInstance()